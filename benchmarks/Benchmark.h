@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace ember::bench {
+
+using Clock = std::chrono::steady_clock;
+
+// runs the function once, returning how long it took
+Clock::duration measure(auto&& func) {
+	const auto start = Clock::now();
+	func();
+	return Clock::now() - start;
+}
+
+// converts to the given unit (milliseconds by default), averaged over a number of operations
+template<typename Period = std::milli>
+double per_op(const Clock::duration elapsed, const std::size_t operations = 1) {
+	return std::chrono::duration<double, Period>(elapsed).count() / operations;
+}
+
+} // bench, ember
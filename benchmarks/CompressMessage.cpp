@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <gateway/CompressMessage.h>
+#include <spark/buffers/pmr/BufferAdaptor.h>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+
+namespace {
+
+// loosely resembles update object blocks - repetitive with some noise
+std::vector<std::uint8_t> generate_payload(const std::size_t size, const unsigned int seed) {
+	std::vector<std::uint8_t> payload(size);
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<unsigned int> dist(0, 255);
+
+	for(std::size_t i = 0; i < size; ++i) {
+		payload[i] = (i % 16 < 12)? static_cast<std::uint8_t>(i % 7) : static_cast<std::uint8_t>(dist(rng));
+	}
+
+	return payload;
+}
+
+} // unnamed
+
+TEST(CompressMessage, Levels) {
+	constexpr std::size_t ITERATIONS = 2000;
+
+	for(const std::size_t size : { 256u, 1024u, 8192u }) {
+		const auto payload = generate_payload(size, 0);
+
+		for(int level = 1; level <= MAX_COMPRESSION_LEVEL; ++level) {
+			std::vector<std::uint8_t> out;
+			std::size_t compressed = 0;
+
+			const auto elapsed = bench::measure([&] {
+				for(std::size_t i = 0; i < ITERATIONS; ++i) {
+					out.clear();
+					spark::io::pmr::BufferAdaptor adaptor(out);
+					compress_message(payload, adaptor, level);
+					compressed = out.size();
+				}
+			});
+
+			std::cout << "Size " << size << ", level " << level
+			          << ": " << compressed << " bytes ("
+			          << (100.0 - (compressed * 100.0 / size)) << "% saved), "
+			          << bench::per_op<std::micro>(elapsed, ITERATIONS) << "us/packet\n";
+		}
+	}
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/IPBanCache.h>
+#include <shared/threading/ServicePool.h>
+#include <shared/util/ReusePort.h>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace ember;
+namespace bai = boost::asio::ip;
+
+namespace {
+
+/*
+ * Mirrors the listeners' accept loops - every accepted connection is
+ * checked against the ban list and goes through some setup work before
+ * the next is accepted, then gets a single byte so the client knows it
+ * made it through.
+ */
+class StormListener final {
+	struct Acceptor {
+		bai::tcp::acceptor acceptor;
+		bai::tcp::socket socket;
+	};
+
+	std::vector<std::unique_ptr<Acceptor>> acceptors_;
+	const IPBanCache& bans_;
+	const std::chrono::microseconds setup_cost_;
+
+	void accept(Acceptor& acceptor) {
+		acceptor.acceptor.async_accept(acceptor.socket, [&](boost::system::error_code ec) {
+			if(ec == boost::asio::error::operation_aborted) {
+				return;
+			}
+
+			if(!ec) {
+				const auto ep = acceptor.socket.remote_endpoint(ec);
+
+				if(!ec && !bans_.is_banned(ep.address())) {
+					// stands in for building the session and its handlers
+					const auto until = std::chrono::steady_clock::now() + setup_cost_;
+					while(std::chrono::steady_clock::now() < until);
+
+					const std::uint8_t byte = 0;
+					boost::asio::write(acceptor.socket, boost::asio::buffer(&byte, 1), ec);
+					++accepted;
+				}
+			}
+
+			acceptor.socket = bai::tcp::socket(acceptor.acceptor.get_executor());
+			accept(acceptor);
+		});
+	}
+
+public:
+	std::atomic_size_t accepted = 0;
+
+	StormListener(ServicePool& pool, const bool reuse_port, const IPBanCache& bans,
+	              const std::chrono::microseconds setup_cost)
+	              : bans_(bans), setup_cost_(setup_cost) {
+		bai::tcp::endpoint endpoint(bai::address_v4::loopback(), 0);
+		const auto count = reuse_port? pool.size() : 1;
+
+		for(std::size_t i = 0; i < count; ++i) {
+			auto& service = pool.get(i);
+			auto& acceptor = acceptors_.emplace_back(std::make_unique<Acceptor>(
+				bai::tcp::acceptor(service), bai::tcp::socket(service)
+			));
+
+			util::listen(acceptor->acceptor, endpoint, reuse_port);
+			endpoint = acceptor->acceptor.local_endpoint();
+		}
+
+		for(auto& acceptor : acceptors_) {
+			boost::asio::post(acceptor->acceptor.get_executor(), [&, ptr = acceptor.get()] {
+				accept(*ptr);
+			});
+		}
+	}
+
+	std::uint16_t port() const {
+		return acceptors_.front()->acceptor.local_endpoint().port();
+	}
+
+	// blocks until every acceptor has been closed by its own thread
+	void close() {
+		std::latch closed(acceptors_.size());
+
+		for(auto& acceptor : acceptors_) {
+			boost::asio::post(acceptor->acceptor.get_executor(), [&, ptr = acceptor.get()] {
+				ptr->acceptor.close();
+				closed.count_down();
+			});
+		}
+
+		closed.wait();
+	}
+};
+
+struct StormResult {
+	std::chrono::milliseconds elapsed;
+	std::chrono::microseconds p50;
+	std::chrono::microseconds p99;
+	std::chrono::microseconds max;
+	std::size_t failures;
+};
+
+// connects until each client thread has made it through the given number of times
+StormResult flood(const std::uint16_t port, const std::size_t clients, const std::size_t connections) {
+	const bai::tcp::endpoint endpoint(bai::address_v4::loopback(), port);
+	std::vector<std::vector<std::chrono::microseconds>> latencies(clients);
+	std::atomic_size_t failures = 0;
+	std::vector<std::jthread> threads;
+	const auto start = std::chrono::steady_clock::now();
+
+	for(std::size_t i = 0; i < clients; ++i) {
+		threads.emplace_back([&, i] {
+			boost::asio::io_context ctx;
+
+			for(std::size_t j = 0; j < connections; ++j) {
+				const auto begin = std::chrono::steady_clock::now();
+				boost::system::error_code ec;
+				bai::tcp::socket socket(ctx);
+				socket.connect(endpoint, ec);
+
+				std::uint8_t byte;
+
+				if(!ec) {
+					boost::asio::read(socket, boost::asio::buffer(&byte, 1), ec);
+				}
+
+				if(ec) {
+					++failures;
+					continue;
+				}
+
+				latencies[i].emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - begin
+				));
+			}
+		});
+	}
+
+	threads.clear();
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	std::vector<std::chrono::microseconds> all;
+
+	for(const auto& thread : latencies) {
+		all.insert(all.end(), thread.begin(), thread.end());
+	}
+
+	std::ranges::sort(all);
+
+	if(all.empty()) {
+		all.emplace_back(0);
+	}
+
+	return {
+		std::chrono::duration_cast<std::chrono::milliseconds>(elapsed),
+		all[all.size() / 2],
+		all[std::size_t((all.size() - 1) * 0.99)],
+		all.back(),
+		failures
+	};
+}
+
+} // unnamed
+
+/*
+ * Simulates a reconnect storm by having many client threads connect to a
+ * local listener as fast as they can. With a single acceptor, every
+ * connection queues behind the ban check and setup of the ones before it,
+ * whereas SO_REUSEPORT acceptors split the work across the pool.
+ */
+TEST(ConnectionStorm, Acceptors) {
+	if(!util::reuse_port_supported) {
+		GTEST_SKIP();
+	}
+
+	constexpr std::size_t CLIENTS = 64;
+	constexpr std::size_t CONNECTIONS = 200; // per client
+	constexpr std::chrono::microseconds SETUP_COST(50);
+
+	const auto threads = std::max(std::thread::hardware_concurrency(), 2u);
+
+	// a realistic number of banned ranges to check against
+	std::vector<IPEntry> entries;
+
+	for(std::uint32_t i = 0; i < 10'000; ++i) {
+		const auto ip = bai::address_v4(0x0A000000 + (i << 8));
+		entries.emplace_back(ip.to_string(), 24);
+	}
+
+	IPBanCache bans(entries);
+
+	for(const auto reuse_port : { false, true }) {
+		ServicePool pool(threads);
+		pool.run();
+
+		StormListener listener(pool, reuse_port, bans, SETUP_COST);
+		const auto result = flood(listener.port(), CLIENTS, CONNECTIONS);
+		listener.close();
+
+		std::cout << (reuse_port? "SO_REUSEPORT, " : "Single acceptor, ")
+			<< (reuse_port? threads : 1) << " acceptor(s): "
+			<< listener.accepted << " connections in " << result.elapsed.count() << "ms, "
+			<< "p50 " << result.p50.count() << "us, p99 " << result.p99.count()
+			<< "us, max " << result.max.count() << "us, "
+			<< result.failures << " failed\n";
+
+		pool.stop();
+	}
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <dbcreader/Bundle.h>
+#include <dbcreader/BundleLoader.h>
+#include <dbcreader/DBCReader.h>
+#include <dbcreader/MappedLoader.h>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdlib>
+
+using namespace ember;
+
+/*
+ * Compares startup from individual DBC files against startup from a bundle
+ * built from the same files with dbc-parser --bundle. Client DBCs aren't
+ * distributed, so the benchmark runs against whichever directory
+ * EMBER_DBC_PATH points to and the bundle at EMBER_DBC_BUNDLE.
+ */
+TEST(DBCBundle, Startup) {
+	const char* path = std::getenv("EMBER_DBC_PATH");
+	const char* bundle_path = std::getenv("EMBER_DBC_BUNDLE");
+
+	if(!path || !bundle_path) {
+		GTEST_SKIP() << "EMBER_DBC_PATH or EMBER_DBC_BUNDLE not set";
+	}
+
+	std::vector<std::string> dbcs;
+
+	{
+		const dbc::Bundle bundle(bundle_path);
+
+		for(const auto& entry : bundle.entries()) {
+			dbcs.emplace_back(entry.name);
+		}
+	}
+
+	const std::vector<std::string_view> names(dbcs.begin(), dbcs.end());
+	dbc::Storage storage;
+	dbc::MappedStorage mapped_storage, bundle_storage, unverified_storage;
+
+	const auto disk = bench::measure([&] {
+		dbc::DiskLoader loader(std::string(path) + "/");
+		storage = loader.load(names);
+		dbc::link(storage);
+	});
+
+	const auto mapped = bench::measure([&] {
+		dbc::MappedLoader loader(std::string(path) + "/");
+		mapped_storage = loader.load(names);
+	});
+
+	const auto bundled = bench::measure([&] {
+		dbc::BundleLoader loader(bundle_path);
+		bundle_storage = loader.load();
+	});
+
+	const auto unverified = bench::measure([&] {
+		dbc::BundleLoader loader(bundle_path, [](const std::string&) {}, dbc::Bundle::Checksum::SKIP);
+		unverified_storage = loader.load();
+	});
+
+	ASSERT_EQ(storage.spell.size(), bundle_storage.spell.size());
+	ASSERT_EQ(mapped_storage.spell.size(), bundle_storage.spell.size());
+
+	for(const auto& record : mapped_storage.spell) {
+		ASSERT_NE(bundle_storage.spell[record.id], nullptr);
+	}
+
+	std::cout << names.size() << " DBCs\n"
+	          << "Disk load and link: " << bench::per_op(disk) << "ms\n"
+	          << "Mapped files: " << bench::per_op(mapped) << "ms\n"
+	          << "Bundle: " << bench::per_op(bundled) << "ms\n"
+	          << "Bundle, checksum skipped: " << bench::per_op(unverified) << "ms\n";
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <dbcreader/DBCReader.h>
+#include <shared/threading/ThreadPool.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <cstdlib>
+
+using namespace ember;
+using std::chrono::nanoseconds;
+
+namespace {
+
+struct Timings {
+	nanoseconds serial_load {};
+	nanoseconds parallel_load {};
+	nanoseconds serial_link {};
+	nanoseconds parallel_link {};
+};
+
+} // unnamed
+
+/*
+ * Client DBCs aren't distributed, so the benchmark runs against
+ * whichever directory EMBER_DBC_PATH points to. Every DBC with a
+ * definition must be present.
+ */
+TEST(DBCLoader, SerialParallel) {
+	const char* path = std::getenv("EMBER_DBC_PATH");
+
+	if(!path) {
+		GTEST_SKIP() << "EMBER_DBC_PATH not set";
+	}
+
+	std::map<std::string, Timings, std::less<>> timings;
+
+	auto record = [&](nanoseconds Timings::* field) {
+		return [&timings, field](std::string_view dbc, nanoseconds elapsed) {
+			auto it = timings.try_emplace(std::string(dbc)).first;
+			it->second.*field = elapsed;
+		};
+	};
+
+	const auto noop = [](const std::string&) {};
+	dbc::DiskLoader serial_loader(std::string(path) + "/", noop, record(&Timings::serial_load));
+	dbc::DiskLoader parallel_loader(std::string(path) + "/", noop, record(&Timings::parallel_load));
+	ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+	dbc::Storage serial, parallel;
+
+	const auto serial_load = bench::measure([&] {
+		serial = serial_loader.load();
+	});
+
+	const auto serial_link = bench::measure([&] {
+		dbc::link(serial, record(&Timings::serial_link));
+	});
+
+	const auto parallel_load = bench::measure([&] {
+		parallel = parallel_loader.load(pool);
+	});
+
+	const auto parallel_link = bench::measure([&] {
+		dbc::link(parallel, pool, record(&Timings::parallel_link));
+	});
+
+	ASSERT_EQ(serial.spell.size(), parallel.spell.size());
+	ASSERT_EQ(serial.area_table.size(), parallel.area_table.size());
+
+	std::cout << std::fixed << std::setprecision(3)
+	          << std::left << std::setw(28) << "DBC" << std::right
+	          << std::setw(12) << "load (ms)" << std::setw(12) << "par. load"
+	          << std::setw(12) << "link (ms)" << std::setw(12) << "par. link" << '\n';
+
+	for(const auto& [dbc, timing] : timings) {
+		std::cout << std::left << std::setw(28) << dbc << std::right
+		          << std::setw(12) << bench::per_op(timing.serial_load)
+		          << std::setw(12) << bench::per_op(timing.parallel_load)
+		          << std::setw(12) << bench::per_op(timing.serial_link)
+		          << std::setw(12) << bench::per_op(timing.parallel_link) << '\n';
+	}
+
+	std::cout << "Serial: " << bench::per_op(serial_load) << "ms load, "
+	          << bench::per_op(serial_link) << "ms link\n"
+	          << "Parallel (" << pool.size() + 1 << " threads): " << bench::per_op(parallel_load) << "ms load, "
+	          << bench::per_op(parallel_link) << "ms link\n";
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <dbcreader/DBCMap.h>
+#include <dbcreader/DiskLoader.h>
+#include <boost/container/flat_map.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdlib>
+#include <cstddef>
+
+using namespace ember;
+
+namespace {
+
+template<typename T>
+void compare(std::string_view name, const dbc::DBCMap<T>& dbc) {
+	constexpr std::size_t LOOKUPS = 1'000'000;
+
+	if(!dbc.size()) {
+		return;
+	}
+
+	// the previous layout, for comparison
+	boost::container::flat_map<std::size_t, const T*> sorted;
+	std::size_t max_id = 0;
+
+	for(const auto& [id, record] : dbc) {
+		sorted.emplace(id, &record);
+		max_id = std::max(max_id, id);
+	}
+
+	// mostly hits, with some misses past the end of the range
+	std::mt19937 gen(0);
+	std::uniform_int_distribution<std::size_t> dist(0, max_id + max_id / 4);
+	std::vector<std::size_t> ids(LOOKUPS);
+	std::ranges::generate(ids, [&] { return dist(gen); });
+
+	std::size_t found = 0;
+
+	const auto map_time = bench::measure([&] {
+		for(const auto id : ids) {
+			found += dbc[id] != nullptr;
+		}
+	});
+
+	const auto sorted_time = bench::measure([&] {
+		for(const auto id : ids) {
+			found += sorted.find(id) != sorted.end();
+		}
+	});
+
+	std::cout << name << " (" << dbc.size() << " records, " << (dbc.dense()? "dense" : "sparse")
+	          << "): " << bench::per_op<std::nano>(map_time, LOOKUPS) << "ns/lookup, sorted map: "
+	          << bench::per_op<std::nano>(sorted_time, LOOKUPS) << "ns/lookup (" << found << " found)\n";
+}
+
+} // unnamed
+
+/*
+ * Client DBCs aren't distributed, so the benchmark runs against
+ * whichever directory EMBER_DBC_PATH points to
+ */
+TEST(DBCMap, Lookup) {
+	const char* path = std::getenv("EMBER_DBC_PATH");
+
+	if(!path) {
+		GTEST_SKIP() << "EMBER_DBC_PATH not set";
+	}
+
+	dbc::DiskLoader loader(std::string(path) + "/");
+	const auto storage = loader.load("Spell", "Map", "AreaTable", "Faction",
+	                                 "ItemDisplayInfo", "SoundEntries");
+
+	compare("Spell", storage.spell);
+	compare("Map", storage.map);
+	compare("AreaTable", storage.area_table);
+	compare("Faction", storage.faction);
+	compare("ItemDisplayInfo", storage.item_display_info);
+	compare("SoundEntries", storage.sound_entries);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <shared/IPBanCache.h>
+#include <gtest/gtest.h>
+#include <boost/asio/ip/address.hpp>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+TEST(IPBan, Lookup) {
+	constexpr std::size_t LOOKUPS = 1'000'000;
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<std::uint32_t> addr_dist;
+	std::uniform_int_distribution<std::uint32_t> cidr_dist(16, 32);
+
+	std::vector<boost::asio::ip::address> addresses;
+
+	for(std::size_t i = 0; i < LOOKUPS; ++i) {
+		addresses.emplace_back(boost::asio::ip::address_v4(addr_dist(rng)));
+	}
+
+	for(const std::size_t count : { 100u, 10'000u, 1'000'000u }) {
+		ember::IPBanCache bans;
+
+		const auto load_time = ember::bench::measure([&] {
+			for(std::size_t i = 0; i < count; ++i) {
+				bans.ban(boost::asio::ip::address_v4(addr_dist(rng)).to_string(), cidr_dist(rng));
+			}
+		});
+
+		std::size_t banned = 0;
+
+		const auto lookup_time = ember::bench::measure([&] {
+			for(const auto& address : addresses) {
+				banned += bans.is_banned(address);
+			}
+		});
+
+		std::cout << count << " ranges: loaded in " << ember::bench::per_op(load_time) << "ms, "
+		          << ember::bench::per_op<std::nano>(lookup_time, LOOKUPS) << "ns per lookup ("
+		          << banned << " banned)\n";
+	}
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <mpq/MPQ.h>
+#include <mpq/Crypt.h>
+#include <mpq/SharedDefs.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ember;
+
+// compares lookups against probing the hash table, as file_lookup used to
+TEST(MPQ, Lookup) {
+	constexpr std::size_t ROUNDS = 100;
+	constexpr std::size_t NAMES = 10'000;
+	auto archive = mpq::open_archive("test_data/mpqs/v1_16.mpq", 0);
+	ASSERT_TRUE(archive);
+
+	// mix of present and missing files, as when resolving a large listfile
+	const auto files = archive->files();
+	std::vector<std::string> names;
+
+	for(std::size_t i = 0; i < NAMES; ++i) {
+		if(i % 2) {
+			names.emplace_back(files[i % files.size()]);
+		} else {
+			names.emplace_back("world\\maps\\azeroth\\azeroth_" + std::to_string(i) + ".adt");
+		}
+	}
+
+	const auto table = archive->hash_table();
+
+	auto probe = [&](const std::string& name) {
+		auto index = mpq::hash_string(name, mpq::MPQ_HASH_TABLE_INDEX) % table.size();
+		const auto name_a = mpq::hash_string(name, mpq::MPQ_HASH_NAME_A);
+		const auto name_b = mpq::hash_string(name, mpq::MPQ_HASH_NAME_B);
+
+		for(std::size_t i = 0; i < table.size(); ++i, index = (index + 1) % table.size()) {
+			if(table[index].block_index == mpq::MPQ_HASH_ENTRY_EMPTY) {
+				break;
+			}
+
+			if(table[index].name_1 == name_a && table[index].name_2 == name_b
+			   && table[index].locale == 0) {
+				return index;
+			}
+		}
+
+		return mpq::Archive::npos;
+	};
+
+	std::size_t found = 0;
+
+	const auto probe_time = bench::measure([&] {
+		for(std::size_t i = 0; i < ROUNDS; ++i) {
+			for(const auto& name : names) {
+				found += probe(name) != mpq::Archive::npos;
+			}
+		}
+	});
+
+	const auto lookup_time = bench::measure([&] {
+		for(std::size_t i = 0; i < ROUNDS; ++i) {
+			for(const auto& name : names) {
+				found += archive->file_lookup(name, 0) != mpq::Archive::npos;
+			}
+		}
+	});
+
+	const auto batch_time = bench::measure([&] {
+		for(std::size_t i = 0; i < ROUNDS; ++i) {
+			const auto indices = archive->lookup_many(names);
+			found += std::ranges::count_if(indices, [](auto index) { return index != mpq::Archive::npos; });
+		}
+	});
+
+	const auto lookups = ROUNDS * names.size();
+
+	std::cout << "Probe: " << bench::per_op<std::nano>(probe_time, lookups) << "ns/lookup\n"
+	          << "Index: " << bench::per_op<std::nano>(lookup_time, lookups) << "ns/lookup\n"
+	          << "Batch: " << bench::per_op<std::nano>(batch_time, lookups) << "ns/lookup\n"
+	          << "(" << found << " found)\n";
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <dbcreader/DBCReader.h>
+#include <shared/util/PCREHelper.h>
+#include <shared/util/UTF8.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <iostream>
+#include <locale>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdlib>
+#include <cstddef>
+
+using namespace ember;
+
+namespace {
+
+std::vector<util::pcre::Result> compile_each(const std::vector<std::string>& expressions) {
+	std::vector<util::pcre::Result> patterns;
+
+	for(const auto& expression : expressions) {
+		patterns.emplace_back(util::pcre::utf8_jit_compile(expression));
+	}
+
+	return patterns;
+}
+
+bool match_each(const std::vector<util::pcre::Result>& patterns, const std::string& needle) {
+	for(const auto& pattern : patterns) {
+		if(util::pcre::match(needle, pattern) >= 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// deterministic set of plausible names, most of which won't be filtered
+std::vector<std::string> generate_names(std::size_t count) {
+	const std::string_view syllables[] {
+		"ar", "tha", "vex", "cha", "os", "mor", "gul", "syl", "va", "nas",
+		"dra", "kor", "ith", "el", "rin", "zul", "jin", "fel", "mag", "ka"
+	};
+
+	std::vector<std::string> names;
+	std::size_t seed = 1;
+
+	for(std::size_t i = 0; i < count; ++i) {
+		std::string name;
+		const auto parts = 2 + (seed % 3);
+
+		for(std::size_t j = 0; j < parts; ++j) {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			name += syllables[(seed >> 33) % std::size(syllables)];
+		}
+
+		names.emplace_back(util::utf8::name_format(name, std::locale()));
+	}
+
+	return names;
+}
+
+} // unnamed
+
+/*
+ * Compares filtering names against the client's profanity, reserved name and
+ * spam lists one regex at a time, after separate UTF-8 passes, with the
+ * combined pattern sets and single-pass inspection. Client DBCs aren't
+ * distributed, so the benchmark runs against whichever directory
+ * EMBER_DBC_PATH points to.
+ */
+TEST(NameFilter, IndividualCombined) {
+	const char* path = std::getenv("EMBER_DBC_PATH");
+
+	if(!path) {
+		GTEST_SKIP() << "EMBER_DBC_PATH not set";
+	}
+
+	dbc::DiskLoader loader(std::string(path) + "/");
+	const std::vector<std::string_view> dbcs { "NamesProfanity", "NamesReserved", "SpamMessages" };
+	const auto storage = loader.load(dbcs);
+
+	std::vector<std::string> profanity, reserved, spam;
+
+	for(const auto& [_, record] : storage.names_profanity) {
+		profanity.emplace_back(record.name);
+	}
+
+	for(const auto& [_, record] : storage.names_reserved) {
+		reserved.emplace_back(record.name);
+	}
+
+	for(const auto& [_, record] : storage.spam_messages) {
+		spam.emplace_back(record.text);
+	}
+
+	std::array<std::vector<util::pcre::Result>, 3> individual;
+	std::array<util::pcre::PatternSet, 3> sets;
+
+	const auto individual_compile = bench::measure([&] {
+		individual = { compile_each(reserved), compile_each(profanity), compile_each(spam) };
+	});
+
+	const auto set_compile = bench::measure([&] {
+		sets = {
+			util::pcre::PatternSet(reserved), util::pcre::PatternSet(profanity), util::pcre::PatternSet(spam)
+		};
+	});
+
+	const auto names = generate_names(10'000);
+	const std::locale locale;
+	std::size_t individual_hits = 0, set_hits = 0;
+
+	const auto individual_match = bench::measure([&] {
+		for(const auto& name : names) {
+			if(!util::utf8::is_valid(name) || util::utf8::length(name) > 12
+			   || util::utf8::max_consecutive(name, true) > 2 || !util::utf8::is_alpha(name, locale)) {
+				continue;
+			}
+
+			const auto formatted = util::utf8::name_format(name, locale);
+
+			for(const auto& patterns : individual) {
+				if(match_each(patterns, formatted)) {
+					++individual_hits;
+					break;
+				}
+			}
+		}
+	});
+
+	const auto set_match = bench::measure([&] {
+		for(const auto& name : names) {
+			const auto info = util::utf8::inspect_name(name, locale);
+
+			if(!info.valid || info.length > 12 || info.max_consecutive > 2 || !info.alpha) {
+				continue;
+			}
+
+			for(const auto& set : sets) {
+				if(set.match(info.formatted) >= 0) {
+					++set_hits;
+					break;
+				}
+			}
+		}
+	});
+
+	ASSERT_EQ(individual_hits, set_hits);
+
+	std::size_t compiled = 0;
+
+	for(const auto& set : sets) {
+		compiled += set.compiled_size();
+	}
+
+	std::cout << profanity.size() + reserved.size() + spam.size() << " expressions, "
+	          << compiled << " combined patterns\n"
+	          << "Compile, individual: " << bench::per_op(individual_compile) << "ms\n"
+	          << "Compile, combined: " << bench::per_op(set_compile) << "ms\n"
+	          << names.size() << " names (" << set_hits << " filtered)\n"
+	          << "Filter, individual: " << bench::per_op(individual_match) << "ms\n"
+	          << "Filter, combined: " << bench::per_op(set_match) << "ms\n";
+}
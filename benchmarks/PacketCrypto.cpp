@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <gateway/PacketCrypto.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+
+namespace {
+
+// the original byte-at-a-time implementation, as a baseline
+class ReferenceCrypto {
+	std::vector<std::uint8_t> key_;
+	std::uint8_t send_i_ = 0;
+	std::uint8_t send_j_ = 0;
+
+public:
+	explicit ReferenceCrypto(std::span<const std::uint8_t> key)
+		: key_(key.begin(), key.end()) {}
+
+	void encrypt(std::span<std::uint8_t> data) {
+		const auto key_size = static_cast<std::uint8_t>(key_.size());
+
+		for(auto& byte : data) {
+			send_i_ %= key_size;
+			std::uint8_t x = (byte ^ key_[send_i_]) + send_j_;
+			++send_i_;
+			byte = send_j_ = x;
+		}
+	}
+};
+
+using Header = std::array<std::uint8_t, 4>;
+
+} // unnamed
+
+TEST(PacketCrypto, Encrypt) {
+	constexpr std::size_t PACKETS = 1'000'000;
+	std::vector<std::uint8_t> key(40);
+	std::mt19937 rng(40);
+	std::uniform_int_distribution<unsigned int> dist(0, 255);
+	std::ranges::generate(key, [&] { return static_cast<std::uint8_t>(dist(rng)); });
+	std::vector<Header> headers(PACKETS);
+
+	ReferenceCrypto reference(key);
+	const auto ref_time = bench::measure([&] {
+		for(auto& header : headers) {
+			reference.encrypt(std::span(header).first(2));
+			reference.encrypt(std::span(header).last(2));
+		}
+	});
+
+	PacketCrypto crypto(key);
+	const auto single_time = bench::measure([&] {
+		for(auto& header : headers) {
+			crypto.encrypt(header);
+		}
+	});
+
+	const auto batch_time = bench::measure([&] {
+		crypto.encrypt(std::span(headers));
+	});
+
+	auto rate = [&](const bench::Clock::duration elapsed) {
+		return PACKETS / bench::per_op<std::ratio<1>>(elapsed);
+	};
+
+	std::cout << "Reference: " << rate(ref_time) << " packets/s\n"
+	          << "Per-header: " << rate(single_time) << " packets/s\n"
+	          << "Batched: " << rate(batch_time) << " packets/s\n";
+}
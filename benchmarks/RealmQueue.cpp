@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <gateway/RealmQueue.h>
+#include <shared/util/xoroshiro128plus.h>
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+TEST(RealmQueue, Churn) {
+	constexpr std::size_t CLIENTS = 100'000;
+	boost::asio::io_context service;
+	RealmQueue queue(service, [](RealmQueue::Positions) {}, [](const ClientUUID&) {}, 1ms);
+
+	rng::xorshift::seed[0] = 0x9E3779B97F4A7C15;
+	rng::xorshift::seed[1] = 0xBF58476D1CE4E5B9;
+	std::vector<ClientUUID> clients;
+
+	for(std::size_t i = 0; i < CLIENTS; ++i) {
+		clients.emplace_back(ClientUUID::generate(0));
+	}
+
+	const auto elapsed = bench::measure([&] {
+		for(std::size_t i = 0; i < CLIENTS; ++i) {
+			queue.enqueue(clients[i], static_cast<int>(i % 4));
+		}
+
+		for(std::size_t i = 0; i < CLIENTS; i += 2) {
+			queue.dequeue(clients[i]);
+		}
+
+		while(queue.size()) {
+			queue.free_slot();
+		}
+	});
+
+	std::cout << CLIENTS << " enqueues, " << CLIENTS / 2 << " dequeues, "
+	          << CLIENTS / 2 << " pops: " << bench::per_op(elapsed) << "ms\n";
+}
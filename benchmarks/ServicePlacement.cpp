@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/threading/Placement.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace ember;
+
+namespace {
+
+/*
+ * Simulates a gateway's network threads over a few hours of churn, with
+ * around 5,000 sessions connected at any one time and the pool running at
+ * roughly 80% of capacity. Each session has a message rate drawn from a
+ * skewed distribution (most are idle, a few are raiding or trading in busy
+ * cities) and a lifetime that's either short (character select, quick
+ * logins) or long (play sessions). Each thread is modelled as an M/M/1
+ * queue, so its queue latency grows sharply as it approaches capacity.
+ */
+struct SimResult {
+	double p50;
+	double p99;
+	double p999;
+	double max;
+};
+
+SimResult simulate(PlacementPolicy& policy) {
+	constexpr std::size_t THREADS = 8;
+	constexpr std::size_t TICKS = 20'000;         // one second each
+	constexpr std::size_t ARRIVALS = 4;           // per tick
+	constexpr double CAPACITY = 6'000.0;          // messages per second, per thread
+	constexpr double SERVICE_TIME_US = 1'000'000.0 / CAPACITY;
+
+	struct Session {
+		std::size_t thread;
+		std::size_t expiry;
+		std::size_t rate;
+	};
+
+	std::mt19937 rng(42);
+	std::discrete_distribution<std::size_t> rates({ 60, 25, 10, 5 });
+	constexpr std::size_t RATE_VALUES[] { 1, 5, 20, 80 };
+	std::bernoulli_distribution brief(0.3);
+	std::exponential_distribution<> short_life(1.0 / 60.0);
+	std::exponential_distribution<> long_life(1.0 / 1800.0);
+
+	auto loads = std::make_unique<ServiceLoad[]>(THREADS);
+	std::span<const ServiceLoad> view(loads.get(), THREADS);
+	std::vector<Session> sessions;
+	std::vector<double> samples;
+
+	for(std::size_t tick = 0; tick < TICKS; ++tick) {
+		std::erase_if(sessions, [&](const Session& session) {
+			if(session.expiry > tick) {
+				return false;
+			}
+
+			--loads[session.thread].connections;
+			return true;
+		});
+
+		for(std::size_t i = 0; i < ARRIVALS; ++i) {
+			const auto thread = policy.select(view);
+			const auto life = brief(rng)? short_life(rng) : long_life(rng);
+			sessions.emplace_back(thread, tick + 1 + std::size_t(life), RATE_VALUES[rates(rng)]);
+			++loads[thread].connections;
+		}
+
+		std::size_t messages[THREADS] {};
+
+		for(const auto& session : sessions) {
+			messages[session.thread] += session.rate;
+		}
+
+		double latency[THREADS];
+
+		for(std::size_t i = 0; i < THREADS; ++i) {
+			const auto utilisation = std::min(messages[i] / CAPACITY, 0.999);
+			latency[i] = SERVICE_TIME_US / (1.0 - utilisation);
+
+			// what the pool's sampler would have recorded
+			auto& load = loads[i];
+			load.recent_messages = load.recent_messages / 2 + messages[i];
+			load.queue_latency = (load.queue_latency * 7 + std::uint64_t(latency[i])) / 8;
+		}
+
+		// measure periodically once things have warmed up
+		if(tick < TICKS / 4 || tick % 20) {
+			continue;
+		}
+
+		for(const auto& session : sessions) {
+			samples.emplace_back(latency[session.thread]);
+		}
+	}
+
+	std::ranges::sort(samples);
+
+	const auto percentile = [&](const double p) {
+		return samples[std::size_t(p * (samples.size() - 1))];
+	};
+
+	return { percentile(0.5), percentile(0.99), percentile(0.999), samples.back() };
+}
+
+} // unnamed
+
+TEST(ServicePlacement, Simulated) {
+	const auto report = [](const char* name, const SimResult& result) {
+		std::cout << name << ": p50 " << result.p50 << "us, p99 " << result.p99
+			<< "us, p99.9 " << result.p999 << "us, max " << result.max << "us\n";
+	};
+
+	RoundRobinPlacement round_robin;
+	LeastLoadedPlacement least_loaded;
+	const auto rr = simulate(round_robin);
+	const auto ll = simulate(least_loaded);
+	report("Round-robin", rr);
+	report("Least loaded", ll);
+	EXPECT_LT(ll.p99, rr.p99);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <spark/v2/Tracking.h>
+#include <logger/Logger.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+TEST(SparkTracking, TrackAndComplete) {
+	constexpr std::size_t REQUESTS = 200'000;
+	log::Logger logger;
+	boost::asio::io_context ctx;
+	boost::uuids::random_generator uuid_gen;
+	spark::v2::Tracking tracking(ctx, &logger);
+	std::vector<spark::v2::Token> tokens(REQUESTS);
+
+	for(auto& token : tokens) {
+		token = uuid_gen();
+	}
+
+	const spark::v2::Link link;
+
+	const auto elapsed = bench::measure([&] {
+		for(const auto& token : tokens) {
+			tracking.track(token, [](const spark::v2::Link&, spark::v2::MessageResult) {}, 5s);
+		}
+
+		for(const auto& token : tokens) {
+			tracking.on_message(link, {}, token);
+		}
+	});
+
+	std::cout << "Track & complete: " << bench::per_op<std::nano>(elapsed, REQUESTS) << "ns per request\n";
+}
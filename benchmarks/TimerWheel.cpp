@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include <shared/threading/TimerWheel.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+// idle timeouts are frequently re-armed, so this measures cancel & reschedule
+TEST(TimerWheel, Rearm) {
+	constexpr std::size_t TIMERS = 50'000;
+	constexpr std::size_t ROUNDS = 20;
+
+	boost::asio::io_context ctx;
+	TimerWheel wheel(ctx);
+	std::vector<TimerWheel::TimerID> ids(TIMERS);
+
+	const auto wheel_time = bench::measure([&] {
+		for(std::size_t round = 0; round < ROUNDS; ++round) {
+			for(std::size_t i = 0; i < TIMERS; ++i) {
+				wheel.cancel(ids[i]);
+				ids[i] = wheel.schedule(60s, [] {});
+			}
+		}
+	});
+
+	std::vector<std::unique_ptr<boost::asio::steady_timer>> timers;
+
+	for(std::size_t i = 0; i < TIMERS; ++i) {
+		timers.emplace_back(std::make_unique<boost::asio::steady_timer>(ctx));
+	}
+
+	const auto asio_time = bench::measure([&] {
+		for(std::size_t round = 0; round < ROUNDS; ++round) {
+			for(auto& timer : timers) {
+				timer->expires_after(60s); // implicitly cancels
+				timer->async_wait([](const boost::system::error_code&) {});
+			}
+		}
+	});
+
+	std::cout << "Timer wheel: " << bench::per_op<std::nano>(wheel_time, TIMERS * ROUNDS) << "ns per re-arm\n"
+	          << "steady_timer: " << bench::per_op<std::nano>(asio_time, TIMERS * ROUNDS) << "ns per re-arm\n";
+}
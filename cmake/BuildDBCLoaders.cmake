@@ -17,11 +17,14 @@ function(build_dbc_loaders dbc_hdr dbc_src
         ${output_dir}/DiskDefs.h
         ${output_dir}/MemoryDefs.h
         ${output_dir}/Storage.h
+        ${output_dir}/MappedStorage.h
     )
 
     set(${dbc_src}
         ${output_dir}/DiskLoader.cpp
         ${output_dir}/Linker.cpp
+        ${output_dir}/MappedLoader.cpp
+        ${output_dir}/BundleLoader.cpp
     )
 
     set_source_files_properties(${${dbc_hdr}} ${${dbc_src}} PROPERTIES GENERATED TRUE)
@@ -33,7 +36,7 @@ function(build_dbc_loaders dbc_hdr dbc_src
 
     add_custom_command(
         OUTPUT ${${dbc_hdr}} ${${dbc_src}}
-        COMMAND dbc-parser -d ${definition_dir_str} -t ${template_dir} -o ${output_dir} --fverbosity ${fverbosity} --disk
+        COMMAND dbc-parser -d ${definition_dir_str} -t ${template_dir} -o ${output_dir} --fverbosity ${fverbosity} --disk --mapped
         DEPENDS dbc-parser
         COMMENT "Generating DBC loaders..."
     )
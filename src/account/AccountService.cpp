@@ -7,6 +7,8 @@
  */
 
 #include "AccountService.h"
+#include <algorithm>
+#include <span>
 
 namespace ember {
 
@@ -48,11 +50,12 @@ AccountService::handle_session_fetch(
 		return response;
 	}
 
-	auto key = Botan::BigInt::encode(*session);
+	// sent without leading zeroes, as Botan::BigInt::encode would produce
+	const auto key = std::ranges::find_if(*session, [](const auto byte) { return byte != 0; });
 
 	response.status = Status::OK;
 	response.account_id = msg.account_id();
-	response.key = std::move(key);
+	response.key.assign(key, session->end());
 	return response;
 }
 
@@ -64,8 +67,8 @@ AccountService::handle_register_session(const RegisterSession& msg,	const Link&
 		.status = Status::OK
 	};
 
-	if(msg.key() && msg.account_id()) {
-		Botan::BigInt key(msg.key()->data(), msg.key()->size());
+	if(msg.key() && msg.account_id() && msg.key()->size() <= Sessions::KEY_SIZE) {
+		const std::span key(msg.key()->data(), msg.key()->size());
 
 		if(!sessions_.register_session(msg.account_id(), key)) {
 			response.status = Status::ALREADY_LOGGED_IN;
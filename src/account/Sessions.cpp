@@ -7,31 +7,319 @@
  */
 
 #include "Sessions.h"
+#include <shared/util/MulticharConstant.h>
+#include <boost/endian/arithmetic.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
 
 namespace ember {
 
-bool Sessions::register_session(std::uint32_t account_id, const Botan::BigInt& key) {
-	std::lock_guard guard(lock_);
+namespace {
 
-	auto it = sessions_.find(account_id);
+namespace be = boost::endian;
 
-	if(!allow_overwrite_ && it != sessions_.end()) {
+constexpr std::uint32_t SNAPSHOT_MAGIC = util::make_mcc("ESES");
+constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+#pragma pack(push, 1)
+
+struct SnapshotHeader {
+	be::big_uint32_t magic;
+	be::little_uint32_t version;
+	be::little_uint32_t count;
+};
+
+struct SnapshotEntry {
+	be::little_uint32_t account_id;
+	be::little_int64_t expiry; // seconds since the Unix epoch
+	Sessions::Key key;
+};
+
+#pragma pack(pop)
+
+} // unnamed
+
+Sessions::Sessions(const bool allow_overwrite, const Clock::duration ttl)
+	: allow_overwrite_(allow_overwrite), ttl_(ttl) {
+	for(auto& shard : shards_) {
+		shard.slots.resize(INITIAL_SLOTS);
+	}
+}
+
+// Fibonacci hashing, the top bits pick the shard and the rest pick the slot
+std::uint64_t Sessions::hash(const std::uint32_t account_id) {
+	return account_id * 0x9E3779B97F4A7C15ull;
+}
+
+Sessions::Shard& Sessions::shard(const std::uint32_t account_id) {
+	return shards_[hash(account_id) >> 60];
+}
+
+const Sessions::Shard& Sessions::shard(const std::uint32_t account_id) const {
+	return shards_[hash(account_id) >> 60];
+}
+
+std::size_t Sessions::find(const Shard& shard, const std::uint32_t account_id) {
+	const auto mask = shard.slots.size() - 1;
+	auto index = (hash(account_id) >> 20) & mask;
+
+	while(shard.slots[index].account_id) {
+		if(shard.slots[index].account_id == account_id) {
+			return index;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	return npos;
+}
+
+void Sessions::insert(Shard& shard, const std::uint32_t account_id, const Key& key,
+                      const Clock::time_point expiry) {
+	if(const auto index = find(shard, account_id); index != npos) {
+		shard.slots[index].key = key;
+		shard.slots[index].expiry = expiry;
+		return;
+	}
+
+	// keep the load factor at or below 3/4
+	if((shard.size + 1) * 4 > shard.slots.size() * 3) {
+		grow(shard);
+	}
+
+	const auto mask = shard.slots.size() - 1;
+	auto index = (hash(account_id) >> 20) & mask;
+
+	while(shard.slots[index].account_id) {
+		index = (index + 1) & mask;
+	}
+
+	shard.slots[index] = { account_id, expiry, key };
+	++shard.size;
+}
+
+/*
+ * Backward shift deletion - rather than leaving a tombstone, following
+ * entries are moved into the gap unless that would put them before the
+ * slot they hash to
+ */
+void Sessions::erase(Shard& shard, std::size_t index) {
+	const auto mask = shard.slots.size() - 1;
+	auto next = (index + 1) & mask;
+
+	while(shard.slots[next].account_id) {
+		const auto home = (hash(shard.slots[next].account_id) >> 20) & mask;
+
+		if(((next - home) & mask) >= ((next - index) & mask)) {
+			shard.slots[index] = shard.slots[next];
+			index = next;
+		}
+
+		next = (next + 1) & mask;
+	}
+
+	shard.slots[index].account_id = 0;
+	--shard.size;
+}
+
+void Sessions::grow(Shard& shard) {
+	auto slots = std::exchange(shard.slots, std::vector<Slot>(shard.slots.size() * 2));
+	shard.size = 0;
+
+	for(const auto& slot : slots) {
+		if(slot.account_id) {
+			insert(shard, slot.account_id, slot.key, slot.expiry);
+		}
+	}
+}
+
+bool Sessions::register_session(const std::uint32_t account_id, std::span<const std::uint8_t> key) {
+	if(!account_id || key.size() > KEY_SIZE) {
 		return false;
 	}
 
-	sessions_[account_id] = key;
+	Key padded {};
+	std::ranges::copy(key, padded.end() - key.size());
+
+	const auto now = Clock::now();
+	auto& shard = this->shard(account_id);
+	std::unique_lock guard(shard.lock);
+
+	// an expired session doesn't prevent a new one being registered
+	if(!allow_overwrite_) {
+		const auto index = find(shard, account_id);
+
+		if(index != npos && shard.slots[index].expiry > now) {
+			return false;
+		}
+	}
+
+	insert(shard, account_id, padded, now + ttl_);
 	return true;
 }
 
-std::optional<Botan::BigInt> Sessions::lookup_session(std::uint32_t account_id) const {
-	std::lock_guard guard(lock_);
-	auto it = sessions_.find(account_id);
+std::optional<Sessions::Key> Sessions::lookup_session(const std::uint32_t account_id) const {
+	const auto& shard = this->shard(account_id);
+	std::shared_lock guard(shard.lock);
+
+	const auto index = find(shard, account_id);
 
-	if(it == sessions_.end()) {
+	if(index == npos || shard.slots[index].expiry <= Clock::now()) {
 		return std::nullopt;
 	}
 
-	return std::optional<Botan::BigInt>(it->second);
+	return shard.slots[index].key;
+}
+
+// Removes expired sessions, returning the number removed
+std::size_t Sessions::sweep() {
+	std::size_t removed = 0;
+
+	for(auto& shard : shards_) {
+		std::unique_lock guard(shard.lock);
+		const auto now = Clock::now();
+
+		// erasing shifts a later entry into this slot, so it's checked again before moving on
+		for(std::size_t i = 0; i < shard.slots.size();) {
+			if(shard.slots[i].account_id && shard.slots[i].expiry <= now) {
+				erase(shard, i);
+				++removed;
+			} else {
+				++i;
+			}
+		}
+	}
+
+	return removed;
+}
+
+// Includes expired sessions that haven't yet been swept
+std::size_t Sessions::size() const {
+	std::size_t size = 0;
+
+	for(const auto& shard : shards_) {
+		std::shared_lock guard(shard.lock);
+		size += shard.size;
+	}
+
+	return size;
+}
+
+/*
+ * Steady clock time points don't survive a restart, so expiry times are
+ * stored as wall clock times. The snapshot is written alongside the
+ * destination and renamed over it, so a failed save never leaves a
+ * partial snapshot behind.
+ */
+void Sessions::save(const std::string& path) const {
+	const auto steady_now = Clock::now();
+	const auto system_now = std::chrono::system_clock::now();
+	std::vector<SnapshotEntry> entries;
+
+	for(const auto& shard : shards_) {
+		std::shared_lock guard(shard.lock);
+
+		for(const auto& slot : shard.slots) {
+			if(!slot.account_id || slot.expiry <= steady_now) {
+				continue;
+			}
+
+			const auto expiry = system_now + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+				slot.expiry - steady_now
+			);
+
+			entries.emplace_back(SnapshotEntry {
+				.account_id = slot.account_id,
+				.expiry = std::chrono::duration_cast<std::chrono::seconds>(expiry.time_since_epoch()).count(),
+				.key = slot.key
+			});
+		}
+	}
+
+	const SnapshotHeader header {
+		.magic = SNAPSHOT_MAGIC,
+		.version = SNAPSHOT_VERSION,
+		.count = static_cast<std::uint32_t>(entries.size())
+	};
+
+	const auto temp_path = path + ".tmp";
+
+	{
+		std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+
+		if(!file) {
+			throw std::runtime_error("Unable to open session snapshot for writing: " + temp_path);
+		}
+
+		// session keys are secrets, keep them away from other users
+		std::filesystem::permissions(temp_path, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SnapshotEntry));
+
+		if(!file) {
+			throw std::runtime_error("Unable to write session snapshot: " + temp_path);
+		}
+	}
+
+	std::filesystem::rename(temp_path, path);
+}
+
+// Restores sessions from a snapshot, returning the number that hadn't expired
+std::size_t Sessions::load(const std::string& path) {
+	std::ifstream file(path, std::ios::binary);
+
+	if(!file) {
+		throw std::runtime_error("Unable to open session snapshot: " + path);
+	}
+
+	SnapshotHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	if(!file || header.magic != SNAPSHOT_MAGIC) {
+		throw std::runtime_error("Invalid session snapshot: " + path);
+	}
+
+	if(header.version != SNAPSHOT_VERSION) {
+		throw std::runtime_error("Unsupported session snapshot version: " + path);
+	}
+
+	if(std::filesystem::file_size(path) != sizeof(header) + std::size_t(header.count) * sizeof(SnapshotEntry)) {
+		throw std::runtime_error("Session snapshot size does not match its header: " + path);
+	}
+
+	std::vector<SnapshotEntry> entries(header.count);
+	file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(SnapshotEntry));
+
+	if(!file) {
+		throw std::runtime_error("Unable to read session snapshot: " + path);
+	}
+
+	const auto steady_now = Clock::now();
+	const auto system_now = std::chrono::system_clock::now();
+	std::size_t loaded = 0;
+
+	for(const auto& entry : entries) {
+		const auto expiry = std::chrono::system_clock::time_point(std::chrono::seconds(entry.expiry));
+
+		if(!entry.account_id || expiry <= system_now) {
+			continue;
+		}
+
+		auto& shard = this->shard(entry.account_id);
+		std::unique_lock guard(shard.lock);
+		insert(shard, entry.account_id, entry.key,
+		       steady_now + std::chrono::duration_cast<Clock::duration>(expiry - system_now));
+		++loaded;
+	}
+
+	return loaded;
 }
 
-} // ember
\ No newline at end of file
+} // ember
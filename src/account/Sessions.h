@@ -8,23 +8,79 @@
 
 #pragma once
 
-#include <botan/bigint.h>
+#include <array>
+#include <chrono>
 #include <optional>
-#include <mutex>
-#include <unordered_map>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <vector>
+#include <cstddef>
 #include <cstdint>
 
 namespace ember {
 
+/*
+ * Session keys, sharded by account ID so that lookups for different accounts
+ * rarely contend and readers of a shard don't block each other. Each shard is
+ * an open-addressing table with the keys stored inline, so a lookup doesn't
+ * allocate.
+ *
+ * Sessions expire once the TTL has passed since they were registered. Expired
+ * sessions are never returned but hold onto their slots until sweep() is
+ * called. The store can be saved to and restored from a snapshot, allowing a
+ * restarted account service to pick up where it left off.
+ *
+ * Account ID 0 is reserved and can't be registered.
+ */
 class Sessions final {
-	bool allow_overwrite_;
-	std::unordered_map<std::uint32_t, Botan::BigInt> sessions_;
-	mutable std::mutex lock_;
+public:
+	static constexpr std::size_t KEY_SIZE = 40; // SRP6 session key
+	using Key = std::array<std::uint8_t, KEY_SIZE>;
+	using Clock = std::chrono::steady_clock;
+
+private:
+	static constexpr std::size_t SHARD_COUNT = 16;
+	static constexpr std::size_t INITIAL_SLOTS = 64; // per shard, must be a power of two
+
+	struct Slot {
+		std::uint32_t account_id; // 0 if empty
+		Clock::time_point expiry;
+		Key key;
+	};
+
+	struct alignas(64) Shard {
+		std::vector<Slot> slots;
+		std::size_t size = 0;
+		mutable std::shared_mutex lock;
+	};
+
+	const bool allow_overwrite_;
+	const Clock::duration ttl_;
+	std::array<Shard, SHARD_COUNT> shards_;
+
+	static std::uint64_t hash(std::uint32_t account_id);
+	Shard& shard(std::uint32_t account_id);
+	const Shard& shard(std::uint32_t account_id) const;
+
+	// shard functions must be called with the shard's lock held
+	static std::size_t find(const Shard& shard, std::uint32_t account_id);
+	static void insert(Shard& shard, std::uint32_t account_id, const Key& key, Clock::time_point expiry);
+	static void erase(Shard& shard, std::size_t index);
+	static void grow(Shard& shard);
 
 public:
-	explicit Sessions(bool allow_overwrite) : allow_overwrite_(allow_overwrite) { }
-	bool register_session(std::uint32_t account_id, const Botan::BigInt& key);
-	std::optional<Botan::BigInt> lookup_session(std::uint32_t account_id) const;
+	Sessions(bool allow_overwrite, Clock::duration ttl);
+
+	// the key is big-endian and may omit leading zeroes, as Botan::BigInt::encode produces
+	bool register_session(std::uint32_t account_id, std::span<const std::uint8_t> key);
+	std::optional<Key> lookup_session(std::uint32_t account_id) const;
+
+	std::size_t sweep();
+	std::size_t size() const;
+
+	void save(const std::string& path) const;
+	std::size_t load(const std::string& path);
 };
 
-} // ember
\ No newline at end of file
+} // ember
@@ -28,12 +28,19 @@
 #include <shared/util/LogConfig.h>
 #include <shared/util/Utility.h>
 #include <boost/program_options.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <semaphore>
 #include <stdexcept>
+#include <stop_token>
+#include <thread>
 #include <utility>
 #include <cstddef>
 #include <cstdint>
@@ -53,6 +60,7 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 int asio_launch(const po::variables_map& args, log::Logger* logger);
 po::variables_map parse_arguments(int argc, const char* argv[]);
 void pool_log_callback(ep::Severity, std::string_view message, el::Logger* logger);
+void save_sessions(const Sessions& sessions, const std::string& path, log::Logger* logger);
 
 std::exception_ptr eptr = nullptr;
 
@@ -158,7 +166,33 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	auto s_port = args["spark.port"].as<std::uint16_t>();
 	auto spark_filter = el::Filter(FilterType::LF_SPARK);
 
-	Sessions sessions(true);
+	const auto ttl = std::chrono::seconds(args["sessions.ttl"].as<std::uint32_t>());
+	const auto sweep_interval = std::max(std::chrono::seconds(args["sessions.sweep_interval"].as<std::uint32_t>()), 1s);
+	const auto& snapshot_path = args["sessions.snapshot"].as<std::string>();
+	Sessions sessions(true, ttl);
+
+	if(!snapshot_path.empty() && std::filesystem::exists(snapshot_path)) {
+		try {
+			const auto restored = sessions.load(snapshot_path);
+			LOG_INFO_SYNC(logger, "Restored {} sessions from {}", restored, snapshot_path);
+		} catch(const std::exception& e) {
+			LOG_WARN_SYNC(logger, "Unable to restore sessions: {}", e.what());
+		}
+	}
+
+	// expired sessions are reclaimed (and the snapshot refreshed) in the background
+	std::jthread sweeper([&](std::stop_token token) {
+		thread::set_name("Session Sweeper");
+		std::mutex mutex;
+		std::condition_variable_any cv;
+		std::unique_lock lock(mutex);
+
+		while(!cv.wait_for(lock, token, sweep_interval, [&] { return token.stop_requested(); })) {
+			const auto removed = sessions.sweep();
+			LOG_DEBUG_ASYNC(logger, "Swept {} expired sessions", removed);
+			save_sessions(sessions, snapshot_path, logger);
+		}
+	});
 
 	spark::v2::Server sparkv2(service, "account", s_address, s_port, logger); // temp port
 	AccountService acct_service(sparkv2, handler, sessions, *logger);
@@ -170,6 +204,10 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	sem.acquire();
 
 	LOG_INFO_SYNC(logger, "{} shutting down...", APP_NAME);
+
+	sweeper.request_stop();
+	sweeper.join();
+	save_sessions(sessions, snapshot_path, logger);
 } catch(...) {
 	eptr = std::current_exception();
 }
@@ -214,6 +252,9 @@ po::variables_map parse_arguments(int argc, const char* argv[]) {
 		("database.config_path", po::value<std::string>()->required())
 		("database.min_connections", po::value<unsigned short>()->required())
 		("database.max_connections", po::value<unsigned short>()->required())
+		("sessions.ttl", po::value<std::uint32_t>()->default_value(86400))
+		("sessions.sweep_interval", po::value<std::uint32_t>()->default_value(60))
+		("sessions.snapshot", po::value<std::string>()->default_value(""))
 		("metrics.enabled", po::bool_switch()->required())
 		("metrics.statsd_host", po::value<std::string>()->required())
 		("metrics.statsd_port", po::value<std::uint16_t>()->required())
@@ -243,6 +284,14 @@ po::variables_map parse_arguments(int argc, const char* argv[]) {
 	return options;
 }
 
+void save_sessions(const Sessions& sessions, const std::string& path, log::Logger* logger) try {
+	if(!path.empty()) {
+		sessions.save(path);
+	}
+} catch(const std::exception& e) {
+	LOG_ERROR_ASYNC(logger, "Unable to save session snapshot: {}", e.what());
+}
+
 void pool_log_callback(ep::Severity severity, std::string_view message, el::Logger* logger) {
 	switch(severity) {
 		case ep::Severity::DEBUG:
@@ -12,6 +12,8 @@
 #include <shared/util/Utility.h>
 #include <shared/threading/ThreadPool.h>
 #include <boost/assert.hpp>
+#include <utility>
+#include <vector>
 
 namespace ember {
 
@@ -91,61 +93,23 @@ void CharacterHandler::do_create(std::uint32_t account_id, std::uint32_t realm_i
 	}
 
 	// name validation
-	auto result = validate_name(character.name);
+	utf8_string formatted_name;
+	auto result = validate_name(character.name, formatted_name);
 
 	if(result != protocol::Result::CHAR_NAME_SUCCESS) {
 		callback(result);
 		return;
 	}
 
-	character.name = util::utf8::name_format(character.name, std::locale());
+	character.name = std::move(formatted_name);
+	character.internal_name = character.name;
 
-	const auto res = dao_.character(character.name, realm_id);
-
-	if(res) {
+	if(taken_names_.taken(realm_id, character.name)) {
 		callback(protocol::Result::CHAR_CREATE_NAME_IN_USE);
 		return;
 	}
 
-	// query database for further validation steps
-	const auto total_chars = dao_.count(account_id);
-
-	if(total_chars >= MAX_CHARACTER_SLOTS_ACCOUNT) {
-		callback(protocol::Result::CHAR_CREATE_ACCOUNT_LIMIT);
-		return;
-	}
-
-	// avoid an additional query if there's no need for it
-	if(total_chars >= MAX_CHARACTER_SLOTS_SERVER) {
-		const auto count = dao_.count(account_id, realm_id);
-
-		if(count >= MAX_CHARACTER_SLOTS_SERVER) {
-			callback(protocol::Result::CHAR_CREATE_SERVER_LIMIT);
-			return;
-		}
-	}
-
-	const auto& characters = dao_.characters(account_id, realm_id);
-
-	// PvP faction check
-	auto faction_group = dbc_.chr_races[character.race]->faction->faction_group_id;
-
-	auto it = std::ranges::find_if_not(characters, [&](auto& c) {
-		return faction_group == dbc_.chr_races[c.race]->faction->faction_group_id;
-	});
-
-	if(it != characters.end() /* && pvp_server */) { // todo, add check to make sure it's a PvP server
-		auto current = pvp_faction(*dbc_.chr_races[characters.front().race]->faction);
-		auto opposing = pvp_faction(*dbc_.chr_races[character.race]->faction);
-
-		LOG_DEBUG_ASYNC(logger_, "Cannot create {} characters with existing {} characters on a PvP realm",
-		                opposing->internal_name, current->internal_name);
-
-		callback(protocol::Result::CHAR_CREATE_PVP_TEAMS_VIOLATION);
-		return;
-	}
-
-	// everything looks good - populate the character data and create it
+	// populate the character data and create it
 	const dbc::ChrRaces* race = dbc_.chr_races[character.race];
 	const dbc::ChrClasses* class_ = dbc_.chr_classes[character.class_];
 
@@ -229,8 +193,34 @@ void CharacterHandler::do_create(std::uint32_t account_id, std::uint32_t realm_i
 	                subzone? "," : " ",
 	                subzone? subzone : " ");
 
-	dao_.create(character);
-	callback(protocol::Result::CHAR_CREATE_SUCCESS);
+	// name, slot and PvP faction checks are made by the database along with the insert
+	const dal::CreateConstraints constraints {
+		.account_slots = static_cast<std::uint32_t>(MAX_CHARACTER_SLOTS_ACCOUNT),
+		.realm_slots = static_cast<std::uint32_t>(MAX_CHARACTER_SLOTS_SERVER),
+		.conflicting_races = conflicting_races(character.race) // todo, only on PvP realms
+	};
+
+	switch(dao_.create(character, constraints)) {
+		case dal::CreateResult::SUCCESS:
+			taken_names_.insert(realm_id, character.name);
+			callback(protocol::Result::CHAR_CREATE_SUCCESS);
+			break;
+		case dal::CreateResult::NAME_IN_USE:
+			taken_names_.insert(realm_id, character.name);
+			callback(protocol::Result::CHAR_CREATE_NAME_IN_USE);
+			break;
+		case dal::CreateResult::ACCOUNT_LIMIT:
+			callback(protocol::Result::CHAR_CREATE_ACCOUNT_LIMIT);
+			break;
+		case dal::CreateResult::REALM_LIMIT:
+			callback(protocol::Result::CHAR_CREATE_SERVER_LIMIT);
+			break;
+		case dal::CreateResult::FACTION_CONFLICT:
+			LOG_DEBUG_ASYNC(logger_, "Cannot create {} characters alongside opposing faction characters on a PvP realm",
+			                pvp_faction(*race->faction)->internal_name);
+			callback(protocol::Result::CHAR_CREATE_PVP_TEAMS_VIOLATION);
+			break;
+	}
 } catch(dal::exception& e) {
 	LOG_ERROR(logger_) << e.what() << LOG_ASYNC;
 	callback(protocol::Result::CHAR_CREATE_ERROR);
@@ -265,6 +255,7 @@ void CharacterHandler::do_erase(std::uint32_t account_id, std::uint32_t realm_id
 	LOG_DEBUG_ASYNC(logger_, "Deleting {}, #{}", character->name, character->id);
 
 	dao_.delete_character(character_id, true);
+	taken_names_.erase(character->realm_id, character->name);
 	callback(protocol::Result::CHAR_DELETE_SUCCESS);
 } catch(dal::exception& e) {
 	LOG_ERROR(logger_) << e.what() << LOG_ASYNC;
@@ -303,18 +294,25 @@ void CharacterHandler::do_rename(std::uint32_t account_id, std::uint64_t charact
 		return;
 	}
 
-	auto result = validate_name(name);
+	utf8_string formatted_name;
+	auto result = validate_name(name, formatted_name);
 
 	if(result != protocol::Result::CHAR_NAME_SUCCESS) {
 		callback(result, std::nullopt);
 		return;
 	}
 
-	character->name = util::utf8::name_format(name, std::locale());
+	const auto old_name = std::exchange(character->name, std::move(formatted_name));
+
+	if(taken_names_.taken(character->realm_id, character->name)) {
+		callback(protocol::Result::CHAR_CREATE_NAME_IN_USE, std::nullopt);
+		return;
+	}
 
 	const std::optional<Character>& match = dao_.character(character->name, character->realm_id);
 
 	if(match) {
+		taken_names_.insert(character->realm_id, character->name);
 		callback(protocol::Result::CHAR_CREATE_NAME_IN_USE, std::nullopt);
 		return;
 	}
@@ -325,6 +323,8 @@ void CharacterHandler::do_rename(std::uint32_t account_id, std::uint64_t charact
 	character->flags ^= Character::Flags::RENAME;
 
 	dao_.update(*character);
+	taken_names_.erase(character->realm_id, old_name);
+	taken_names_.insert(character->realm_id, character->name);
 	callback(protocol::Result::RESPONSE_SUCCESS, *character);
 } catch(dal::exception& e) {
 	LOG_ERROR(logger_) << e.what() << LOG_ASYNC;
@@ -366,6 +366,11 @@ void CharacterHandler::do_restore(std::uint64_t id, const ResultCB& callback) co
 
 	dao_.update(*character);
 	dao_.restore(id);
+
+	if(!name_taken) {
+		taken_names_.insert(character->realm_id, character->name);
+	}
+
 	callback(protocol::Result::RESPONSE_SUCCESS);
 } catch(dal::exception& e) {
 	LOG_ERROR(logger_) << e.what() << LOG_ASYNC;
@@ -452,73 +457,71 @@ bool CharacterHandler::validate_options(const Character& character, std::uint32_
 	return true;
 }
 
-protocol::Result CharacterHandler::validate_name(const utf8_string& name) const {
+protocol::Result CharacterHandler::validate_name(const utf8_string& name, utf8_string& formatted) const {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
 	if(name.empty()) {
 		return protocol::Result::CHAR_NAME_NO_NAME;
 	}
 
-	if(!util::utf8::is_valid(name)) {
+	// validation, length, repetition, letters and formatting in a single pass
+	auto info = util::utf8::inspect_name(name, std::locale());
+
+	if(!info.valid) {
 		return protocol::Result::CHAR_NAME_FAILURE;
 	}
-	
-	const std::size_t length = util::utf8::length(name);
 
-	if(length > MAX_NAME_LENGTH) {
+	if(info.length > MAX_NAME_LENGTH) {
 		return protocol::Result::CHAR_NAME_TOO_LONG;
 	}
 
-	if(length < MIN_NAME_LENGTH) {
+	if(info.length < MIN_NAME_LENGTH) {
 		return protocol::Result::CHAR_NAME_TOO_SHORT;
 	}
 
 	// todo, add a config option to restrict names to ASCII
 
-	if(util::utf8::max_consecutive(name, true) > MAX_CONSECUTIVE_LETTERS) {
+	if(info.max_consecutive > MAX_CONSECUTIVE_LETTERS) {
 		return protocol::Result::CHAR_NAME_THREE_CONSECUTIVE;
 	}
 
-	if(!util::utf8::is_alpha(name, std::locale())) {
+	if(!info.alpha) {
 		return protocol::Result::CHAR_NAME_ONLY_LETTERS;
 	}
 
-	const auto& formatted_name = util::utf8::name_format(name, std::locale());
+	const std::pair<const util::pcre::PatternSet&, protocol::Result> filters[] {
+		{ reserved_names_, protocol::Result::CHAR_NAME_RESERVED },
+		{ profane_names_, protocol::Result::CHAR_NAME_PROFANE },
+		{ spam_names_, protocol::Result::CHAR_NAME_RESERVED }
+	};
 
-	for(auto& regex : reserved_names_) {
-		int ret = util::pcre::match(formatted_name, regex);
+	for(const auto& [patterns, filter_result] : filters) {
+		const int ret = patterns.match(info.formatted);
 
 		if(ret >= 0) {
-			return protocol::Result::CHAR_NAME_RESERVED;
+			return filter_result;
 		} else if(ret != PCRE_ERROR_NOMATCH) {
 			LOG_ERROR_ASYNC(logger_, "PCRE error encountered: {}", ret);
 			return protocol::Result::CHAR_NAME_FAILURE;
 		}
 	}
 
-	for(auto& regex : profane_names_) {
-		int ret = util::pcre::match(formatted_name, regex);
-
-		if(ret >= 0) {
-			return protocol::Result::CHAR_NAME_PROFANE;
-		} else if(ret != PCRE_ERROR_NOMATCH) {
-			LOG_ERROR_ASYNC(logger_, "PCRE error encountered: {}", ret);
-			return protocol::Result::CHAR_NAME_FAILURE;
-		}
-	}
+	formatted = std::move(info.formatted);
+	return protocol::Result::CHAR_NAME_SUCCESS;
+}
 
-	for(auto& regex : spam_names_) {
-		int ret = util::pcre::match(formatted_name, regex);
+// Races belonging to a different faction group, which can't share a PvP realm with the given race
+std::vector<std::uint8_t> CharacterHandler::conflicting_races(std::uint8_t race) const {
+	const auto faction_group = dbc_.chr_races[race]->faction->faction_group_id;
+	std::vector<std::uint8_t> races;
 
-		if(ret >= 0) {
-			return protocol::Result::CHAR_NAME_RESERVED;
-		} else if(ret != PCRE_ERROR_NOMATCH) {
-			LOG_ERROR_ASYNC(logger_, "PCRE error encountered: {}", ret);
-			return protocol::Result::CHAR_NAME_FAILURE;
+	for(const auto& [id, record] : dbc_.chr_races) {
+		if(record.faction && record.faction->faction_group_id != faction_group) {
+			races.emplace_back(static_cast<std::uint8_t>(id));
 		}
 	}
 
-	return protocol::Result::CHAR_NAME_SUCCESS;
+	return races;
 }
 
 // This function should be moved when there's a more suitable home for it
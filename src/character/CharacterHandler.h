@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "NameCache.h"
 #include <Character_generated.h>
 #include <dbcreader/Storage.h>
 #include <protocol/ResultCodes.h>
@@ -18,6 +19,7 @@
 //#include <boost/locale.hpp>
 #include <pcre.h>
 #include <locale>
+#include <chrono>
 #include <functional>
 #include <string>
 #include <optional>
@@ -40,9 +42,10 @@ class CharacterHandler final {
 	const std::size_t MAX_CHARACTER_SLOTS_SERVER = 10;
 	const std::size_t MAX_CHARACTER_SLOTS_ACCOUNT = 100; // todo, allow config
 
-	const std::vector<util::pcre::Result> profane_names_;
-	const std::vector<util::pcre::Result> reserved_names_;
-	const std::vector<util::pcre::Result> spam_names_;
+	const util::pcre::PatternSet profane_names_;
+	const util::pcre::PatternSet reserved_names_;
+	const util::pcre::PatternSet spam_names_;
+	mutable NameCache taken_names_ { 50'000, std::chrono::minutes(10) };
 	const dbc::Storage& dbc_;
 	const dal::CharacterDAO& dao_;
 	const std::locale locale_;
@@ -50,12 +53,13 @@ class CharacterHandler final {
 	ThreadPool& pool_;
 	log::Logger* logger_;
 
-	protocol::Result validate_name(const utf8_string& name) const;
+	protocol::Result validate_name(const utf8_string& name, utf8_string& formatted) const;
 	bool validate_options(const ember::Character& character, std::uint32_t account_id) const;
 	void populate_items(ember::Character& character, const dbc::CharStartOutfit& outfit) const;
 	void populate_spells(ember::Character& character, const dbc::CharStartSpells& spells) const;
 	void populate_skills(ember::Character& character, const dbc::CharStartSkills& skills) const;
 	const dbc::FactionGroup* pvp_faction(const dbc::FactionTemplate& fac_template) const;
+	std::vector<std::uint8_t> conflicting_races(std::uint8_t race) const;
 
 	/** I/O heavy functions run async in a thread pool **/
 
@@ -83,9 +87,9 @@ class CharacterHandler final {
 
 
 public:
-	CharacterHandler(std::vector<util::pcre::Result> profane_names,
-	                 std::vector<util::pcre::Result> reserved_names,
-	                 std::vector<util::pcre::Result> spam_names,
+	CharacterHandler(util::pcre::PatternSet profane_names,
+	                 util::pcre::PatternSet reserved_names,
+	                 util::pcre::PatternSet spam_names,
 	                 const dbc::Storage& dbc, const dal::CharacterDAO& dao,
 	                 ThreadPool& pool, const std::locale& locale, log::Logger* logger)
 		: profane_names_(std::move(profane_names)),
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/util/UTF8String.h>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace ember {
+
+/*
+ * Remembers which names are known to be taken on each realm, so repeated
+ * attempts at creating or renaming to a popular name can be turned away
+ * without a database query. Only names seen by this process are cached and
+ * another process may free them up, so entries expire after a while rather
+ * than being trusted indefinitely. Once the capacity is reached, the oldest
+ * entries are evicted first.
+ */
+class NameCache final {
+	using Clock = std::chrono::steady_clock;
+
+	struct Insertion {
+		std::uint32_t realm_id;
+		utf8_string name;
+		Clock::time_point expiry;
+	};
+
+	const std::size_t capacity_;
+	const Clock::duration ttl_;
+
+	std::unordered_map<std::uint32_t, std::unordered_map<utf8_string, Clock::time_point>> realms_;
+	std::deque<Insertion> insertions_;
+	std::size_t size_ = 0;
+	mutable std::mutex lock_;
+
+	// must be called with the lock held
+	bool current(const Insertion& insertion) const {
+		auto realm = realms_.find(insertion.realm_id);
+
+		if(realm == realms_.end()) {
+			return false;
+		}
+
+		// entries that have since been removed or refreshed don't belong to this insertion
+		auto entry = realm->second.find(insertion.name);
+		return entry != realm->second.end() && entry->second == insertion.expiry;
+	}
+
+	// must be called with the lock held
+	void evict_oldest() {
+		const auto insertion = std::move(insertions_.front());
+		insertions_.pop_front();
+
+		if(current(insertion)) {
+			realms_[insertion.realm_id].erase(insertion.name);
+			--size_;
+		}
+	}
+
+public:
+	NameCache(std::size_t capacity, Clock::duration ttl)
+		: capacity_(capacity), ttl_(ttl) {}
+
+	bool taken(std::uint32_t realm_id, const utf8_string& name) const {
+		std::lock_guard guard(lock_);
+
+		auto realm = realms_.find(realm_id);
+
+		if(realm == realms_.end()) {
+			return false;
+		}
+
+		auto entry = realm->second.find(name);
+		return entry != realm->second.end() && entry->second > Clock::now();
+	}
+
+	void insert(std::uint32_t realm_id, const utf8_string& name) {
+		if(!capacity_) {
+			return;
+		}
+
+		std::lock_guard guard(lock_);
+
+		const auto expiry = Clock::now() + ttl_;
+		auto [entry, inserted] = realms_[realm_id].insert_or_assign(name, expiry);
+
+		if(inserted) {
+			++size_;
+		}
+
+		insertions_.emplace_back(realm_id, name, expiry);
+
+		while(size_ > capacity_ && !insertions_.empty()) {
+			evict_oldest();
+		}
+
+		// refreshed and erased entries leave stale insertions behind, don't let them pile up
+		if(insertions_.size() > capacity_ * 2) {
+			std::erase_if(insertions_, [&](const Insertion& insertion) {
+				return !current(insertion);
+			});
+		}
+	}
+
+	void erase(std::uint32_t realm_id, const utf8_string& name) {
+		std::lock_guard guard(lock_);
+
+		auto realm = realms_.find(realm_id);
+
+		if(realm != realms_.end() && realm->second.erase(name)) {
+			--size_;
+		}
+	}
+
+	std::size_t size() const {
+		std::lock_guard guard(lock_);
+		return size_;
+	}
+};
+
+} // ember
@@ -130,12 +130,18 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 #ifdef DEBUG_NO_THREADS
 	LOG_WARN(logger) << "Compiled with DEBUG_NO_THREADS!" << LOG_SYNC;
 #endif
+	auto concurrency = check_concurrency(logger);
+	ThreadPool thread_pool(concurrency);
+
 	LOG_INFO(logger) << "Loading DBC data..." << LOG_SYNC;
 	dbc::DiskLoader loader(args["dbc.path"].as<std::string>(), [&](auto message) {
 		LOG_DEBUG(logger) << message << LOG_SYNC;
+	}, [&](auto dbc, auto elapsed) {
+		const auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+		LOG_DEBUG_SYNC(logger, "Loaded {} in {}", dbc, us);
 	});
 
-	auto dbc_store = loader.load(
+	auto dbc_store = loader.load(thread_pool,
 		"ChrClasses", "ChrRaces", "CharBaseInfo", "NamesProfanity", "NamesReserved", "CharSections",
 		"CharacterFacialHairStyles", "CharStartBase", "CharStartSpells", "CharStartSkills",
 		"CharStartZones", "CharStartOutfit", "AreaTable", "FactionTemplate", "FactionGroup",
@@ -143,23 +149,31 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	);
 
 	LOG_INFO(logger) << "Resolving DBC references..." << LOG_SYNC;
-	dbc::link(dbc_store);
+	dbc::link(dbc_store, thread_pool);
 
 	LOG_INFO_GLOB << "Compiling DBC regular expressions..." << LOG_ASYNC;
-	std::vector<util::pcre::Result> profanity, reserved, spam;
+	std::vector<std::string> profanity, reserved, spam;
 
 	for(auto& [_, record] : dbc_store.names_profanity) {
-		profanity.emplace_back(util::pcre::utf8_jit_compile(record.name));
+		profanity.emplace_back(record.name);
 	}
 
 	for(auto& [_, record] : dbc_store.names_reserved) {
-		reserved.emplace_back(util::pcre::utf8_jit_compile(record.name));
+		reserved.emplace_back(record.name);
 	}
 
 	for(auto& [_, record] : dbc_store.spam_messages) {
-		spam.emplace_back(util::pcre::utf8_jit_compile(record.text));
+		spam.emplace_back(record.text);
 	}
 
+	util::pcre::PatternSet profanity_set(std::move(profanity));
+	util::pcre::PatternSet reserved_set(std::move(reserved));
+	util::pcre::PatternSet spam_set(std::move(spam));
+
+	LOG_DEBUG(logger) << "Compiled name filters into "
+	                  << profanity_set.compiled_size() + reserved_set.compiled_size() + spam_set.compiled_size()
+	                  << " patterns" << LOG_SYNC;
+
 	LOG_INFO(logger) << "Initialising database driver..." << LOG_SYNC;
 	const auto&  db_config_path = args["database.config_path"].as<std::string>();
 	auto driver(drivers::init_db_driver(db_config_path, "login"));
@@ -167,7 +181,6 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	LOG_INFO(logger) << "Initialising database connection pool..." << LOG_SYNC;
 	auto min_conns = args["database.min_connections"].as<unsigned short>();
 	auto max_conns = args["database.max_connections"].as<unsigned short>();
-	auto concurrency = check_concurrency(logger);
 
 	if(!max_conns) {
 		max_conns = concurrency;
@@ -188,8 +201,7 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 
 	std::locale temp;
 
-	ThreadPool thread_pool(concurrency);
-	CharacterHandler handler(std::move(profanity), std::move(reserved), std::move(spam),
+	CharacterHandler handler(std::move(profanity_set), std::move(reserved_set), std::move(spam_set),
 	                         dbc_store, character_dao, thread_pool, temp, logger);
 
 	const auto&  s_address = args["spark.address"].as<std::string>();
@@ -8,15 +8,24 @@
 
 #include "ClientConnection.h"
 #include "SessionManager.h"
+#include "CompressMessage.h"
+#include "Locator.h"
+#include "packetlog/CaptureSink.h"
 #include "packetlog/FBSink.h"
 #include "packetlog/LogSink.h"
 #include <logger/Logger.h>
 #include <protocol/PacketHeaders.h>
-#include <spark/buffers/BufferSequence.h>
 #include <spark/buffers/BinaryStream.h>
+#include <spark/buffers/pmr/BufferAdaptor.h>
 #include <boost/asio/dispatch.hpp>
 #include <boost/asio/post.hpp>
+#include <boost/container/small_vector.hpp>
+#include <gsl/gsl_util>
+#include <zlib.h>
 #include <algorithm>
+#include <array>
+#include <vector>
+#include <cstring>
 
 namespace ember {
 
@@ -28,7 +37,7 @@ void ClientConnection::parse_header(StaticBuffer& buffer) {
 	}
 
 	if(crypt_) [[likely]] {
-		crypt_->decrypt(buffer, protocol::ClientHeader::WIRE_SIZE);
+		crypt_->decrypt({ buffer.read_ptr(), protocol::ClientHeader::WIRE_SIZE });
 	}
 
 	BinaryStream stream(buffer);
@@ -68,7 +77,9 @@ void ClientConnection::process_buffered_data(StaticBuffer& buffer) {
 		}
 
 		if(read_state_ == ReadState::DONE) {
-			++stats_.messages_in;
+			increment(stats_.messages_in);
+			increment(shard_stats_.messages_in);
+			load_.record_traffic(0, 1);
 
 			if(packet_logger_) [[unlikely]] {
 				std::span packet(buffer.read_ptr(), msg_size_);
@@ -93,14 +104,18 @@ void ClientConnection::write() {
 		return;
 	}
 
-	const spark::io::BufferSequence sequence(*outbound_front_);
+	boost::container::small_vector<boost::asio::const_buffer, GATHER_HINT> sequence;
+	outbound_front_->gather(sequence, MAX_GATHER_BUFFERS);
 
 	socket_.async_send(sequence, create_alloc_handler(allocator_,
 		[this](boost::system::error_code ec, std::size_t size) {
-			stats_.bytes_out += size;
-			++stats_.packets_out;
+			increment(stats_.bytes_out, size);
+			increment(stats_.packets_out);
+			increment(shard_stats_.bytes_out, size);
+			increment(shard_stats_.packets_out);
+			load_.record_traffic(size);
 
-			outbound_front_->skip(size);
+			outbound_front_->consume(size);
 
 			if(!ec) {
 				if(!outbound_front_->empty()) {
@@ -121,6 +136,87 @@ void ClientConnection::write() {
 	));
 }
 
+void ClientConnection::queue_write() {
+	if(!write_in_progress_) {
+		write_in_progress_ = true;
+		std::swap(outbound_front_, outbound_back_);
+		write();
+	}
+}
+
+/*
+ * Queues a packet that has already been serialised, for broadcasts.
+ * Only the header is written (and encrypted) per connection - the
+ * payload is referenced by the outbound queue and handed directly
+ * to the socket as part of the gather write.
+ */
+void ClientConnection::send(std::shared_ptr<const SharedPacket> packet) {
+	auto header = packet->header();
+
+	if(crypt_) [[likely]] {
+		crypt_->encrypt(header);
+	}
+
+	if(packet_logger_) [[unlikely]] {
+		packet_logger_->log(packet->data(), PacketDirection::OUTBOUND);
+	}
+
+	outbound_back_->buffer().write(header.data(), header.size());
+	outbound_back_->attach(std::move(packet));
+	queue_write();
+	increment(stats_.messages_out);
+	increment(shard_stats_.messages_out);
+	load_.record_traffic(0, 1);
+}
+
+/*
+ * Replaces an SMSG_UPDATE_OBJECT payload with SMSG_COMPRESSED_UPDATE_OBJECT
+ * if it's large enough to be worth compressing. Returns false if the
+ * caller should send the original packet instead.
+ */
+bool ClientConnection::send_compressed(std::span<const std::uint8_t> payload) {
+	using Header = protocol::ServerHeader;
+
+	if(payload.size() < COMPRESSION_THRESHOLD) {
+		return false;
+	}
+
+	thread_local std::vector<std::uint8_t> compressed;
+	compressed.clear();
+	spark::io::pmr::BufferAdaptor adaptor(compressed);
+
+	if(const auto ret = compress_message(payload, adaptor, compression_level_); ret != Z_OK) {
+		LOG_DEBUG_FILTER(logger_, LF_NETWORK)
+			<< "Message compression failed, " << ret << LOG_ASYNC;
+		return false;
+	}
+
+	// incompressible data, don't make things worse
+	if(compressed.size() >= payload.size()) {
+		return false;
+	}
+
+	const auto size = gsl::narrow<Header::SizeType>(compressed.size() + sizeof(Header::OpcodeType));
+	const auto opcode = protocol::ServerOpcode::SMSG_COMPRESSED_UPDATE_OBJECT;
+
+	std::array<std::uint8_t, Header::WIRE_SIZE> header;
+	std::memcpy(header.data(), &size, sizeof(size));
+	std::memcpy(header.data() + sizeof(size), &opcode, sizeof(opcode));
+
+	if(crypt_) [[likely]] {
+		crypt_->encrypt(header);
+	}
+
+	auto& buffer = outbound_back_->buffer();
+	buffer.write(header.data(), header.size());
+	buffer.write(compressed.data(), compressed.size());
+	queue_write();
+	increment(stats_.messages_out);
+	increment(shard_stats_.messages_out);
+	load_.record_traffic(0, 1);
+	return true;
+}
+
 void ClientConnection::read() {
 	if(!socket_.is_open()) {
 		return;
@@ -140,8 +236,11 @@ void ClientConnection::read() {
 		create_alloc_handler(allocator_,
 		[this](boost::system::error_code ec, std::size_t size) {
 			if(!ec) {
-				stats_.bytes_in += size;
-				++stats_.packets_in;
+				increment(stats_.bytes_in, size);
+				increment(stats_.packets_in);
+				increment(shard_stats_.bytes_in, size);
+				increment(shard_stats_.packets_in);
+				load_.record_traffic(size);
 
 				inbound_buffer_.advance_write(size);
 				process_buffered_data(inbound_buffer_);
@@ -157,12 +256,20 @@ void ClientConnection::set_key(std::span<const std::uint8_t> key) {
 	crypt_ = PacketCrypto(key);
 }
 
+ClientConnection::~ClientConnection() {
+	load_.connections.fetch_sub(1, std::memory_order_relaxed);
+}
+
 void ClientConnection::start() {
 	stopped_ = false;
 
 	// when using DynamicTLSBuffer, we need to ensure the first write
 	// (triggered by handler_) is invoked from the service thread
 	boost::asio::post(socket_.get_executor(), [&] {
+		if(Locator::capture()) [[unlikely]] {
+			log_packets(true);
+		}
+
 		handler_.start();
 		read();
 	});
@@ -173,6 +280,11 @@ void ClientConnection::stop() {
 		<< "Closing connection to " << remote_address() << LOG_ASYNC;
 
 	handler_.stop();
+
+	// latency is only written on this thread, so the connection takes
+	// its own contribution back out of the shard's total
+	latency(0);
+
 	boost::system::error_code ec; // we don't care about any errors
 	socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
 	socket_.close(ec);
@@ -224,16 +336,44 @@ std::string ClientConnection::remote_address() const {
 	return remote_ep_.address().to_string();
 }
 
-const ConnectionStats& ClientConnection::stats() const {
-	return stats_;
+/*
+ * The counters are only written on the connection's thread but can
+ * be read from anywhere, so this returns a snapshot rather than a
+ * reference. QoS polls it from its own timer.
+ */
+ConnectionStats ClientConnection::stats() const {
+	return {
+		.bytes_in = stats_.bytes_in.load(std::memory_order_relaxed),
+		.bytes_out = stats_.bytes_out.load(std::memory_order_relaxed),
+		.messages_in = stats_.messages_in.load(std::memory_order_relaxed),
+		.messages_out = stats_.messages_out.load(std::memory_order_relaxed),
+		.packets_in = stats_.packets_in.load(std::memory_order_relaxed),
+		.packets_out = stats_.packets_out.load(std::memory_order_relaxed),
+		.latency = stats_.latency.load(std::memory_order_relaxed)
+	};
 }
 
 void ClientConnection::latency(std::size_t latency) {
-	stats_.latency = latency;
+	// wraps around when latency decreases, which is fine for unsigned types
+	const auto prev = stats_.latency.load(std::memory_order_relaxed);
+	shard_stats_.latency.fetch_add(latency - prev, std::memory_order_relaxed);
+	stats_.latency.store(latency, std::memory_order_relaxed);
 }
 
+/*
+ * May be called from any thread (QoS adjusts levels from its own timer),
+ * hence the atomic. Takes effect from the next eligible outbound packet.
+ */
 void ClientConnection::compression_level(unsigned int level) {
-	compression_level_ = level;
+	compression_level_ = std::min(level, static_cast<unsigned int>(MAX_COMPRESSION_LEVEL));
+}
+
+unsigned int ClientConnection::compression_level() const {
+	return compression_level_;
+}
+
+const ClientUUID& ClientConnection::uuid() const {
+	return handler_.uuid();
 }
 
 void ClientConnection::terminate() {
@@ -264,16 +404,27 @@ void ClientConnection::async_shutdown(std::shared_ptr<ClientConnection> client)
 }
 
 void ClientConnection::log_packets(bool enable) {
-	// temp - make logger non-ptr and add enable flag?
-	if(enable) {
-		packet_logger_ = std::make_unique<PacketLogger>();
-		packet_logger_->add_sink(std::make_unique<FBSink>("temp", "gateway", remote_address()));
-		packet_logger_->add_sink(
-			std::make_unique<LogSink>(*logger_, log::Severity::INFO, remote_address())
-		);
-	} else {
+	if(!enable) {
 		packet_logger_.reset();
+		return;
 	}
+
+	packet_logger_ = std::make_unique<PacketLogger>();
+
+	// capture mode keeps formatting and disk I/O off of this connection's thread
+	if(auto capture = Locator::capture()) {
+		packet_logger_->add_sink(std::make_unique<CaptureSink>(
+			*capture, uuid().to_string(), "gateway", remote_address()
+		));
+
+		return;
+	}
+
+	// temp - make logger non-ptr and add enable flag?
+	packet_logger_->add_sink(std::make_unique<FBSink>("temp", "gateway", remote_address()));
+	packet_logger_->add_sink(
+		std::make_unique<LogSink>(*logger_, log::Severity::INFO, remote_address())
+	);
 }
 
 } // ember
\ No newline at end of file
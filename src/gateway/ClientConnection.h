@@ -11,7 +11,9 @@
 #include "ClientHandler.h"
 #include "ConnectionStats.h"
 #include "ConnectionDefines.h"
+#include "OutboundQueue.h"
 #include "PacketCrypto.h"
+#include "SharedPacket.h"
 #include "FilterTypes.h"
 #include "packetlog/PacketLogger.h"
 #include "SocketType.h"
@@ -19,6 +21,7 @@
 #include <spark/buffers/DynamicBuffer.h>
 #include <shared/ClientUUID.h>
 #include <shared/memory/ASIOAllocator.h>
+#include <shared/threading/Placement.h>
 #include <botan/bigint.h>
 #include <boost/asio/ip/tcp.hpp>
 #include <array>
@@ -44,19 +47,21 @@ class ClientConnection final {
 	boost::asio::ip::tcp::endpoint remote_ep_;
 
 	StaticBuffer inbound_buffer_{};
-	std::array<DynamicBuffer, 2> outbound_buffers_{};
-	DynamicBuffer* outbound_front_;
-	DynamicBuffer* outbound_back_;
+	std::array<OutboundQueue<DynamicBuffer>, 2> outbound_queues_{};
+	OutboundQueue<DynamicBuffer>* outbound_front_;
+	OutboundQueue<DynamicBuffer>* outbound_back_;
 
 	ClientHandler handler_;
-	ConnectionStats stats_;
+	AtomicConnectionStats stats_;
+	AtomicConnectionStats& shard_stats_;
+	ServiceLoad& load_;
 	std::optional<PacketCrypto> crypt_;
 	protocol::SizeType msg_size_;
 	SessionManager& sessions_;
 	ASIOAllocator<thread_unsafe> allocator_; // todo - should be shared & passed in
 	log::Logger* logger_;
 	bool write_in_progress_;
-	unsigned int compression_level_;
+	std::atomic_uint compression_level_;
 	std::unique_ptr<PacketLogger> packet_logger_;
 
 	std::condition_variable stop_condvar_;
@@ -67,6 +72,11 @@ class ClientConnection final {
 	// socket I/O
 	void read();
 	void write();
+	void queue_write();
+
+	// compression
+	bool send_compressed(const protocol::is_packet auto& packet);
+	bool send_compressed(std::span<const std::uint8_t> payload);
 
 	// session management
 	void stop();
@@ -80,11 +90,14 @@ class ClientConnection final {
 	void completion_check(const StaticBuffer& buffer);
 
 public:
-	ClientConnection(SessionManager& sessions, tcp_socket socket, ClientUUID uuid, log::Logger* logger)
+	ClientConnection(SessionManager& sessions, AtomicConnectionStats& shard_stats,
+	                 ServiceLoad& load, tcp_socket socket, ClientUUID uuid, log::Logger* logger)
 	                 : sessions_(sessions),
 	                   socket_(std::move(socket)),
 	                   remote_ep_(socket_.remote_endpoint()),
 	                   stats_{},
+	                   shard_stats_(shard_stats),
+	                   load_(load),
 	                   msg_size_{0},
 	                   logger_(logger),
 	                   read_state_(ReadState::HEADER),
@@ -92,20 +105,27 @@ public:
 	                   write_in_progress_(false),
 	                   handler_(*this, uuid, socket_.get_executor(), logger),
 	                   compression_level_(0),
-	                   outbound_front_(&outbound_buffers_.front()),
-	                   outbound_back_(&outbound_buffers_.back()), stopping_(false) { }
+	                   outbound_front_(&outbound_queues_.front()),
+	                   outbound_back_(&outbound_queues_.back()), stopping_(false) {
+		load_.connections.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	~ClientConnection();
 
 	void start();
 
 	void set_key(std::span<const std::uint8_t> key);
 	void compression_level(unsigned int level);
+	unsigned int compression_level() const;
 	void latency(std::size_t latency);
 
-	const ConnectionStats& stats() const;
+	ConnectionStats stats() const;
+	const ClientUUID& uuid() const;
 	std::string remote_address() const;
 	void log_packets(bool enable);
 
 	void send(const protocol::is_packet auto& packet);
+	void send(std::shared_ptr<const SharedPacket> packet);
 
 	static void async_shutdown(std::shared_ptr<ClientConnection> client);
 	void close_session(); // should be made private
@@ -9,8 +9,12 @@
 #pragma once
 
 #include <spark/buffers/BinaryStream.h>
+#include <spark/buffers/BufferAdaptor.h>
+#include <boost/container/small_vector.hpp>
 #include <gsl/gsl_util>
 #include <algorithm>
+#include <array>
+#include <cstring>
 
 void ClientConnection::send(const protocol::is_packet auto& packet) {
 	using Type = std::remove_reference_t<decltype(packet)>;
@@ -18,31 +22,45 @@ void ClientConnection::send(const protocol::is_packet auto& packet) {
 	LOG_TRACE_FILTER(logger_, LF_NETWORK) << remote_address() << " <- "
 		<< protocol::to_string(packet.opcode) << LOG_ASYNC;
 
-	spark::io::BinaryStream stream(*outbound_back_);
+	if(packet_logger_) [[unlikely]] {
+		packet_logger_->log(packet, PacketDirection::OUTBOUND);
+	}
+
+	if constexpr(Type::opcode == protocol::ServerOpcode::SMSG_UPDATE_OBJECT) {
+		if(compression_level_ && send_compressed(packet)) {
+			return;
+		}
+	}
+
+	spark::io::BinaryStream stream(outbound_back_->buffer());
 	stream << packet;
 
 	const auto written = stream.total_write();
-	auto size = gsl::narrow<typename Type::SizeType>(written - sizeof(typename Type::SizeType));
-	auto opcode = packet.opcode;
+	const auto size = gsl::narrow<typename Type::SizeType>(written - sizeof(typename Type::SizeType));
+	const auto opcode = packet.opcode;
+
+	std::array<std::uint8_t, Type::HEADER_WIRE_SIZE> header;
+	std::memcpy(header.data(), &size, sizeof(size));
+	std::memcpy(header.data() + sizeof(size), &opcode, sizeof(opcode));
 
 	if(crypt_) [[likely]] {
-		crypt_->encrypt(size);
-		crypt_->encrypt(opcode);
+		crypt_->encrypt(header);
 	}
 
 	stream.write_seek(spark::io::StreamSeek::SK_STREAM_ABSOLUTE, 0);
-	stream << size << opcode;
+	stream.put(header);
 	stream.write_seek(spark::io::StreamSeek::SK_FORWARD, written - Type::HEADER_WIRE_SIZE);
 
-	if(!write_in_progress_) {
-		write_in_progress_ = true;
-		std::swap(outbound_front_, outbound_back_);
-		write();
-	}
-
-	if(packet_logger_) [[unlikely]] {
-		packet_logger_->log(packet, PacketDirection::OUTBOUND);
-	}
+	queue_write();
+	increment(stats_.messages_out);
+	increment(shard_stats_.messages_out);
+	load_.record_traffic(0, 1);
+}
 
-	++stats_.messages_out;
+bool ClientConnection::send_compressed(const protocol::is_packet auto& packet) {
+	boost::container::small_vector<std::uint8_t, COMPRESSION_RESERVE> payload;
+	spark::io::BufferAdaptor adaptor(payload);
+	spark::io::BinaryStream stream(adaptor);
+	packet.write_to_stream(stream);
+	return send_compressed(payload);
 }
\ No newline at end of file
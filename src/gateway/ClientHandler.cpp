@@ -10,6 +10,7 @@
 #include "ClientConnection.h"
 #include "Locator.h"
 #include "EventDispatcher.h"
+#include "Events.h"
 #include "states/StateJumpTables.h"
 #include "FilterTypes.h"
 #include "ClientLogHelper.h"
@@ -27,6 +28,7 @@ void ClientHandler::start() {
 
 void ClientHandler::stop() {
 	Locator::dispatcher()->remove_handler(this);
+	stop_timer();
 	state_update(ClientState::SESSION_CLOSED);
 }
 
@@ -56,11 +58,27 @@ void ClientHandler::handle_message(BinaryStream& stream) {
 }
 
 void ClientHandler::handle_event(const Event* event) {
+	// broadcasts are the same regardless of state, don't bother the state handlers
+	if(event->type == EventType::PACKET_BROADCAST) {
+		handle_broadcast(static_cast<const PacketBroadcast*>(event));
+		return;
+	}
+
 	update_event[context_.state](context_, event);
 }
 
 void ClientHandler::handle_event(std::unique_ptr<const Event> event) {
-	update_event[context_.state](context_, event.get());
+	handle_event(event.get());
+}
+
+// only for clients that have made it through authentication and the queue
+void ClientHandler::handle_broadcast(const PacketBroadcast* event) {
+	if(context_.state == ClientState::AUTHENTICATING
+	   || context_.state == ClientState::SESSION_CLOSED) {
+		return;
+	}
+
+	connection_.send(event->packet);
 }
 
 void ClientHandler::state_update(ClientState new_state) {
@@ -99,18 +117,17 @@ void ClientHandler::handle_ping(BinaryStream& stream) {
 }
 
 void ClientHandler::start_timer(const std::chrono::milliseconds& time) {
-	timer_.expires_from_now(time);
+	timers_.cancel(timer_id_);
 
-	timer_.async_wait([uuid = uuid_](const boost::system::error_code& ec) {
-		if(!ec) {
-			Event event { EventType::TIMER_EXPIRED };
-			Locator::dispatcher()->post_event(uuid, event);
-		}
+	timer_id_ = timers_.schedule(time, [uuid = uuid_] {
+		Event event { EventType::TIMER_EXPIRED };
+		Locator::dispatcher()->post_event(uuid, event);
 	});
 }
 
 void ClientHandler::stop_timer() {
-	timer_.cancel();
+	timers_.cancel(timer_id_);
+	timer_id_ = TimerWheel::INVALID_TIMER;
 }
 
 /*
@@ -143,7 +160,8 @@ ClientHandler::ClientHandler(ClientConnection& connection, ClientUUID uuid,
                                opcode_{},
                                logger_(logger),
                                uuid_(uuid),
-                               timer_(executor) { 
+                               timers_(TimerWheel::get(executor.context())),
+                               timer_id_(TimerWheel::INVALID_TIMER) { 
 	context_.state = context_.prev_state = ClientState::AUTHENTICATING;
 	context_.connection = &connection_;
 	context_.handler = this;
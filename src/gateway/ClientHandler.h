@@ -16,7 +16,7 @@
 #include <spark/buffers/BinaryStream.h>
 #include <logger/LoggerFwd.h>
 #include <shared/ClientUUID.h>
-#include <boost/asio/steady_timer.hpp>
+#include <shared/threading/TimerWheel.h>
 #include <boost/uuid/uuid.hpp>
 #include <concepts>
 #include <chrono>
@@ -28,12 +28,14 @@
 namespace ember {
 
 class ClientConnection;
+struct PacketBroadcast;
 
 class ClientHandler final {
 	ClientConnection& connection_;
 	ClientContext context_;
 	const ClientUUID uuid_;
-	boost::asio::steady_timer timer_;
+	TimerWheel& timers_;
+	TimerWheel::TimerID timer_id_;
 	protocol::ClientOpcode opcode_;
 	log::Logger* logger_;
 
@@ -41,6 +43,7 @@ class ClientHandler final {
 	mutable std::string client_id_ext_;
 
 	void handle_ping(BinaryStream& stream);
+	void handle_broadcast(const PacketBroadcast* event);
 
 public:
 	ClientHandler(ClientConnection& connection, ClientUUID uuid,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018 Ember
+ * Copyright (c) 2018 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,66 +7,96 @@
  */
 
 #include "CompressMessage.h"
-#include <spark/buffers/pmr/BinaryStream.h>
-#include <spark/buffers/DynamicBuffer.h>
+#include <boost/endian/conversion.hpp>
+#include <gsl/gsl_util>
 #include <zlib.h>
-#include <cstdint>
-#include <cstddef>
+#include <vector>
+
+namespace be = boost::endian;
 
 namespace ember {
 
-/*
- * To think about: state of the buffers if compression fails.
- * Use temporary buffers to avoid a bad state?
- */
-int compress_message(const spark::io::pmr::Buffer& in, spark::io::pmr::Buffer& out, int compression_level) {
-	return Z_ERRNO;
-}
+namespace {
 
-// temp testing function, do not use yet
-int compress_message(const auto& packet, spark::io::pmr::Buffer& out, int compression_level) {
-	constexpr std::size_t BLOCK_SIZE = 64;
-	spark::io::DynamicBuffer<4096> temp_buffer;
-	spark::io::pmr::BinaryStream stream(temp_buffer);
-	spark::io::pmr::BinaryStream out_stream(out);
+class DeflateContext final {
+	z_stream stream_{};
+	int level_ = Z_DEFAULT_COMPRESSION;
+	bool initialised_ = false;
 
-	std::uint8_t in_buff[BLOCK_SIZE];
-	std::uint8_t out_buff[BLOCK_SIZE];
+public:
+	DeflateContext() = default;
+	DeflateContext(const DeflateContext&) = delete;
+	DeflateContext& operator=(const DeflateContext&) = delete;
 
-	z_stream z_stream{};
-	z_stream.next_in = in_buff;
-	z_stream.next_out = out_buff;
-	deflateInit(&z_stream, compression_level);
+	// Resets the stream for a new message, only initialising it on first use
+	int prepare(const int level) {
+		if(!initialised_) {
+			const auto ret = deflateInit(&stream_, level);
 
-	stream << packet->opcode << packet;
-	out_stream << std::uint16_t(0) << protocol::ServerOpcode::SMSG_COMPRESSED_UPDATE_OBJECT;
+			if(ret == Z_OK) {
+				initialised_ = true;
+				level_ = level;
+			}
 
-	while(!stream.empty()) {
-		z_stream.avail_in = stream.size() >= BLOCK_SIZE? BLOCK_SIZE : stream.size();
-		stream.get(in_buff, z_stream.avail_in);
+			return ret;
+		}
 
-		const auto flush = stream.empty()? Z_FINISH : Z_NO_FLUSH;
+		if(const auto ret = deflateReset(&stream_); ret != Z_OK) {
+			return ret;
+		}
 
-		do {
-			z_stream.avail_out = BLOCK_SIZE;
-			const int ret = deflate(&z_stream, flush);
+		// no pending input after a reset, so this is just a settings change
+		if(level != level_) {
+			const auto ret = deflateParams(&stream_, level, Z_DEFAULT_STRATEGY);
 
-			if(ret != Z_OK && ret != Z_STREAM_END) {
+			if(ret != Z_OK) {
 				return ret;
 			}
 
-			out.write(out_buff, BLOCK_SIZE - z_stream.avail_out);
+			level_ = level;
+		}
 
-			if(flush == Z_FINISH && ret == Z_OK) {
-				continue;
-			}
-		} while(z_stream.avail_out == 0);
+		return Z_OK;
+	}
+
+	z_stream* get() {
+		return &stream_;
+	}
+
+	~DeflateContext() {
+		if(initialised_) {
+			deflateEnd(&stream_);
+		}
+	}
+};
+
+thread_local DeflateContext deflate_ctx;
+thread_local std::vector<std::uint8_t> scratch;
+
+} // unnamed
+
+int compress_message(std::span<const std::uint8_t> in, spark::io::pmr::Buffer& out, const int compression_level) {
+	if(const auto ret = deflate_ctx.prepare(compression_level); ret != Z_OK) {
+		return ret;
+	}
+
+	auto stream = deflate_ctx.get();
+	scratch.resize(deflateBound(stream, gsl::narrow<uLong>(in.size())));
 
+	stream->next_in = const_cast<Bytef*>(in.data());
+	stream->avail_in = gsl::narrow<uInt>(in.size());
+	stream->next_out = scratch.data();
+	stream->avail_out = gsl::narrow<uInt>(scratch.size());
 
-		out.write(out_buff, BLOCK_SIZE - z_stream.avail_out);
+	// output is bounded, so everything should be flushed in one call
+	if(const auto ret = deflate(stream, Z_FINISH); ret != Z_STREAM_END) {
+		return ret == Z_OK? Z_BUF_ERROR : ret;
 	}
 
-	return deflateEnd(&z_stream);
+	const auto size = be::native_to_little(gsl::narrow<std::uint32_t>(in.size()));
+	out.write(&size, sizeof(size));
+	out.write(scratch.data(), stream->total_out);
+	return Z_OK;
 }
 
-} // ember
\ No newline at end of file
+} // ember
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018 Ember
+ * Copyright (c) 2018 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,13 +8,25 @@
 
 #pragma once
 
-#include <protocol/Packets.h>
 #include <spark/buffers/pmr/Buffer.h>
+#include <span>
+#include <cstddef>
+#include <cstdint>
 
 namespace ember {
 
-template<typename Packet_t>
-int compress_message(const Packet_t& packet, spark::io::pmr::Buffer& out, int compression_level);
-int compress_message(const spark::io::pmr::Buffer& in, spark::io::pmr::Buffer& out, int compression_level);
+// Payloads smaller than this aren't worth the CPU time (or zlib's overhead)
+constexpr std::size_t COMPRESSION_THRESHOLD = 128;
+constexpr int MAX_COMPRESSION_LEVEL = 9;
 
-} // ember
\ No newline at end of file
+/*
+ * Writes the body of an SMSG_COMPRESSED_UPDATE_OBJECT (uncompressed size
+ * followed by the zlib stream) for the given payload. Each thread reuses
+ * a single deflate context, so there's no per-message deflateInit cost.
+ * 
+ * Nothing is written to the output buffer unless compression succeeds,
+ * in which case Z_OK is returned.
+ */
+int compress_message(std::span<const std::uint8_t> in, spark::io::pmr::Buffer& out, int compression_level);
+
+} // ember
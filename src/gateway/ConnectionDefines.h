@@ -17,6 +17,9 @@ namespace ember {
 
 static constexpr auto INBOUND_SIZE  { 1024 };
 static constexpr auto OUTBOUND_SIZE { 2048 };
+static constexpr auto GATHER_HINT { 16 };
+static constexpr auto MAX_GATHER_BUFFERS { 64 };
+static constexpr auto COMPRESSION_RESERVE { 1024 };
 
 #if defined TARGET_PLAYER_COUNT && defined TARGET_WORKER_COUNT
 static constexpr std::size_t PREALLOC_NODES {  TARGET_PLAYER_COUNT / TARGET_WORKER_COUNT };
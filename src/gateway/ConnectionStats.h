@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016 Ember
+ * Copyright (c) 2016 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 
 namespace ember {
@@ -22,4 +23,27 @@ struct ConnectionStats {
 	std::size_t latency;
 };
 
-} // ember
\ No newline at end of file
+/*
+ * Running totals for a single connection or for every connection
+ * belonging to a session shard. The traffic counters are cumulative and
+ * only written by the thread that runs the shard's io_context, whereas
+ * a shard's latency (the sum of the current latencies) and sessions may
+ * be adjusted from any thread.
+ */
+struct AtomicConnectionStats {
+	std::atomic_size_t bytes_in;
+	std::atomic_size_t bytes_out;
+	std::atomic_size_t messages_in;
+	std::atomic_size_t messages_out;
+	std::atomic_size_t packets_in;
+	std::atomic_size_t packets_out;
+	std::atomic_size_t latency;
+	std::atomic_size_t sessions;
+};
+
+// single writer, so there's no need for a locked read-modify-write
+inline void increment(std::atomic_size_t& counter, const std::size_t value = 1) {
+	counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // ember
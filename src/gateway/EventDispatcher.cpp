@@ -60,7 +60,7 @@ void EventDispatcher::broadcast_event(std::vector<ClientUUID> clients,
 		}
 
 		const auto range = std::ranges::equal_range(
-			*clients_ptr, uuid.service(), std::ranges::greater{}, &ClientUUID::service
+			*clients_ptr, uuid.service(), std::ranges::less{}, &ClientUUID::service
 		);
 
 		auto& service = pool_.get(i);
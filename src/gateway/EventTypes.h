@@ -20,6 +20,7 @@ enum class EventType {
 	CHAR_ENUM_RESPONSE,
 	CHAR_RENAME_RESPONSE,
 	PLAYER_LOGIN,
+	PACKET_BROADCAST,
 	TIMER_EXPIRED
 };
 
@@ -9,12 +9,16 @@
 #pragma once
 
 #include "Event.h"
+#include "SharedPacket.h"
 #include "Account_generated.h"
 #include "Character_generated.h"
 #include <protocol/ResultCodes.h>
 #include <protocol/Packets.h>
 #include <shared/database/objects/Character.h>
+#include <shared/ClientUUID.h>
+#include <boost/unordered/unordered_flat_map.hpp>
 #include <botan/bigint.h>
+#include <memory>
 #include <vector>
 #include <utility>
 #include <cstdint>
@@ -30,12 +34,30 @@ struct PlayerLogin : Event {
 	const std::uint64_t character_id_;
 };
 
+/*
+ * A single instance is broadcast to every client whose queue position
+ * has changed, with each client looking up its own position
+ */
 struct QueuePosition : Event {
-	explicit QueuePosition(std::size_t position)	
+	using Positions = boost::unordered_flat_map<ClientUUID, std::size_t, boost::hash<ClientUUID>>;
+
+	explicit QueuePosition(Positions positions)
 		: Event { EventType::QUEUE_UPDATE_POSITION },
-	      position(position) { }
+	      positions(std::move(positions)) { }
+
+	Positions positions;
+};
+
+/*
+ * The packet is serialised once and queued as-is on every recipient's
+ * connection, which only writes and encrypts its own copy of the header
+ */
+struct PacketBroadcast : Event {
+	explicit PacketBroadcast(std::shared_ptr<const SharedPacket> packet)
+		: Event { EventType::PACKET_BROADCAST },
+	      packet(std::move(packet)) { }
 
-	std::size_t position;
+	std::shared_ptr<const SharedPacket> packet;
 };
 
 struct AccountIDResponse : Event {
@@ -16,5 +16,6 @@ AccountClient* Locator::account_;
 RealmService* Locator::realm_;
 RealmQueue* Locator::queue_;
 Config* Locator::config_;
+PacketCapture* Locator::capture_;
 
 } // ember
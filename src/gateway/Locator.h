@@ -15,6 +15,7 @@ class CharacterClient;
 class AccountClient;
 class RealmService;
 class RealmQueue;
+class PacketCapture;
 struct Config;
 
 class Locator {
@@ -24,6 +25,7 @@ class Locator {
 	static RealmService* realm_;
 	static RealmQueue* queue_;
 	static Config* config_;
+	static PacketCapture* capture_;
 
 public:
 	static void set(Config* config) { config_ = config; }
@@ -32,6 +34,7 @@ public:
 	static void set(AccountClient* account) { account_ = account; }
 	static void set(CharacterClient* character) { character_ = character; }
 	static void set(EventDispatcher* dispatcher) { dispatcher_ = dispatcher; }
+	static void set(PacketCapture* capture) { capture_ = capture; }
 
 	static Config* config() { return config_; }
 	static RealmQueue* queue() { return queue_; }
@@ -39,6 +42,7 @@ public:
 	static AccountClient* account() { return account_; }
 	static CharacterClient* character() { return character_; }
 	static EventDispatcher* dispatcher() { return dispatcher_; }
+	static PacketCapture* capture() { return capture_; }
 };
 
 } // ember
\ No newline at end of file
@@ -10,34 +10,77 @@
 #include <logger/Logger.h>
 #include "FilterTypes.h"
 #include "ClientConnection.h"
+#include <shared/util/ReusePort.h>
+#include <boost/asio/post.hpp>
 #include <memory>
 #include <utility>
 
 namespace ember {
 
-void NetworkListener::accept_connection() {
+NetworkListener::NetworkListener(ServicePool& pool, const std::string& interface, const std::uint16_t port,
+                                 const bool tcp_no_delay, const bool reuse_port, const ServerConfig& config,
+                                 log::Logger* logger)
+                                 : sessions_(pool.size()),
+                                   pool_(pool),
+                                   reuse_port_(reuse_port),
+                                   config_(config),
+                                   logger_(logger) {
+	bai::tcp::endpoint endpoint(bai::address::from_string(interface), port);
+	const auto count = reuse_port? pool.size() : 1;
+
+	for(std::size_t i = 0; i < count; ++i) {
+		const auto index = reuse_port? i : pool.next();
+		auto& service = reuse_port? pool.get(i) : pool.get();
+
+		auto& acceptor = acceptors_.emplace_back(std::make_unique<Acceptor>(
+			tcp_acceptor(service), tcp_socket(pool.get(index)), index
+		));
+
+		util::listen(acceptor->acceptor, endpoint, reuse_port);
+		acceptor->acceptor.set_option(bai::tcp::no_delay(tcp_no_delay));
+
+		// if the port was chosen by the OS, the others need to share it
+		endpoint = acceptor->acceptor.local_endpoint();
+	}
+
+	// the pool is already running, so the accept loops start on the threads they'll stay on
+	for(auto& acceptor : acceptors_) {
+		boost::asio::post(acceptor->acceptor.get_executor(), [this, ptr = acceptor.get()] {
+			accept_connection(*ptr);
+		});
+	}
+}
+
+void NetworkListener::accept_connection(Acceptor& acceptor) {
 	LOG_TRACE_FILTER(logger_, LF_NETWORK) << log_func << LOG_ASYNC;
 
-	if(!acceptor_.is_open()) {
+	if(!acceptor.acceptor.is_open()) {
 		return;
 	}
 
-	acceptor_.async_accept(socket_, [this](boost::system::error_code ec) {
+	acceptor.acceptor.async_accept(acceptor.socket, [this, &acceptor](boost::system::error_code ec) {
 		if(ec == boost::asio::error::operation_aborted) {
 			return;
 		}
 
+		auto& socket = acceptor.socket;
+
 		if(!ec) {
-			const auto ep = socket_.remote_endpoint(ec);
+			const auto ep = socket.remote_endpoint(ec);
 
 			if(!ec) {
 				LOG_DEBUG_FILTER(logger_, LF_NETWORK)
 					<< "Accepted connection " << ep.address().to_string() << LOG_ASYNC;
 
+				const auto uuid = ClientUUID::generate(acceptor.index);
+
 				auto client = std::make_unique<ClientConnection>(
-					sessions_, std::move(socket_), ClientUUID::generate(index_), logger_
+					sessions_, sessions_.shard_stats(uuid), pool_.load(acceptor.index),
+					std::move(socket), uuid, logger_
 				);
 
+				// QoS may raise this later but never goes below the configured level
+				client->compression_level(config_.compression_level);
 				sessions_.start(std::move(client));
 			} else {
 				LOG_DEBUG_FILTER(logger_, LF_NETWORK)
@@ -45,21 +88,31 @@ void NetworkListener::accept_connection() {
 			}
 		}
 
-		++index_;
-		index_ %= pool_.size();
-		socket_ = tcp_socket(pool_.get(index_));
-		accept_connection();
+		// with SO_REUSEPORT, each acceptor sticks to its own io_context
+		if(!reuse_port_) {
+			acceptor.index = pool_.next();
+		}
+
+		socket = tcp_socket(pool_.get(acceptor.index));
+		accept_connection(acceptor);
 	});
 }
 
 void NetworkListener::shutdown() {
 	LOG_TRACE_FILTER(logger_, LF_NETWORK) << log_func << LOG_ASYNC;
-	acceptor_.close();
+	for(auto& acceptor : acceptors_) {
+		acceptor->acceptor.close();
+	}
+
 	sessions_.stop_all();
 }
 
+SessionManager& NetworkListener::sessions() {
+	return sessions_;
+}
+
 std::uint16_t NetworkListener::port() const {
-	return acceptor_.local_endpoint().port();
+	return acceptors_.front()->acceptor.local_endpoint().port();
 }
 
 } // ember
\ No newline at end of file
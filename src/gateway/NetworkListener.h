@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "ServerConfig.h"
 #include "SessionManager.h"
 #include "SocketType.h"
 #include <logger/LoggerFwd.h>
@@ -16,43 +17,48 @@
 #include <shared/threading/ServicePool.h>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <memory>
 #include <string>
+#include <vector>
 #include <cstddef>
 
 namespace ember {
 
 namespace bai = boost::asio::ip;
 
+/*
+ * By default, a single acceptor hands out new connections to io_contexts
+ * according to the pool's placement policy. With reuse_port, there's an
+ * SO_REUSEPORT acceptor on every io_context, letting the kernel spread
+ * incoming connections between them. Each acceptor then accepts and
+ * builds sessions on its own thread, so a reconnect storm isn't funnelled
+ * through one thread, at the cost of bypassing the placement policy.
+ */
 class NetworkListener final {
 	using tcp_acceptor = boost::asio::basic_socket_acceptor<
 		boost::asio::ip::tcp, boost::asio::io_context::executor_type>;
 
+	struct Acceptor {
+		tcp_acceptor acceptor;
+		tcp_socket socket;
+		std::size_t index; // service the socket belongs to
+	};
+
 	SessionManager sessions_;
-	tcp_acceptor acceptor_;
 	ServicePool& pool_;
-	std::size_t index_;
-	tcp_socket socket_;
+	const bool reuse_port_;
+	const ServerConfig& config_;
+	std::vector<std::unique_ptr<Acceptor>> acceptors_;
 	log::Logger* logger_;
 
-	void accept_connection();
+	void accept_connection(Acceptor& acceptor);
 
 public:
 	NetworkListener(ServicePool& pool, const std::string& interface, std::uint16_t port,
-	                bool tcp_no_delay, log::Logger* logger)
-	                : acceptor_(
-	                      pool.get(), 
-	                      bai::tcp::endpoint(bai::address::from_string(interface), port)
-	                  ),
-	                  pool_(pool),
-	                  index_(0),
-	                  socket_(pool.get(0)),
-	                  logger_(logger) {
-		acceptor_.set_option(bai::tcp::no_delay(tcp_no_delay));
-		acceptor_.set_option(bai::tcp::acceptor::reuse_address(true));
-		accept_connection();
-	}
+	                bool tcp_no_delay, bool reuse_port, const ServerConfig& config, log::Logger* logger);
 
 	std::uint16_t port() const;
+	SessionManager& sessions();
 	void shutdown();
 };
 
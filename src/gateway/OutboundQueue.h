@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "SharedPacket.h"
+#include <spark/buffers/BufferSequence.h>
+#include <boost/asio/buffer.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+namespace ember {
+
+/*
+ * Outbound byte stream made up of connection-owned data (written into
+ * the buffer) interleaved with payloads of shared packets, which are
+ * referenced rather than copied. Each attachment records how many
+ * buffer bytes had been written before it so the two can be stitched
+ * back together, in order, when building the gather list for a send.
+ */
+template<typename BufferType>
+class OutboundQueue final {
+	struct Attachment {
+		std::size_t position;
+		std::shared_ptr<const SharedPacket> packet;
+	};
+
+	BufferType buffer_;
+	std::deque<Attachment> attachments_;
+	std::size_t read_ = 0;
+	std::size_t attachment_read_ = 0;
+
+public:
+	BufferType& buffer() {
+		return buffer_;
+	}
+
+	/*
+	 * Queues the payload of a shared packet after everything currently
+	 * in the buffer. The caller is responsible for writing the header first.
+	 */
+	void attach(std::shared_ptr<const SharedPacket> packet) {
+		if(packet->payload().empty()) {
+			return;
+		}
+
+		attachments_.emplace_back(read_ + buffer_.size(), std::move(packet));
+	}
+
+	/*
+	 * Appends up to max_buffers const_buffers describing the queued data,
+	 * in wire order, to the container. Nothing is copied.
+	 */
+	void gather(auto& out, const std::size_t max_buffers) const {
+		const spark::io::BufferSequence sequence(buffer_);
+		auto node = sequence.begin();
+		boost::asio::const_buffer chunk;
+		std::size_t position = read_;
+
+		auto emit_until = [&](const std::size_t target) {
+			while(position < target && out.size() < max_buffers) {
+				if(!chunk.size()) {
+					chunk = *node++;
+					continue;
+				}
+
+				const auto length = std::min(chunk.size(), target - position);
+				out.emplace_back(chunk.data(), length);
+				chunk += length;
+				position += length;
+			}
+		};
+
+		auto offset = attachment_read_;
+
+		for(const auto& [at, packet] : attachments_) {
+			emit_until(at);
+
+			if(out.size() >= max_buffers) {
+				return;
+			}
+
+			const auto payload = packet->payload().subspan(offset);
+			out.emplace_back(payload.data(), payload.size());
+			offset = 0;
+		}
+
+		emit_until(read_ + buffer_.size());
+	}
+
+	// Discards bytes from the front of the queue once they've been sent
+	void consume(std::size_t bytes) {
+		BOOST_ASSERT_MSG(bytes <= size(), "Consumed more than was queued");
+
+		while(bytes) {
+			if(!attachments_.empty() && attachments_.front().position == read_) {
+				const auto payload_size = attachments_.front().packet->payload().size();
+				const auto length = std::min(bytes, payload_size - attachment_read_);
+				attachment_read_ += length;
+				bytes -= length;
+
+				if(attachment_read_ == payload_size) {
+					attachments_.pop_front();
+					attachment_read_ = 0;
+				}
+
+				continue;
+			}
+
+			const auto limit = attachments_.empty()?
+				buffer_.size() : attachments_.front().position - read_;
+			const auto length = std::min(bytes, limit);
+			buffer_.skip(length);
+			read_ += length;
+			bytes -= length;
+		}
+	}
+
+	std::size_t size() const {
+		std::size_t size = buffer_.size();
+
+		for(const auto& attachment : attachments_) {
+			size += attachment.packet->payload().size();
+		}
+
+		return size - attachment_read_;
+	}
+
+	[[nodiscard]]
+	bool empty() const {
+		return buffer_.empty() && attachments_.empty();
+	}
+};
+
+} // ember
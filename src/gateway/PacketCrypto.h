@@ -9,35 +9,64 @@
 #pragma once
 
 #include <spark/buffers/pmr/Buffer.h>
-#include <gsl/gsl_util>
 #include <botan/bigint.h>
 #include <boost/assert.hpp>
 #include <boost/container/small_vector.hpp>
+#include <algorithm>
 #include <array>
+#include <limits>
+#include <ranges>
 #include <span>
+#include <type_traits>
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
 
 namespace ember {
 
+/*
+ * The key is stored twice, back to back, so any run of up to key_size_
+ * bytes can be processed against a contiguous slice of the key stream
+ * starting at the current index. This removes the per-byte modulo and
+ * leaves a single wrap check per run rather than per byte.
+ *
+ * Encryption chains each output byte into the next, so it's inherently
+ * serial. Decryption only depends on the ciphertext, so the loop has no
+ * carried dependency and is left in a form the compiler can vectorise.
+ */
 class PacketCrypto final {
 	static constexpr auto KEY_SIZE_HINT = 40u;
 
-	boost::container::small_vector<std::uint8_t, KEY_SIZE_HINT> key_;
-	std::uint8_t send_i_ = 0;
+	boost::container::small_vector<std::uint8_t, KEY_SIZE_HINT * 2> key_stream_;
+	std::size_t key_size_ = 0;
+	std::size_t send_i_ = 0;
+	std::size_t recv_i_ = 0;
 	std::uint8_t send_j_ = 0;
-	std::uint8_t recv_i_ = 0;
 	std::uint8_t recv_j_ = 0;
 
+	void expand_key() {
+		BOOST_ASSERT_MSG(!key_stream_.empty(), "Session key is empty");
+		key_size_ = key_stream_.size();
+		key_stream_.insert(key_stream_.end(), key_stream_.begin(), key_stream_.end());
+	}
+
+	void advance(std::size_t& index, const std::size_t run) const {
+		index += run;
+
+		if(index >= key_size_) {
+			index -= key_size_;
+		}
+	}
+
 public:
 	explicit PacketCrypto(std::span<const std::uint8_t> key) {
-		key_.assign(key.begin(), key.end());
-
 		BOOST_ASSERT_MSG(
 			key.size() <= std::numeric_limits<std::uint8_t>::max(),
 			"Session key too big"
 		);
+
+		key_stream_.assign(key.begin(), key.end());
+		expand_key();
 	}
 
 	explicit PacketCrypto(const Botan::BigInt& key) {
@@ -46,34 +75,76 @@ public:
 			"Session key too big"
 		);
 
-		key_.resize(key.bytes(), boost::container::default_init);
-		key.binary_encode(key_.data(), key_.size());
+		key_stream_.resize(key.bytes(), boost::container::default_init);
+		key.binary_encode(key_stream_.data(), key_stream_.size());
+		expand_key();
 	}
 
-	void encrypt(auto& data) {
-		auto d_bytes = reinterpret_cast<std::uint8_t*>(&data);
-		const auto key_size = gsl::narrow_cast<std::uint8_t>(key_.size());
-	
-		for(std::size_t t = 0; t < sizeof(data); ++t) {
-			send_i_ %= key_size;
-			std::uint8_t x = (d_bytes[t] ^ key_[send_i_]) + send_j_;
-			++send_i_;
-			d_bytes[t] = send_j_ = x;
+	/*
+	 * Encrypts a run of bytes as though each had been passed in
+	 * individually, in order. Headers for several queued packets can
+	 * be laid out contiguously and encrypted with a single call.
+	 */
+	void encrypt(std::span<std::uint8_t> data) {
+		auto bytes = data.data();
+		auto remaining = data.size();
+
+		while(remaining) {
+			const auto run = std::min(remaining, key_size_);
+			const auto key = &key_stream_[send_i_];
+			auto j = send_j_;
+
+			for(std::size_t t = 0; t < run; ++t) {
+				j = bytes[t] = (bytes[t] ^ key[t]) + j;
+			}
+
+			send_j_ = j;
+			advance(send_i_, run);
+			bytes += run;
+			remaining -= run;
 		}
 	}
 
-	void decrypt(auto& data, const std::size_t length) {
-		const auto key_size = gsl::narrow_cast<std::uint8_t>(key_.size());
-
-		for(std::size_t t = 0; t < length; ++t) {
-			recv_i_ %= key_size;
-			auto& byte = reinterpret_cast<char&>(data[t]);
-			std::uint8_t x = (byte - recv_j_) ^ key_[recv_i_];
-			++recv_i_;
-			recv_j_ = byte;
-			byte = x;
+	void decrypt(std::span<std::uint8_t> data) {
+		auto bytes = data.data();
+		auto remaining = data.size();
+
+		while(remaining) {
+			const auto run = std::min(remaining, key_size_);
+			const auto key = &key_stream_[recv_i_];
+			const auto last = bytes[run - 1];
+
+			// walk backwards so each byte's predecessor is still ciphertext
+			for(std::size_t t = run - 1; t > 0; --t) {
+				bytes[t] = static_cast<std::uint8_t>(bytes[t] - bytes[t - 1]) ^ key[t];
+			}
+
+			bytes[0] = static_cast<std::uint8_t>(bytes[0] - recv_j_) ^ key[0];
+			recv_j_ = last;
+			advance(recv_i_, run);
+			bytes += run;
+			remaining -= run;
 		}
 	}
+
+	template<std::size_t size>
+	void encrypt(std::span<std::array<std::uint8_t, size>> headers) {
+		encrypt(std::span(reinterpret_cast<std::uint8_t*>(headers.data()), headers.size_bytes()));
+	}
+
+	template<std::size_t size>
+	void decrypt(std::span<std::array<std::uint8_t, size>> headers) {
+		decrypt(std::span(reinterpret_cast<std::uint8_t*>(headers.data()), headers.size_bytes()));
+	}
+
+	template<typename T>
+	void encrypt(T& data) requires(std::is_trivially_copyable_v<T> && !std::ranges::range<T>) {
+		encrypt(std::span(reinterpret_cast<std::uint8_t*>(&data), sizeof(data)));
+	}
+
+	void decrypt(auto& data, const std::size_t length) {
+		decrypt(std::span(reinterpret_cast<std::uint8_t*>(data.data()), length));
+	}
 };
 
-} // ember
\ No newline at end of file
+} // ember
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016 - 2019 Ember
+ * Copyright (c) 2016 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,35 +10,72 @@
 #include "ServerConfig.h"
 #include "SessionManager.h"
 #include "ConnectionStats.h"
+#include "CompressMessage.h"
+#include <algorithm>
 
 namespace ember {
 
+void QoS::start() {
+	// no limit configured, nothing to manage
+	if(!config_.max_bandwidth_out) {
+		return;
+	}
+
+	last_bandwidth_out_ = sessions_.aggregate_stats().bytes_out;
+	set_timer();
+}
+
 void QoS::set_timer() {
 	timer_.expires_from_now(TIMER_FREQUENCY);
 	timer_.async_wait([this](const boost::system::error_code& ec) {
 		if(!ec) { // if ec is set, the timer was aborted (shutdown)
 			measure_bandwidth();
+			set_timer();
 		}
 	});
 }
 
 void QoS::measure_bandwidth() {
-	auto stats = sessions_.aggregate_stats();
-	auto timer_ms = std::chrono::duration_cast<std::chrono::milliseconds>(TIMER_FREQUENCY);
-	auto seconds = timer_ms.count() / 1000.0;
+	const auto stats = sessions_.aggregate_stats();
+	const auto seconds = std::chrono::duration<double>(TIMER_FREQUENCY).count();
+	const auto out_per_sec = (stats.bytes_out - last_bandwidth_out_) / seconds;
+	last_bandwidth_out_ = stats.bytes_out;
 
-	auto out_per_sec = (stats.bytes_out - last_bandwidth_out_) / seconds;
-	auto target_bandwidth = (config_.max_bandwidth_out / 100.0) * MAX_BANDWIDTH_PERCENTAGE;
+	const auto upper_bandwidth = (config_.max_bandwidth_out / 100.0) * UPPER_WATERMARK;
+	const auto lower_bandwidth = (config_.max_bandwidth_out / 100.0) * LOWER_WATERMARK;
+	const auto clients = std::max<std::size_t>(sessions_.count(), 1);
+	const auto fair_share = upper_bandwidth / clients;
+	const auto base_level = std::min(config_.compression_level,
+	                                 static_cast<unsigned int>(MAX_COMPRESSION_LEVEL));
 
-	if(out_per_sec > target_bandwidth) {
-		// bump up the compression level
-	}
+	BandwidthMap current;
+	current.reserve(last_client_out_.size());
 
-	last_bandwidth_out_ = stats.bytes_out;
+	sessions_.for_each([&](ClientConnection& client) {
+		const auto bytes_out = client.stats().bytes_out;
+		const auto it = last_client_out_.find(client.uuid());
+		const auto prev_bytes_out = it == last_client_out_.end()? bytes_out : it->second;
+		const auto client_per_sec = (bytes_out - prev_bytes_out) / seconds;
+		current.emplace(client.uuid(), bytes_out);
+
+		auto level = std::max(client.compression_level(), base_level);
+
+		if(out_per_sec > upper_bandwidth) {
+			if(client_per_sec > fair_share && level < MAX_COMPRESSION_LEVEL) {
+				++level;
+			}
+		} else if(out_per_sec < lower_bandwidth && level > base_level) {
+			--level;
+		}
+
+		client.compression_level(level);
+	});
+
+	last_client_out_.swap(current);
 }
 
 void QoS::shutdown() {
-	
+	timer_.cancel();
 }
 
-} // ember
\ No newline at end of file
+} // ember
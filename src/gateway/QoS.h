@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016 - 2020 Ember
+ * Copyright (c) 2016 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,34 +8,48 @@
 
 #pragma once
 
+#include <shared/ClientUUID.h>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
 #include <chrono>
+#include <cstddef>
 
 namespace ember {
 
 struct ServerConfig;
 class SessionManager;
 
-class QoS {
-	const std::chrono::seconds TIMER_FREQUENCY { 120 };
-	const unsigned int MAX_BANDWIDTH_PERCENTAGE { 80 };
+/*
+ * Periodically measures outbound bandwidth and adjusts per-connection
+ * compression levels to keep it under the configured limit. When the
+ * gateway is above the upper watermark, connections using more than
+ * their fair share have their level raised. Once it's back below the
+ * lower watermark, levels are relaxed back towards the configured base.
+ */
+class QoS final {
+	static constexpr std::chrono::seconds TIMER_FREQUENCY { 5 };
+	static constexpr unsigned int UPPER_WATERMARK { 80 }; // percentage of max bandwidth
+	static constexpr unsigned int LOWER_WATERMARK { 60 };
+
+	using BandwidthMap = boost::unordered_flat_map<ClientUUID, std::size_t, boost::hash<ClientUUID>>;
 
-	const SessionManager& sessions_;
-	const ServerConfig& config_;	
-	boost::asio::io_context& service_;
+	SessionManager& sessions_;
+	const ServerConfig& config_;
 	boost::asio::steady_timer timer_;
 
 	std::size_t last_bandwidth_out_;
+	BandwidthMap last_client_out_;
 
 	void set_timer();
 	void measure_bandwidth();
 
 public:
-	QoS(const ServerConfig& config, const SessionManager& sessions, boost::asio::io_context& service)
-		: sessions_(sessions), config_(config), service_(service), timer_(service), last_bandwidth_out_(0) { }
+	QoS(const ServerConfig& config, SessionManager& sessions, boost::asio::io_context& service)
+		: sessions_(sessions), config_(config), timer_(service), last_bandwidth_out_(0) { }
 
+	void start();
 	void shutdown();
 };
 
-} // ember
\ No newline at end of file
+} // ember
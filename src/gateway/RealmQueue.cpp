@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016 - 2020 Ember
+ * Copyright (c) 2016 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,7 +10,13 @@
 
 namespace ember {
 
+// must be called with the lock held
 void RealmQueue::set_timer() {
+	if(timer_active_) {
+		return;
+	}
+
+	timer_active_ = true;
 	timer_.expires_from_now(frequency_);
 	timer_.async_wait([this](const boost::system::error_code& ec) {
 		if(!ec) { // if ec is set, the timer was aborted (shutdown)
@@ -26,37 +32,138 @@ void RealmQueue::set_timer() {
  * are changing rapidly
  */
 void RealmQueue::update_clients() {
-	std::lock_guard guard(lock_);
+	Positions positions;
 
-	if(!dirty_) {
-		return;
+	{
+		std::lock_guard guard(lock_);
+		timer_active_ = false;
+
+		if(resume_) {
+			positions = changed_positions();
+		}
+
+		if(!index_.empty()) {
+			set_timer();
+		}
+	}
+
+	if(!positions.empty()) {
+		on_update_(std::move(positions));
+	}
+}
+
+// must be called with the lock held
+std::optional<RealmQueue::Handle> RealmQueue::next(Handle handle) {
+	if(++handle.entry != handle.level->second.end()) {
+		return handle;
 	}
 
-	std::size_t position = 1;
+	if(++handle.level != levels_.end()) {
+		return Handle{ handle.level, handle.level->second.begin() };
+	}
+
+	return std::nullopt;
+}
+
+// must be called with the lock held
+bool RealmQueue::is_resume(const Handle& handle) const {
+	return resume_ && resume_->level == handle.level && resume_->entry == handle.entry;
+}
+
+/*
+ * Entries ahead of the resume point haven't moved since the last update,
+ * so their notified position is their current one. Anything at or past
+ * the resume point is either new (never notified) or was notified of a
+ * position at least as far back as the resume point.
+ * 
+ * Must be called with the lock held
+ */
+bool RealmQueue::before_resume(const QueueEntry& entry) const {
+	return entry.notified_position && entry.notified_position < resume_position_;
+}
+
+// must be called with the lock held
+void RealmQueue::mark_changed(const Handle& handle, const std::size_t position) {
+	if(position <= resume_position_) {
+		resume_ = handle;
+		resume_position_ = position;
+	}
+}
+
+// must be called with the lock held
+RealmQueue::Positions RealmQueue::changed_positions() {
+	Positions positions;
+	auto position = resume_position_;
+
+	for(auto handle = resume_; handle; handle = next(*handle)) {
+		auto& entry = *handle->entry;
+
+		if(entry.notified_position != position) {
+			entry.notified_position = position;
+			positions.emplace_back(entry.client, position);
+		}
 
-	for(auto& entry : queue_) {
-		entry.on_update(position);
 		++position;
 	}
 
-	set_timer();
-	dirty_ = false;
+	resume_.reset();
+	resume_position_ = CLEAN;
+	return positions;
+}
+
+// must be called with the lock held
+void RealmQueue::erase(const Handle& handle) {
+	const auto& entry = *handle.entry;
+
+	// everything after the erased entry moves forward to fill its place
+	if(is_resume(handle)) {
+		resume_ = next(handle);
+	} else if(before_resume(entry)) {
+		resume_ = next(handle);
+		resume_position_ = entry.notified_position;
+	}
+
+	if(!resume_) {
+		resume_position_ = CLEAN;
+	}
+
+	handle.level->second.erase(handle.entry);
+
+	if(handle.level->second.empty()) {
+		levels_.erase(handle.level);
+	}
 }
 
-void RealmQueue::enqueue(ClientUUID client, UpdateQueueCB on_update_cb,
-                         LeaveQueueCB on_leave_cb, int priority) {
+void RealmQueue::enqueue(const ClientUUID& client, const int priority) {
 	std::lock_guard guard(lock_);
 
-	if(queue_.empty()) {
-		set_timer();
+	if(index_.contains(client)) {
+		return;
+	}
+
+	auto level = levels_.try_emplace(priority).first;
+
+	// the new entry goes straight after the last entry at this priority or above
+	std::optional<Handle> prev;
+
+	if(!level->second.empty()) {
+		prev = Handle{ level, std::prev(level->second.end()) };
+	} else if(level != levels_.begin()) {
+		const auto prev_level = std::prev(level);
+		prev = Handle{ prev_level, std::prev(prev_level->second.end()) };
 	}
 
-	queue_.emplace_back(priority, client, on_update_cb, on_leave_cb);
+	auto entry = level->second.emplace(level->second.end(), client, 0);
+	const Handle handle{ level, entry };
+	index_.emplace(client, handle);
 
-	// guaranteed to be a stable sort - not the most efficient way to have queue priority
-	// but allows for multiple priority levels without multiple hard-coded queues
-	queue_.sort();
-	dirty_ = true;
+	if(!prev) {
+		mark_changed(handle, 1);
+	} else if(before_resume(*prev->entry)) {
+		mark_changed(handle, prev->entry->notified_position + 1);
+	}
+
+	set_timer();
 }
 
 /* 
@@ -66,18 +173,14 @@ void RealmQueue::enqueue(ClientUUID client, UpdateQueueCB on_update_cb,
 void RealmQueue::dequeue(const ClientUUID& client) {
 	std::lock_guard guard(lock_);
 
-	for(auto i = queue_.begin(); i != queue_.end(); ++i) {
-		if(i->client == client) {
-			queue_.erase(i);
-			break;
-		}
-	}
+	auto it = index_.find(client);
 
-	if(queue_.empty()) {
-		timer_.cancel();
+	if(it == index_.end()) {
+		return;
 	}
 
-	dirty_ = true;
+	erase(it->second);
+	index_.erase(it);
 }
 
 /* 
@@ -85,21 +188,23 @@ void RealmQueue::dequeue(const ClientUUID& client) {
  * allowing the player at the front of the queue to connect
  */
 void RealmQueue::free_slot() {
-	std::lock_guard guard(lock_);
+	std::optional<ClientUUID> client;
 
-	if(queue_.empty()) {
-		return;
-	}
+	{
+		std::lock_guard guard(lock_);
 
-	auto& entry = queue_.front();
-	entry.on_leave();
-	queue_.pop_front();
+		if(levels_.empty()) {
+			return;
+		}
 
-	if(queue_.empty()) {
-		timer_.cancel();
+		auto level = levels_.begin();
+		auto entry = level->second.begin();
+		client = entry->client;
+		index_.erase(entry->client);
+		erase(Handle{ level, entry });
 	}
 
-	dirty_ = true;
+	on_leave_(*client);
 }
 
 void RealmQueue::shutdown() {
@@ -108,7 +213,8 @@ void RealmQueue::shutdown() {
 }
 
 std::size_t RealmQueue::size() const {
-	return queue_.size();
+	std::lock_guard guard(lock_);
+	return index_.size();
 }
 
-} // ember
\ No newline at end of file
+} // ember
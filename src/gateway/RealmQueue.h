@@ -11,59 +11,94 @@
 #include <shared/ClientUUID.h>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
 #include <chrono>
 #include <functional>
+#include <limits>
 #include <list>
-#include <memory>
+#include <map>
 #include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
 #include <cstddef>
 
 namespace ember {
 
-class ClientConnection;
 using namespace std::chrono_literals;
 
+/*
+ * Entries are held in one FIFO list per priority level, with higher
+ * priorities served first, and indexed by UUID. This gives O(log levels)
+ * enqueue, O(1) dequeue by UUID and O(1) pop from the front.
+ * 
+ * Callbacks are never invoked while the queue's lock is held. Position
+ * updates are batched into a single callback per update period and only
+ * include clients whose position has changed since they were last told.
+ * Every client ahead of the earliest enqueue or dequeue since the last
+ * update is still where it was, so the update starts from that point
+ * rather than walking the whole queue.
+ */
 class RealmQueue final {
-	using LeaveQueueCB = std::function<void()>;
-	using UpdateQueueCB = std::function<void(std::size_t)>;
+public:
+	using Positions = std::vector<std::pair<ClientUUID, std::size_t>>;
+	using UpdateQueueCB = std::function<void(Positions)>;
+	using LeaveQueueCB = std::function<void(const ClientUUID&)>;
 
+private:
 	struct QueueEntry {
-		int priority;
 		ClientUUID client;
-		UpdateQueueCB on_update;
-		LeaveQueueCB on_leave;
+		std::size_t notified_position;
+	};
 
-		bool operator>(const QueueEntry& rhs) const {
-			return rhs.priority > priority;
-		}
+	using Level = std::list<QueueEntry>;
+	using Levels = std::map<int, Level, std::greater<int>>;
 
-		bool operator<(const QueueEntry& rhs) const {
-			return rhs.priority < priority;
-		}
+	struct Handle {
+		Levels::iterator level;
+		Level::iterator entry;
 	};
 
 	static constexpr auto DEFAULT_FREQUENCY { 250ms };
+	static constexpr auto CLEAN = std::numeric_limits<std::size_t>::max();
 	const std::chrono::milliseconds frequency_;
 
 	boost::asio::steady_timer timer_;
-	std::list<QueueEntry> queue_;
-	std::mutex lock_;
-	bool dirty_;
+	Levels levels_;
+	boost::unordered_flat_map<ClientUUID, Handle, boost::hash<ClientUUID>> index_;
+	UpdateQueueCB on_update_;
+	LeaveQueueCB on_leave_;
+	mutable std::mutex lock_;
+	bool timer_active_;
+
+	// first entry whose position may have changed and what that position is
+	std::optional<Handle> resume_;
+	std::size_t resume_position_;
 
 	void update_clients();
 	void set_timer();
+	void erase(const Handle& handle);
+	std::optional<Handle> next(Handle handle);
+	bool is_resume(const Handle& handle) const;
+	bool before_resume(const QueueEntry& entry) const;
+	void mark_changed(const Handle& handle, std::size_t position);
+	Positions changed_positions();
 
 public:
-	explicit RealmQueue(boost::asio::io_context& service,
-	                    std::chrono::milliseconds frequency = DEFAULT_FREQUENCY)
-	                    : timer_(service), frequency_(frequency), dirty_(false) { }
+	RealmQueue(boost::asio::io_context& service, UpdateQueueCB on_update_cb,
+	           LeaveQueueCB on_leave_cb, std::chrono::milliseconds frequency = DEFAULT_FREQUENCY)
+	           : frequency_(frequency),
+	             timer_(service),
+	             on_update_(std::move(on_update_cb)),
+	             on_leave_(std::move(on_leave_cb)),
+	             timer_active_(false),
+	             resume_position_(CLEAN) { }
 
-	void enqueue(ClientUUID client, UpdateQueueCB on_update_cb,
-	             LeaveQueueCB on_leave_cb, int priority = 0);
+	void enqueue(const ClientUUID& client, int priority = 0);
 	void dequeue(const ClientUUID& client);
 	void free_slot();
 	void shutdown();
 	std::size_t size() const;
 };
 
-} // ember
\ No newline at end of file
+} // ember
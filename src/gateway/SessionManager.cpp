@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015 - 2018 Ember
+ * Copyright (c) 2015 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,66 +7,104 @@
  */
 
 #include "SessionManager.h"
-#include "ConnectionStats.h"
+#include <boost/assert.hpp>
 
 namespace ember {
 
+SessionManager::SessionManager(const std::size_t shards)
+	: shards_(std::make_unique<Shard[]>(shards)),
+	  shard_count_(shards) {
+	BOOST_ASSERT_MSG(shards, "Session manager requires at least one shard");
+}
+
+SessionManager::Shard& SessionManager::shard(const ClientConnection& session) {
+	const auto index = session.uuid().service();
+	BOOST_ASSERT_MSG(index < shard_count_, "Bad service index in client UUID");
+	return shards_[index];
+}
+
+AtomicConnectionStats& SessionManager::shard_stats(const ClientUUID& uuid) {
+	BOOST_ASSERT_MSG(uuid.service() < shard_count_, "Bad service index in client UUID");
+	return shards_[uuid.service()].stats;
+}
+
 void SessionManager::start(std::unique_ptr<ClientConnection> session) {
 	auto sess_ptr = session.get();
+	auto& shard = this->shard(*session);
 
 	{
-		std::lock_guard guard(sessions_lock_);
-		sessions_.insert(std::move(session));
+		std::lock_guard guard(shard.lock);
+		shard.sessions.emplace(sess_ptr, std::move(session));
 	}
 
+	shard.stats.sessions.fetch_add(1, std::memory_order_relaxed);
 	sess_ptr->start();
 }
 
-void SessionManager::stop(ClientConnection* session) {
-	std::lock_guard guard(sessions_lock_);
-
-	auto it = std::ranges::find_if(sessions_, [session](auto& value) {
-		return session == value.get();
-	});
+// must be called with the shard's lock held
+void SessionManager::stop(Shard& shard, ClientConnection* session) {
+	auto node = shard.sessions.extract(session);
 
-	if(it == sessions_.end()) {
+	if(node.empty()) {
 		return;
 	}
 
-	auto client = std::move(sessions_.extract(it).value());
-	ClientConnection::async_shutdown(std::move(client));
+	shard.stats.sessions.fetch_sub(1, std::memory_order_relaxed);
+	ClientConnection::async_shutdown(std::move(node.mapped()));
+}
+
+void SessionManager::stop(ClientConnection* session) {
+	auto& shard = this->shard(*session);
+	std::lock_guard guard(shard.lock);
+	stop(shard, session);
 }
 
 void SessionManager::stop_all() {
-	std::lock_guard guard(sessions_lock_);
+	for(std::size_t i = 0; i < shard_count_; ++i) {
+		auto& shard = shards_[i];
+		std::lock_guard guard(shard.lock);
 
-	while(!sessions_.empty()) {
-		auto client = std::move(sessions_.extract(sessions_.begin()).value());
-		ClientConnection::async_shutdown(std::move(client));
+		while(!shard.sessions.empty()) {
+			stop(shard, shard.sessions.begin()->first);
+		}
 	}
 }
 
 std::size_t SessionManager::count() const {
-	return sessions_.size();
+	std::size_t count = 0;
+
+	for(std::size_t i = 0; i < shard_count_; ++i) {
+		count += shards_[i].stats.sessions.load(std::memory_order_relaxed);
+	}
+
+	return count;
 }
 
+/*
+ * Traffic counters are totals since startup rather than for the current
+ * set of connections, so they don't go backwards as clients disconnect.
+ * Latency is the average across current connections.
+ */
 ConnectionStats SessionManager::aggregate_stats() const {
-	std::lock_guard guard(sessions_lock_);
-
 	ConnectionStats ag_stats {};
+	std::size_t sessions = 0;
+
+	for(std::size_t i = 0; i < shard_count_; ++i) {
+		const auto& stats = shards_[i].stats;
+		ag_stats.bytes_in += stats.bytes_in.load(std::memory_order_relaxed);
+		ag_stats.bytes_out += stats.bytes_out.load(std::memory_order_relaxed);
+		ag_stats.latency += stats.latency.load(std::memory_order_relaxed);
+		ag_stats.messages_in += stats.messages_in.load(std::memory_order_relaxed);
+		ag_stats.messages_out += stats.messages_out.load(std::memory_order_relaxed);
+		ag_stats.packets_in += stats.packets_in.load(std::memory_order_relaxed);
+		ag_stats.packets_out += stats.packets_out.load(std::memory_order_relaxed);
+		sessions += stats.sessions.load(std::memory_order_relaxed);
+	}
 
-	for(const auto& session : sessions_) {
-		const auto& stats = session->stats();
-		ag_stats.bytes_in += stats.bytes_in;
-		ag_stats.bytes_out += stats.bytes_out;
-		ag_stats.latency += stats.latency;
-		ag_stats.messages_in += stats.messages_in;
-		ag_stats.messages_out += stats.messages_out;
-		ag_stats.packets_in += stats.packets_in;
-		ag_stats.packets_out += stats.packets_out;
+	if(sessions) {
+		ag_stats.latency /= sessions; // average latency
 	}
 
-	ag_stats.latency /= count(); // average latency
 	return ag_stats;
 }
 
@@ -74,4 +112,4 @@ SessionManager::~SessionManager() {
 	stop_all();
 }
 
-} // ember
\ No newline at end of file
+} // ember
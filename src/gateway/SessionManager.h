@@ -9,19 +9,39 @@
 #pragma once
 
 #include "ClientConnection.h"
+#include "ConnectionStats.h"
+#include <shared/ClientUUID.h>
 #include <memory>
 #include <mutex>
-#include <unordered_set>
+#include <unordered_map>
+#include <cstddef>
 
 namespace ember {
 
-struct ConnectionStats;
-
+/*
+ * Sessions are sharded by the service index encoded in their UUID, which
+ * is also the io_context they run on. Starting and stopping a session
+ * only touches its own shard, so threads don't contend with each other,
+ * and each shard keeps running stats totals so that aggregating them
+ * doesn't require visiting every connection.
+ */
 class SessionManager final {
-	std::unordered_set<std::unique_ptr<ClientConnection>> sessions_;
-	mutable std::mutex sessions_lock_;
+	static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+	struct alignas(CACHE_LINE_SIZE) Shard {
+		std::unordered_map<ClientConnection*, std::unique_ptr<ClientConnection>> sessions;
+		AtomicConnectionStats stats{};
+		mutable std::mutex lock;
+	};
+
+	std::unique_ptr<Shard[]> shards_;
+	const std::size_t shard_count_;
+
+	Shard& shard(const ClientConnection& session);
+	void stop(Shard& shard, ClientConnection* session);
 
 public:
+	explicit SessionManager(std::size_t shards);
 	~SessionManager();
 
 	void start(std::unique_ptr<ClientConnection> session);
@@ -29,6 +49,17 @@ public:
 	void stop_all();
 	std::size_t count() const;
 	ConnectionStats aggregate_stats() const;
+	AtomicConnectionStats& shard_stats(const ClientUUID& uuid);
+
+	void for_each(auto&& func) const {
+		for(std::size_t i = 0; i < shard_count_; ++i) {
+			std::lock_guard guard(shards_[i].lock);
+
+			for(const auto& [_, session] : shards_[i].sessions) {
+				func(*session);
+			}
+		}
+	}
 };
 
-} // ember
\ No newline at end of file
+} // ember
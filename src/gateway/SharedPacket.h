@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <protocol/Concepts.h>
+#include <protocol/PacketHeaders.h>
+#include <spark/buffers/BufferAdaptor.h>
+#include <spark/buffers/BinaryStream.h>
+#include <shared/memory/ASIOAllocator.h>
+#include <gsl/gsl_util>
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ember {
+
+/*
+ * Allocates from a pool owned by the thread (and therefore io_context)
+ * that created the packet. The last reference to a shared packet may be
+ * dropped on any thread, so the pool is thread-safe and kept alive by
+ * every allocator copy, including the one held by the control block.
+ */
+template<typename T>
+class PacketArenaAllocator {
+	using Arena = ASIOAllocator<thread_safe>;
+
+	std::shared_ptr<Arena> arena_;
+
+	static std::shared_ptr<Arena> thread_arena() {
+		thread_local auto arena = std::make_shared<Arena>();
+		return arena;
+	}
+
+	template<typename U>
+	friend class PacketArenaAllocator;
+
+public:
+	using value_type = T;
+
+	PacketArenaAllocator() : arena_(thread_arena()) {}
+
+	template<typename U>
+	PacketArenaAllocator(const PacketArenaAllocator<U>& rhs) noexcept : arena_(rhs.arena_) {}
+
+	[[nodiscard]] T* allocate(const std::size_t n) {
+		return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* ptr, const std::size_t n) {
+		arena_->deallocate(ptr, n * sizeof(T));
+	}
+
+	template<typename U>
+	bool operator==(const PacketArenaAllocator<U>& rhs) const noexcept {
+		return arena_ == rhs.arena_;
+	}
+};
+
+/*
+ * A packet that has been serialised once and can then be queued on any
+ * number of connections without being copied. Only the header differs
+ * between connections (it's encrypted with each session's key), so each
+ * connection writes its own header and references the shared payload.
+ */
+class SharedPacket final {
+	using Header = protocol::ServerHeader;
+	using Storage = std::vector<std::uint8_t, PacketArenaAllocator<std::uint8_t>>;
+
+	Storage data_;
+
+public:
+	using HeaderBytes = std::array<std::uint8_t, Header::WIRE_SIZE>;
+
+	explicit SharedPacket(const protocol::is_packet auto& packet) {
+		using Type = std::remove_cvref_t<decltype(packet)>;
+		static_assert(Type::HEADER_WIRE_SIZE == Header::WIRE_SIZE);
+
+		spark::io::BufferAdaptor adaptor(data_);
+		spark::io::BinaryStream stream(adaptor);
+		stream << packet;
+
+		const auto size = gsl::narrow<typename Type::SizeType>(
+			stream.total_write() - sizeof(typename Type::SizeType)
+		);
+
+		const auto opcode = packet.opcode;
+		std::memcpy(data_.data(), &size, sizeof(size));
+		std::memcpy(data_.data() + sizeof(size), &opcode, sizeof(opcode));
+	}
+
+	// plaintext header, to be encrypted by the connection it's sent on
+	HeaderBytes header() const {
+		HeaderBytes header;
+		std::memcpy(header.data(), data_.data(), header.size());
+		return header;
+	}
+
+	std::span<const std::uint8_t> payload() const {
+		return std::span(data_).subspan(Header::WIRE_SIZE);
+	}
+
+	// the entire plaintext packet, header included
+	std::span<const std::uint8_t> data() const {
+		return data_;
+	}
+};
+
+inline std::shared_ptr<const SharedPacket> make_shared_packet(const protocol::is_packet auto& packet) {
+	return std::allocate_shared<SharedPacket>(PacketArenaAllocator<SharedPacket>(), packet);
+}
+
+} // ember
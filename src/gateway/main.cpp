@@ -12,9 +12,13 @@
 #include "RealmQueue.h"
 #include "AccountClient.h"
 #include "EventDispatcher.h"
+#include "Events.h"
 #include "CharacterClient.h"
 #include "RealmService.h"
 #include "NetworkListener.h"
+#include "QoS.h"
+#include "ServerConfig.h"
+#include "packetlog/PacketCapture.h"
 #include <conpool/ConnectionPool.h>
 #include <conpool/Policies.h>
 #include <conpool/drivers/AutoSelect.h>
@@ -50,10 +54,13 @@
 #include <format>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <semaphore>
 #include <string>
 #include <string_view>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 #include <cstdlib>
 
 constexpr ember::cstring_view APP_NAME { "Realm Gateway" };
@@ -69,6 +76,7 @@ void launch(const po::variables_map& args, ServicePool& service_pool,
             std::binary_semaphore& sem, log::Logger* logger);
 int asio_launch(const po::variables_map& args, log::Logger* logger);
 std::optional<Realm> load_realm(const po::variables_map& args, log::Logger* logger);
+void broadcast_shutdown(const EventDispatcher& dispatcher, const SessionManager& sessions);
 void print_lib_versions(log::Logger* logger);
 unsigned int check_concurrency(log::Logger* logger); // todo, move
 po::variables_map parse_arguments(int argc, const char* argv[]);
@@ -221,6 +229,7 @@ void launch(const po::variables_map& args, ServicePool& service_pool,
 	const auto port = args["network.port"].as<std::uint16_t>();
 	const auto& interface = args["network.interface"].as<std::string>();
 	const auto tcp_no_delay = args["network.tcp_no_delay"].as<bool>();
+	const auto reuse_port = args["network.reuse_port"].as<bool>();
 
 	// If the database port differs from the config file port, use the config file port
 	if(port != realm->port) {
@@ -266,7 +275,23 @@ void launch(const po::variables_map& args, ServicePool& service_pool,
 
 	LOG_INFO_SYNC(logger, "Realm will be advertised on {}", realm->address);
 
-	RealmQueue queue_service(service_pool.get());
+	RealmQueue queue_service(service_pool.get(),
+		[&dispatcher](RealmQueue::Positions positions) {
+			std::vector<ClientUUID> clients;
+			clients.reserve(positions.size());
+			QueuePosition::Positions lookup(positions.begin(), positions.end());
+
+			for(const auto& [client, _] : positions) {
+				clients.emplace_back(client);
+			}
+
+			auto event = std::make_shared<const QueuePosition>(std::move(lookup));
+			dispatcher.broadcast_event(std::move(clients), std::move(event));
+		},
+		[&dispatcher](const ClientUUID& client) {
+			dispatcher.post_event(client, Event{ EventType::QUEUE_SUCCESS });
+		}
+	);
 	
 	LOG_INFO(logger) << "Starting RPC services..." << LOG_SYNC;
 	spark::v2::Server spark(service_pool.get(), "realm", s_address, s_port, logger);
@@ -286,6 +311,22 @@ void launch(const po::variables_map& args, ServicePool& service_pool,
 	Locator::set(&acct_svc);
 	Locator::set(&char_svc);
 	Locator::set(&config);
+
+	// must outlive any client connections
+	std::optional<PacketCapture> capture;
+
+	if(args["packet_capture.enabled"].as<bool>()) {
+		LOG_INFO(logger) << "Starting packet capture..." << LOG_SYNC;
+
+		capture.emplace(
+			args["packet_capture.path"].as<std::string>(),
+			args["packet_capture.buffer_size"].as<std::size_t>(),
+			std::chrono::milliseconds(args["packet_capture.flush_interval"].as<unsigned int>()),
+			logger
+		);
+
+		Locator::set(&*capture);
+	}
 	
 	// Misc. information
 	const auto max_socks = util::max_sockets_desc();
@@ -294,10 +335,27 @@ void launch(const po::variables_map& args, ServicePool& service_pool,
 	// Start network listener
 	LOG_INFO_SYNC(logger, "Starting network service...");
 
-	NetworkListener server(service_pool, interface, port, tcp_no_delay, logger);
+	const auto& placement = args["network.placement"].as<std::string>();
+
+	if(placement == "least_loaded") {
+		service_pool.placement(std::make_unique<LeastLoadedPlacement>());
+	} else if(placement != "round_robin") {
+		throw std::invalid_argument("Unknown network.placement policy: " + placement);
+	}
+
+	ServerConfig server_config {
+		.compression_level = args["network.compression"].as<unsigned int>(),
+		.max_bandwidth_in = 0,
+		.max_bandwidth_out = args["network.max_bandwidth_out"].as<unsigned int>()
+	};
+
+	NetworkListener server(service_pool, interface, port, tcp_no_delay, reuse_port, server_config, logger);
 
 	LOG_INFO_SYNC(logger, "Started network service on {}:{}", interface, server.port());
 
+	QoS qos(server_config, server.sessions(), service_pool.get());
+	qos.start();
+
 	service.dispatch([&]() {
 		realm_svc.set_online();
 		LOG_INFO_SYNC(logger, "{} started successfully", APP_NAME);
@@ -305,10 +363,36 @@ void launch(const po::variables_map& args, ServicePool& service_pool,
 
 	sem.acquire();
 	LOG_INFO_SYNC(logger, "{} shutting down...", APP_NAME);
+	broadcast_shutdown(dispatcher, server.sessions());
+	qos.shutdown();
+	queue_service.shutdown();
 } catch(...) {
 	eptr = std::current_exception();
 }
 
+/*
+ * Every client gets the same notice, so it's only serialised once,
+ * rather than once per client
+ */
+void broadcast_shutdown(const EventDispatcher& dispatcher, const SessionManager& sessions) {
+	std::vector<ClientUUID> clients;
+
+	sessions.for_each([&](const ClientConnection& client) {
+		clients.emplace_back(client.uuid());
+	});
+
+	if(clients.empty()) {
+		return;
+	}
+
+	protocol::SMSG_SERVER_MESSAGE message;
+	message->type = std::to_underlying(protocol::server::ServerMessage::Type::STRING);
+	message->message = "The realm is shutting down";
+
+	auto event = std::make_shared<const PacketBroadcast>(make_shared_packet(message));
+	dispatcher.broadcast_event(std::move(clients), std::move(event));
+}
+
 /*
  * Split from launch() as the DB connection is only needed for
  * loading the initial realm information. If the gateway requires
@@ -377,7 +461,14 @@ po::variables_map parse_arguments(int argc, const char* argv[]) {
 		("network.interface", po::value<std::string>()->required())
 		("network.port", po::value<std::uint16_t>()->required())
 		("network.tcp_no_delay", po::value<bool>()->required())
-		("network.compression", po::value<std::uint8_t>()->required())
+		("network.compression", po::value<unsigned int>()->required())
+		("network.max_bandwidth_out", po::value<unsigned int>()->default_value(0))
+		("network.placement", po::value<std::string>()->default_value("least_loaded"))
+		("network.reuse_port", po::value<bool>()->default_value(false))
+		("packet_capture.enabled", po::value<bool>()->default_value(false))
+		("packet_capture.path", po::value<std::string>()->default_value("captures/"))
+		("packet_capture.buffer_size", po::value<std::size_t>()->default_value(4 * 1024 * 1024))
+		("packet_capture.flush_interval", po::value<unsigned int>()->default_value(100))
 		("console_log.verbosity", po::value<std::string>()->required())
 		("console_log.filter-mask", po::value<std::uint32_t>()->default_value(0))
 		("console_log.colours", po::value<bool>()->required())
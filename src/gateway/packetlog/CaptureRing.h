@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "PacketSink.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ember {
+
+class CaptureFile;
+
+/*
+ * Single-producer, single-consumer ring of variable length records.
+ * Records are never split across the end of the ring, so the consumer
+ * always sees a record's payload as a single contiguous span.
+ *
+ * Neither side ever blocks - if the producer finds the ring full, the
+ * record is dropped and it's up to the caller to count it.
+ */
+class CaptureRing final {
+public:
+	struct Record {
+		CaptureFile* file;
+		std::uint64_t timestamp;
+		std::uint32_t length;
+		PacketDirection direction;
+	};
+
+private:
+	static constexpr std::size_t ALIGNMENT = alignof(Record);
+	static constexpr std::size_t CACHE_LINE = 64;
+
+	const std::size_t capacity_;
+	const std::size_t mask_;
+	std::unique_ptr<std::byte[]> buffer_;
+
+	alignas(CACHE_LINE) std::atomic<std::uint64_t> head_ { 0 }; // written by the consumer
+	alignas(CACHE_LINE) std::atomic<std::uint64_t> tail_ { 0 }; // written by the producer
+	std::uint64_t cached_head_ = 0;
+
+	static constexpr std::size_t record_size(const std::size_t length) {
+		return (sizeof(Record) + length + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+public:
+	explicit CaptureRing(const std::size_t capacity)
+		: capacity_(std::bit_ceil(std::max(capacity, record_size(0) * 2))),
+		  mask_(capacity_ - 1),
+		  buffer_(std::make_unique<std::byte[]>(capacity_)) {}
+
+	// producer only
+	bool push(const Record& record, std::span<const std::uint8_t> payload) {
+		const auto size = record_size(payload.size());
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		const auto offset = tail & mask_;
+		const auto to_end = capacity_ - offset;
+
+		// records that won't fit before the end of the ring start at the beginning
+		const auto padding = to_end < size? to_end : 0;
+		const auto required = size + padding;
+
+		if(tail + required - cached_head_ > capacity_) {
+			cached_head_ = head_.load(std::memory_order_acquire);
+
+			if(tail + required - cached_head_ > capacity_) {
+				return false;
+			}
+		}
+
+		// marks the rest of the ring as unused, if there's room for the marker
+		if(padding && to_end >= sizeof(Record)) {
+			const Record marker { .file = nullptr };
+			std::memcpy(buffer_.get() + offset, &marker, sizeof(marker));
+		}
+
+		// the payload's size is authoritative, whatever the record claims
+		Record header = record;
+		header.length = static_cast<std::uint32_t>(payload.size());
+
+		auto dest = buffer_.get() + ((tail + padding) & mask_);
+		std::memcpy(dest, &header, sizeof(header));
+
+		if(!payload.empty()) {
+			std::memcpy(dest + sizeof(header), payload.data(), payload.size());
+		}
+
+		tail_.store(tail + required, std::memory_order_release);
+		return true;
+	}
+
+	/*
+	 * Consumer only. Invokes the handler for every record available at the
+	 * time of the call and then releases their space back to the producer.
+	 * Returns the number of records consumed.
+	 */
+	std::size_t drain(auto&& handler) {
+		const auto tail = tail_.load(std::memory_order_acquire);
+		auto head = head_.load(std::memory_order_relaxed);
+		std::size_t count = 0;
+
+		while(head != tail) {
+			const auto offset = head & mask_;
+			const auto to_end = capacity_ - offset;
+
+			if(to_end < sizeof(Record)) {
+				head += to_end;
+				continue;
+			}
+
+			Record record;
+			std::memcpy(&record, buffer_.get() + offset, sizeof(record));
+
+			if(!record.file) {
+				head += to_end;
+				continue;
+			}
+
+			const auto payload = reinterpret_cast<const std::uint8_t*>(
+				buffer_.get() + offset + sizeof(Record)
+			);
+
+			handler(record, std::span(payload, record.length));
+			head += record_size(record.length);
+			++count;
+		}
+
+		head_.store(head, std::memory_order_release);
+		return count;
+	}
+
+	std::size_t capacity() const {
+		return capacity_;
+	}
+};
+
+} // ember
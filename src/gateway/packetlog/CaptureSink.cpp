@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "CaptureSink.h"
+#include "PacketCapture.h"
+#include <utility>
+
+namespace ember {
+
+CaptureSink::CaptureSink(PacketCapture& capture, std::string_view name, std::string_view host,
+                         std::string_view remote_host)
+                         : capture_(capture),
+                           file_(capture.create(name, host, remote_host)) {}
+
+void CaptureSink::log(std::span<const std::uint8_t> buffer,
+                      std::chrono::system_clock::time_point time, PacketDirection dir) {
+	capture_.capture(*file_, buffer, time, dir);
+}
+
+CaptureSink::~CaptureSink() {
+	capture_.close(std::move(file_));
+}
+
+} // ember
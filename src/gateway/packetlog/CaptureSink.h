@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "PacketSink.h"
+#include <memory>
+#include <string_view>
+
+namespace ember {
+
+class CaptureFile;
+class PacketCapture;
+
+class CaptureSink final : public PacketSink {
+	PacketCapture& capture_;
+	std::shared_ptr<CaptureFile> file_;
+
+public:
+	CaptureSink(PacketCapture& capture, std::string_view name, std::string_view host,
+	            std::string_view remote_host);
+
+	void log(std::span<const std::uint8_t> buffer, std::chrono::system_clock::time_point time,
+	         PacketDirection dir) override;
+
+	~CaptureSink() override;
+};
+
+} // ember
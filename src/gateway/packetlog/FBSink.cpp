@@ -30,15 +30,20 @@ void FBSink::start_log(const std::string& filename, std::string_view host,
 		throw std::runtime_error("Unable to open file for packet logging");
 	}
 
+	write_header(file_, VERSION, host, remote_host, time_fmt_);
+}
+
+void FBSink::write_header(std::ostream& out, const std::uint32_t version, std::string_view host,
+                          std::string_view remote_host, std::string_view time_fmt) {
 	flatbuffers::FlatBufferBuilder fbb;
 
 	auto fb_host = fbb.CreateString(host);
 	auto fb_remote = fbb.CreateString(remote_host);
-	auto fb_time_fmt = fbb.CreateString(time_fmt_);
+	auto fb_time_fmt = fbb.CreateString(time_fmt);
 	auto fb_host_desc = fbb.CreateString("unused");
 
 	fblog::HeaderBuilder hb(fbb);
-	hb.add_version(VERSION);
+	hb.add_version(version);
 	hb.add_host(fb_host);
 	hb.add_host_desc(fb_host_desc);
 	hb.add_remote_host(fb_remote);
@@ -50,13 +55,14 @@ void FBSink::start_log(const std::string& filename, std::string_view host,
 	const auto size_le = be::native_to_little(size);
 	const auto type_le = be::native_to_little(static_cast<std::uint32_t>(fblog::Type::HEADER));
 
-	file_.write(reinterpret_cast<const char*>(&size_le), sizeof(size_le));
-	file_.write(reinterpret_cast<const char*>(&type_le), sizeof(type_le));
-	file_.write(reinterpret_cast<const char*>(fbb.GetBufferPointer()), size);
+	out.write(reinterpret_cast<const char*>(&size_le), sizeof(size_le));
+	out.write(reinterpret_cast<const char*>(&type_le), sizeof(type_le));
+	out.write(reinterpret_cast<const char*>(fbb.GetBufferPointer()), size);
 }
 
-void FBSink::log(std::span<const std::uint8_t> buffer, const std::time_t& time, 
+void FBSink::log(std::span<const std::uint8_t> buffer, std::chrono::system_clock::time_point tp,
                  PacketDirection dir) {
+	const auto time = std::chrono::system_clock::to_time_t(tp);
 	std::tm utc_time;
 
 #if _MSC_VER && !__INTEL_COMPILER
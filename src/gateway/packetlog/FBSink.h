@@ -10,6 +10,7 @@
 
 #include "PacketSink.h"
 #include <shared/util/cstring_view.hpp>
+#include <ostream>
 #include <string>
 #include <string_view>
 #include <fstream>
@@ -27,8 +28,11 @@ class FBSink final : public PacketSink {
 public:
 	FBSink(const std::string& filename, std::string_view host, std::string_view remote_host);
 
-	void log(std::span<const std::uint8_t> buffer, const std::time_t& time,
+	void log(std::span<const std::uint8_t> buffer, std::chrono::system_clock::time_point time,
 	         PacketDirection dir) override;
+
+	static void write_header(std::ostream& out, std::uint32_t version, std::string_view host,
+	                         std::string_view remote_host, std::string_view time_fmt);
 };
 
 } // ember
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <memory>
 #include <string_view>
 #include <cstddef>
+#include <ctime>
 
 namespace ember {
 
@@ -27,8 +28,9 @@ void LogSink::start_log() {
 		<< "Starting packet logging for " << remote_host_ << log::flush;
 }
 
-void LogSink::log(std::span<const std::uint8_t> buffer, const std::time_t& time,
+void LogSink::log(std::span<const std::uint8_t> buffer, std::chrono::system_clock::time_point tp,
                   PacketDirection dir) {
+	const auto time = std::chrono::system_clock::to_time_t(tp);
 	const auto output = util::format_packet(buffer.data(), buffer.size());
 
 	cstring_view fmt("%H:%M:%S");
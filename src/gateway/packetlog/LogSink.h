@@ -23,7 +23,7 @@ class LogSink final : public PacketSink {
 public:
 	LogSink(log::Logger& logger, log::Severity severity, std::string remote_host);
 
-	void log(std::span<const std::uint8_t> buffer, const std::time_t& time,
+	void log(std::span<const std::uint8_t> buffer, std::chrono::system_clock::time_point time,
 	         PacketDirection dir) override;
 
 	~LogSink() override;
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "PacketCapture.h"
+#include "FBSink.h"
+#include <PacketLog_generated.h>
+#include <logger/Logger.h>
+#include <shared/threading/Utility.h>
+#include <boost/endian/conversion.hpp>
+#include <filesystem>
+#include <functional>
+#include <cstring>
+
+namespace be = boost::endian;
+
+namespace ember {
+
+namespace {
+
+std::atomic<std::uint64_t> next_id { 1 };
+
+void append(std::vector<std::byte>& block, const auto value) {
+	const auto le = be::native_to_little(value);
+	const auto bytes = std::as_bytes(std::span(&le, 1));
+	block.insert(block.end(), bytes.begin(), bytes.end());
+}
+
+} // unnamed
+
+PacketCapture::PacketCapture(std::string directory, const std::size_t ring_size,
+                             const std::chrono::milliseconds interval, log::Logger* logger)
+                             : directory_(std::move(directory)),
+                               ring_size_(ring_size),
+                               interval_(interval),
+                               id_(next_id++),
+                               logger_(logger) {
+	std::filesystem::create_directories(directory_);
+	worker_ = std::jthread(std::bind_front(&PacketCapture::run, this));
+	thread::set_name(worker_, "Packet Capture");
+}
+
+PacketCapture::~PacketCapture() {
+	worker_.request_stop();
+	worker_.join();
+}
+
+std::shared_ptr<CaptureFile> PacketCapture::create(std::string_view name, std::string_view host,
+                                                   std::string_view remote_host) {
+	const auto path = std::filesystem::path(directory_) / (std::string(name) + ".bin");
+	return std::make_shared<CaptureFile>(path.string(), host, remote_host);
+}
+
+/*
+ * Each thread gets its own ring the first time it captures a packet, so
+ * every ring has a single producer
+ */
+CaptureRing& PacketCapture::ring() {
+	struct Cache {
+		std::uint64_t owner = 0;
+		CaptureRing* ring = nullptr;
+	};
+
+	thread_local Cache cache;
+
+	if(cache.owner != id_) [[unlikely]] {
+		auto ring = std::make_unique<CaptureRing>(ring_size_);
+		cache = { id_, ring.get() };
+
+		std::lock_guard guard(lock_);
+		rings_.emplace_back(std::move(ring));
+	}
+
+	return *cache.ring;
+}
+
+void PacketCapture::capture(CaptureFile& file, std::span<const std::uint8_t> buffer,
+                            const std::chrono::system_clock::time_point time,
+                            const PacketDirection dir) {
+	const auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		time.time_since_epoch()
+	);
+
+	const CaptureRing::Record record {
+		.file = &file,
+		.timestamp = static_cast<std::uint64_t>(since_epoch.count()),
+		.length = static_cast<std::uint32_t>(buffer.size()),
+		.direction = dir
+	};
+
+	if(ring().push(record, buffer)) [[likely]] {
+		captured_.fetch_add(1, std::memory_order_relaxed);
+	} else {
+		file.dropped_.fetch_add(1, std::memory_order_relaxed);
+		dropped_.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+/*
+ * Any packets captured for the file before this call will still be
+ * written, the file being closed once they have been
+ */
+void PacketCapture::close(std::shared_ptr<CaptureFile> file) {
+	std::lock_guard guard(lock_);
+	closed_.emplace_back(std::move(file));
+}
+
+CaptureStats PacketCapture::stats() const {
+	return {
+		.captured = captured_.load(std::memory_order_relaxed),
+		.dropped = dropped_.load(std::memory_order_relaxed),
+		.bytes_written = bytes_written_.load(std::memory_order_relaxed)
+	};
+}
+
+void PacketCapture::run(std::stop_token token) {
+	while(!token.stop_requested()) {
+		{
+			std::unique_lock guard(lock_);
+			cond_.wait_for(guard, token, interval_, [] { return false; });
+		}
+
+		flush();
+		report_drops();
+	}
+
+	// pick up anything captured or closed during shutdown
+	flush();
+}
+
+void PacketCapture::flush() {
+	std::vector<std::shared_ptr<CaptureFile>> closed;
+	std::vector<CaptureRing*> rings;
+
+	/*
+	 * Closed files must be collected before the rings are drained, to
+	 * guarantee that any packets captured before a file was closed are
+	 * written before the file is released
+	 */
+	{
+		std::lock_guard guard(lock_);
+		closed.swap(closed_);
+		rings.reserve(rings_.size());
+
+		for(const auto& ring : rings_) {
+			rings.emplace_back(ring.get());
+		}
+	}
+
+	for(auto ring : rings) {
+		ring->drain([&](const CaptureRing::Record& record, std::span<const std::uint8_t> payload) {
+			const auto direction = record.direction == PacketDirection::INBOUND?
+				fblog::Direction::INBOUND : fblog::Direction::OUTBOUND;
+
+			auto& block = blocks_[record.file];
+			append(block, record.timestamp);
+			append(block, static_cast<std::uint8_t>(direction));
+			append(block, record.length);
+			const auto bytes = std::as_bytes(payload);
+			block.insert(block.end(), bytes.begin(), bytes.end());
+		});
+	}
+
+	for(auto& [file, block] : blocks_) {
+		if(!block.empty()) {
+			write_block(*file, block);
+		}
+	}
+
+	for(auto& file : closed) {
+		auto& block = blocks_[file.get()];
+
+		if(!block.empty() || file->dropped_ || !file->opened_) {
+			write_block(*file, block);
+		}
+
+		blocks_.erase(file.get());
+		file->file_.close();
+	}
+}
+
+// only called from the writer thread
+bool PacketCapture::open(CaptureFile& file) {
+	if(file.opened_) {
+		return file.file_.is_open();
+	}
+
+	file.opened_ = true;
+	file.file_.open(file.path_, std::ios::binary | std::ios::out | std::ios::app);
+
+	if(!file.file_) {
+		LOG_ERROR(logger_) << "Unable to open packet capture file, " << file.path_ << LOG_ASYNC;
+		return false;
+	}
+
+	// packets carry numeric timestamps rather than formatted strings
+	FBSink::write_header(file.file_, VERSION, file.host_, file.remote_host_, "");
+	return true;
+}
+
+// only called from the writer thread
+void PacketCapture::write_block(CaptureFile& file, std::vector<std::byte>& block) {
+	if(!open(file)) {
+		block.clear();
+		return;
+	}
+
+	const auto dropped = file.dropped_.exchange(0, std::memory_order_relaxed);
+
+	// an empty block is still written if packets were dropped, so it's visible
+	if(!block.empty() || dropped) {
+		const auto size = static_cast<std::uint32_t>(sizeof(dropped) + block.size());
+		const auto size_le = be::native_to_little(size);
+		const auto type_le = be::native_to_little(static_cast<std::uint32_t>(fblog::Type::BLOCK));
+		const auto dropped_le = be::native_to_little(dropped);
+
+		file.file_.write(reinterpret_cast<const char*>(&size_le), sizeof(size_le));
+		file.file_.write(reinterpret_cast<const char*>(&type_le), sizeof(type_le));
+		file.file_.write(reinterpret_cast<const char*>(&dropped_le), sizeof(dropped_le));
+		file.file_.write(reinterpret_cast<const char*>(block.data()), block.size());
+		bytes_written_.fetch_add(sizeof(size_le) + sizeof(type_le) + size, std::memory_order_relaxed);
+	}
+
+	file.file_.flush();
+	block.clear();
+}
+
+void PacketCapture::report_drops() {
+	constexpr auto REPORT_INTERVAL = std::chrono::seconds(10);
+
+	const auto dropped = dropped_.load(std::memory_order_relaxed);
+	const auto now = std::chrono::steady_clock::now();
+
+	if(dropped == reported_drops_ || now - last_report_ < REPORT_INTERVAL) {
+		return;
+	}
+
+	LOG_WARN(logger_) << "Packet capture dropped " << (dropped - reported_drops_)
+	                  << " packets, consider increasing the capture buffer size" << LOG_ASYNC;
+
+	reported_drops_ = dropped;
+	last_report_ = now;
+}
+
+} // ember
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "CaptureRing.h"
+#include "PacketSink.h"
+#include <logger/LoggerFwd.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+class CaptureFile final {
+	friend class PacketCapture;
+
+	const std::string path_;
+	const std::string host_;
+	const std::string remote_host_;
+	std::atomic<std::uint32_t> dropped_ { 0 };
+	std::ofstream file_; // only touched by the writer thread
+	bool opened_ = false;
+
+public:
+	CaptureFile(std::string path, std::string_view host, std::string_view remote_host)
+		: path_(std::move(path)), host_(host), remote_host_(remote_host) {}
+};
+
+struct CaptureStats {
+	std::uint64_t captured;
+	std::uint64_t dropped;
+	std::uint64_t bytes_written;
+};
+
+/*
+ * Low overhead packet capture. Packets are copied into a ring owned by
+ * the calling thread and a dedicated writer thread periodically drains
+ * the rings, writing each file's packets to disk as a single block.
+ * The calling thread never touches the disk, never takes a lock after
+ * its first capture and never waits on the writer - if its ring is full,
+ * the packet is dropped and counted instead.
+ *
+ * Rings are cached per thread, so only one instance is expected to be
+ * active at a time.
+ */
+class PacketCapture final {
+public:
+	static constexpr std::uint32_t VERSION = 2;
+
+private:
+	const std::string directory_;
+	const std::size_t ring_size_;
+	const std::chrono::milliseconds interval_;
+	const std::uint64_t id_;
+	log::Logger* logger_;
+
+	std::mutex lock_;
+	std::condition_variable_any cond_;
+	std::vector<std::unique_ptr<CaptureRing>> rings_;
+	std::vector<std::shared_ptr<CaptureFile>> closed_;
+
+	std::atomic<std::uint64_t> captured_ { 0 };
+	std::atomic<std::uint64_t> dropped_ { 0 };
+	std::atomic<std::uint64_t> bytes_written_ { 0 };
+	std::uint64_t reported_drops_ = 0;
+	std::chrono::steady_clock::time_point last_report_;
+
+	// only touched by the writer thread
+	std::unordered_map<CaptureFile*, std::vector<std::byte>> blocks_;
+	std::jthread worker_;
+
+	CaptureRing& ring();
+	void run(std::stop_token token);
+	void flush();
+	bool open(CaptureFile& file);
+	void write_block(CaptureFile& file, std::vector<std::byte>& block);
+	void report_drops();
+
+public:
+	PacketCapture(std::string directory, std::size_t ring_size,
+	              std::chrono::milliseconds interval, log::Logger* logger);
+	~PacketCapture();
+
+	std::shared_ptr<CaptureFile> create(std::string_view name, std::string_view host,
+	                                    std::string_view remote_host);
+
+	void capture(CaptureFile& file, std::span<const std::uint8_t> buffer,
+	             std::chrono::system_clock::time_point time, PacketDirection dir);
+
+	void close(std::shared_ptr<CaptureFile> file);
+	CaptureStats stats() const;
+
+	PacketCapture(const PacketCapture&) = delete;
+	PacketCapture& operator=(const PacketCapture&) = delete;
+};
+
+} // ember
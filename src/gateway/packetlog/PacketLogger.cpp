@@ -21,7 +21,7 @@ void PacketLogger::reset() {
 }
 
 void PacketLogger::log(const spark::io::pmr::Buffer& buffer, std::size_t length, PacketDirection dir) {
-	const auto time = sc::system_clock::to_time_t(sc::system_clock::now());
+	const auto time = sc::system_clock::now();
 
 	boost::container::small_vector<std::uint8_t, RESERVE_LEN> out_buf(
 		length, boost::container::default_init
@@ -35,7 +35,7 @@ void PacketLogger::log(const spark::io::pmr::Buffer& buffer, std::size_t length,
 }
 
 void PacketLogger::log(std::span<const std::uint8_t> buffer, PacketDirection dir) {
-	const auto time = sc::system_clock::to_time_t(sc::system_clock::now());
+	const auto time = sc::system_clock::now();
 
 	for(auto& sink : sinks_) {
 		sink->log(buffer, time, dir);
@@ -8,10 +8,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <span>
 #include <cstddef>
 #include <cstdint>
-#include <ctime>
 
 namespace ember {
 
@@ -22,7 +22,7 @@ enum class PacketDirection {
 class PacketSink {
 public:
 	virtual void log(std::span<const std::uint8_t> buffer,
-	                 const std::time_t& time,
+	                 std::chrono::system_clock::time_point time,
 	                 PacketDirection dir) = 0;
 
 	virtual ~PacketSink() = default;
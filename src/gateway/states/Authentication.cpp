@@ -240,17 +240,7 @@ void send_addon_data(ClientContext& ctx) {
 void auth_queue(ClientContext& ctx) {
 	LOG_TRACE_FILTER_GLOB(LF_NETWORK) << log_func << LOG_ASYNC;
 
-	const auto& uuid = ctx.handler->uuid();
-
-	Locator::queue()->enqueue(uuid,
-		[uuid](const std::size_t position) {
-			Locator::dispatcher()->post_event(uuid, QueuePosition(position));
-		},
-		[uuid]() {
-			const Event event { EventType::QUEUE_SUCCESS };
-			Locator::dispatcher()->post_event(uuid, event);
-		}
-	);
+	Locator::queue()->enqueue(ctx.handler->uuid());
 
 	auth_state(ctx, State::IN_QUEUE);
 	CLIENT_DEBUG_GLOB(ctx) << "added to queue" << LOG_ASYNC;
@@ -277,9 +267,15 @@ void send_auth_result(ClientContext& ctx, protocol::Result result) {
 void handle_queue_update(ClientContext& ctx, const QueuePosition* event) {
 	LOG_TRACE_FILTER_GLOB(LF_NETWORK) << log_func << LOG_ASYNC;
 
+	const auto it = event->positions.find(ctx.handler->uuid());
+
+	if(it == event->positions.end()) {
+		return;
+	}
+
 	protocol::SMSG_AUTH_RESPONSE packet;
 	packet->result = protocol::Result::AUTH_WAIT_QUEUE;
-	packet->queue_position = gsl::narrow_cast<std::uint32_t>(event->position);
+	packet->queue_position = gsl::narrow_cast<std::uint32_t>(it->second);
 	ctx.connection->send(packet);
 }
 
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <dbcreader/BundleFormat.h>
+#include <shared/util/FNVHash.h>
+#include <shared/util/polyfill/start_lifetime_as>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <cstddef>
+
+namespace ember::dbc {
+
+/*
+ * A mapped DBC bundle. Opening it only validates the header and the bounds
+ * of each entry (and the checksum, unless skipped), so the cost doesn't
+ * grow with the number of records. See BundleFormat.h for the layout.
+ */
+class Bundle final {
+	std::shared_ptr<const boost::interprocess::mapped_region> region_;
+	std::span<const BundleEntry> entries_;
+	std::string_view strings_;
+
+	[[noreturn]] static void fail(const std::string& path, std::string_view reason) {
+		std::stringstream err;
+		err << path << ": " << reason;
+		throw std::runtime_error(err.str());
+	}
+
+	static bool in_bounds(std::size_t offset, std::size_t len, std::size_t size) {
+		return offset <= size && len <= size - offset;
+	}
+
+public:
+	enum class Checksum {
+		VERIFY, SKIP
+	};
+
+	explicit Bundle(const std::string& path, Checksum checksum = Checksum::VERIFY) {
+		namespace bi = boost::interprocess;
+
+		bi::file_mapping file(path.c_str(), bi::read_only);
+		auto region = std::make_shared<bi::mapped_region>(file, bi::read_only);
+
+		const auto data = static_cast<const char*>(region->get_address());
+		const auto size = region->get_size();
+
+		if(size < sizeof(BundleHeader)) {
+			fail(path, "File is too small to hold a bundle header");
+		}
+
+		const auto header = std::start_lifetime_as<const BundleHeader>(data);
+
+		if(header->magic != BUNDLE_MAGIC) {
+			fail(path, "Invalid bundle magic");
+		}
+
+		if(header->version != BUNDLE_VERSION) {
+			std::stringstream err;
+			err << "Bundle version " << header->version << " is not supported, expected "
+			    << BUNDLE_VERSION << " - rebuild the bundle with dbc-parser";
+			fail(path, err.str());
+		}
+
+		if(header->size != size) {
+			fail(path, "Bundle size does not match the header, file may be truncated");
+		}
+
+		if(checksum == Checksum::VERIFY) {
+			FNVHash hasher;
+			hasher.update(data + sizeof(BundleHeader), data + size);
+
+			if(hasher.hash() != header->checksum) {
+				fail(path, "Bundle checksum mismatch, file may be corrupt");
+			}
+		}
+
+		if(!in_bounds(sizeof(BundleHeader), header->dbcs * sizeof(BundleEntry), size)
+		   || !in_bounds(header->string_block_offset, header->string_block_len, size)) {
+			fail(path, "Bundle header references data outside of the file");
+		}
+
+		const auto entries = std::start_lifetime_as<const BundleEntry>(data + sizeof(BundleHeader));
+		entries_ = { entries, header->dbcs };
+		strings_ = { data + header->string_block_offset, header->string_block_len };
+
+		for(const auto& entry : entries_) {
+			const std::size_t index_entry_size = entry.index_type == std::to_underlying(BundleIndex::SORTED)?
+				sizeof(BundleIndexEntry) : sizeof(be::little_uint32_t);
+
+			if(std::ranges::find(entry.name, '\0') == std::end(entry.name)
+			   || !in_bounds(entry.records_offset, std::size_t(entry.records) * entry.record_size, size)
+			   || !in_bounds(entry.index_offset, std::size_t(entry.index_size) * index_entry_size, size)
+			   || entry.index_type > std::to_underlying(BundleIndex::SORTED)) {
+				fail(path, "Bundle entry is malformed");
+			}
+		}
+
+		region_ = std::move(region);
+	}
+
+	const BundleEntry* find(std::string_view name) const {
+		auto it = std::ranges::find_if(entries_, [&](const BundleEntry& entry) {
+			return name == entry.name;
+		});
+
+		return it == entries_.end()? nullptr : &*it;
+	}
+
+	std::span<const BundleEntry> entries() const {
+		return entries_;
+	}
+
+	const char* data(std::size_t offset) const {
+		return static_cast<const char*>(region_->get_address()) + offset;
+	}
+
+	std::string_view strings() const {
+		return strings_;
+	}
+
+	// views hold onto the mapping so the bundle doesn't have to outlive them
+	const std::shared_ptr<const boost::interprocess::mapped_region>& region() const {
+		return region_;
+	}
+};
+
+} // dbc, ember
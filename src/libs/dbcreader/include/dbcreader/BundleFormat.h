@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/util/MulticharConstant.h>
+#include <boost/endian/arithmetic.hpp>
+#include <cstdint>
+
+/*
+ * On-disk layout of a DBC bundle, as written by dbc-parser --bundle. This
+ * header is shared with the tool, so it mustn't depend on generated code.
+ *
+ * BundleHeader
+ * BundleEntry[dbcs]
+ * Records, index tables and the string block, at the offsets given by the
+ * header and entries
+ *
+ * Records are stored in the same format as in the DBC files they came from,
+ * other than string offsets, which point into a single string block that's
+ * shared by every DBC in the bundle. Each DBC with a primary key has an
+ * index table mapping IDs to record positions, so lookups (and resolving
+ * references between DBCs) don't require building anything at load time.
+ */
+namespace ember::dbc {
+
+namespace be = boost::endian;
+
+constexpr std::uint32_t BUNDLE_MAGIC = util::make_mcc("EDBB");
+constexpr std::uint32_t BUNDLE_VERSION = 1;
+constexpr std::size_t BUNDLE_NAME_LEN = 48;
+
+enum class BundleIndex : std::uint32_t {
+	NONE,   // records are found by their position
+	DENSE,  // slot per ID in [base, base + size), holding the record position + 1 or 0 if absent
+	SORTED  // BundleIndexEntry per record, sorted by ID
+};
+
+#pragma pack(push, 1)
+
+struct BundleHeader {
+	be::big_uint32_t magic;
+	be::little_uint32_t version;
+	be::little_uint32_t checksum; // FNV-1a of everything following the header
+	be::little_uint32_t size;     // total size of the bundle, including the header
+	be::little_uint32_t dbcs;
+	be::little_uint32_t string_block_offset;
+	be::little_uint32_t string_block_len;
+};
+
+struct BundleEntry {
+	char name[BUNDLE_NAME_LEN]; // null-terminated
+	be::little_uint32_t records;
+	be::little_uint32_t fields;
+	be::little_uint32_t record_size;
+	be::little_uint32_t records_offset;
+	be::little_uint32_t index_type;
+	be::little_uint32_t index_base;
+	be::little_uint32_t index_size;
+	be::little_uint32_t index_offset;
+};
+
+struct BundleIndexEntry {
+	be::little_uint32_t id;
+	be::little_uint32_t position;
+};
+
+#pragma pack(pop)
+
+} // dbc, ember
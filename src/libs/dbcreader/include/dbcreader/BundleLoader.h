@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/util/StringHash.h>
+#include <dbcreader/Bundle.h>
+#include <dbcreader/MappedStorage.h>
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <concepts>
+#include <functional>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace ember::dbc {
+
+/*
+ * Uses DBCs directly from a bundle built by dbc-parser --bundle, producing
+ * the same storage as MappedLoader. Loading only maps the bundle and
+ * validates its header, rather than parsing each DBC. The returned storage
+ * must outlive any records or strings taken from it. See DBCView and
+ * BundleFormat.h for details.
+ */
+class BundleLoader final {
+	using DBCMapFunc = std::function<void(MappedStorage&, const Bundle&)>;
+	using LogCB = std::function<void(const std::string&)>;
+
+	const LogCB log_cb_;
+	const std::string path_;
+	const Bundle::Checksum checksum_;
+	boost::unordered_flat_map<std::string, DBCMapFunc, StringHash, std::equal_to<>> dbc_map;
+
+	MappedStorage load_from(const Bundle& bundle, std::span<const std::string_view> whitelist) const;
+
+public:
+	BundleLoader(std::string path, LogCB log_cb = [](const std::string&){},
+	             Bundle::Checksum checksum = Bundle::Checksum::VERIFY);
+
+	MappedStorage load(std::convertible_to<std::string_view> auto&& ...whitelist) const {
+		std::initializer_list<std::string_view> list { whitelist... };
+		return load({ list.begin(), list.end() });
+	}
+
+	// loads every DBC in the bundle
+	MappedStorage load() const;
+	MappedStorage load(std::span<const std::string_view> whitelist) const;
+};
+
+} // dbc, ember
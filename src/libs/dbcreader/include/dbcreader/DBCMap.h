@@ -8,61 +8,245 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <ranges>
 #include <type_traits>
+#include <utility>
+#include <vector>
 #include <cstdint>
 #include <cstddef>
-#include <boost/container/flat_map.hpp>
 
 namespace ember::dbc {
 
+/*
+ * Records are stored in one of two layouts, chosen by reserve() before
+ * any records are added:
+ *
+ * Dense - each ID maps directly to a slot in an array, with a bitmap
+ * marking the slots that are occupied. Used when the ID range is compact.
+ *
+ * Sparse - records are kept sorted by ID and found with a binary search.
+ * Used when the IDs are too spread out for the dense layout to be worth
+ * the memory, or when reserve() hasn't been called.
+ *
+ * Both layouts iterate in ID order.
+ */
 template<typename T>
 class DBCMap final {
-	boost::container::flat_map<std::size_t, T> storage;
+public:
+	using value_type = std::pair<std::size_t, T>;
+
+	// the most slots the dense layout may use per record
+	static constexpr std::size_t MAX_DENSE_RATIO = 4;
+
+private:
+	template<bool Const>
+	class Iterator {
+		using Map = std::conditional_t<Const, const DBCMap, DBCMap>;
+
+		Map* map_ = nullptr;
+		std::size_t pos_ = 0;
+
+		void skip() {
+			while(pos_ < map_->slots_.size() && !map_->occupied(pos_)) {
+				++pos_;
+			}
+		}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = DBCMap::value_type;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::conditional_t<Const, const value_type&, value_type&>;
+		using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+		Iterator() = default;
+
+		Iterator(Map* map, std::size_t pos) : map_(map), pos_(pos) {
+			skip();
+		}
+
+		operator Iterator<true>() const requires (!Const) {
+			return { map_, pos_ };
+		}
+
+		reference operator*() const {
+			return map_->slots_[pos_];
+		}
+
+		pointer operator->() const {
+			return &map_->slots_[pos_];
+		}
+
+		Iterator& operator++() {
+			++pos_;
+			skip();
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			auto it = *this;
+			++*this;
+			return it;
+		}
+
+		bool operator==(const Iterator& rhs) const {
+			return pos_ == rhs.pos_;
+		}
+	};
+
+	std::vector<value_type> slots_;
+	std::vector<bool> present_;
+	std::size_t base_ = 0;
+	std::size_t count_ = 0;
+	bool dense_ = false;
+
+	bool occupied(std::size_t pos) const {
+		return !dense_ || present_[pos];
+	}
+
+	void make_sparse() {
+		std::size_t out = 0;
+
+		for(std::size_t i = 0; i < slots_.size(); ++i) {
+			if(present_[i]) {
+				slots_[out++] = std::move(slots_[i]);
+			}
+		}
+
+		slots_.erase(slots_.begin() + out, slots_.end());
+		present_.clear();
+		dense_ = false;
+	}
+
+	template<typename... Args>
+	void emplace_sparse(std::size_t id, Args&&... args) {
+		// records are usually stored in ID order, so appending is the common case
+		if(slots_.empty() || slots_.back().first < id) {
+			slots_.emplace_back(std::piecewise_construct, std::forward_as_tuple(id),
+			                    std::forward_as_tuple(std::forward<Args>(args)...));
+			++count_;
+			return;
+		}
+
+		auto it = std::ranges::lower_bound(slots_, id, {}, &value_type::first);
+
+		if(it->first == id) {
+			return;
+		}
+
+		slots_.emplace(it, std::piecewise_construct, std::forward_as_tuple(id),
+		               std::forward_as_tuple(std::forward<Args>(args)...));
+		++count_;
+	}
 
 public:
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	/*
+	 * Selects the layout from the range of IDs that will be stored,
+	 * [first_id, last_id], and the number of records. Must be called
+	 * before any records are added.
+	 */
+	void reserve(std::size_t first_id, std::size_t last_id, std::size_t records) {
+		slots_.clear();
+		present_.clear();
+		count_ = 0;
+		dense_ = false;
+
+		if constexpr(std::is_default_constructible_v<T>) {
+			const auto range = last_id - first_id + 1;
+
+			if(records && first_id <= last_id && range <= records * MAX_DENSE_RATIO) {
+				slots_.resize(range);
+				present_.resize(range);
+				base_ = first_id;
+				dense_ = true;
+				return;
+			}
+		}
+
+		slots_.reserve(records);
+	}
+
 	template<typename... Args>
-	inline void emplace_back(std::size_t id, Args&&... args) {
-		storage.emplace(id, std::forward<Args>(args)...);
+	void emplace_back(std::size_t id, Args&&... args) {
+		if(dense_) {
+			if(id - base_ >= slots_.size()) [[unlikely]] {
+				make_sparse();
+				emplace_sparse(id, std::forward<Args>(args)...);
+				return;
+			}
+
+			const auto pos = id - base_;
+
+			if(present_[pos]) {
+				return;
+			}
+
+			slots_[pos].first = id;
+			slots_[pos].second = T(std::forward<Args>(args)...);
+			present_[pos] = true;
+			++count_;
+			return;
+		}
+
+		emplace_sparse(id, std::forward<Args>(args)...);
 	}
 
-	inline const T* operator[](std::size_t index) const {
-		auto it = storage.find(index);
-		
-		if(it == storage.end()) {
+	const T* operator[](std::size_t index) const {
+		if(dense_) {
+			const auto pos = index - base_;
+
+			if(pos >= slots_.size() || !present_[pos]) {
+				return nullptr;
+			}
+
+			return &slots_[pos].second;
+		}
+
+		auto it = std::ranges::lower_bound(slots_, index, {}, &value_type::first);
+
+		if(it == slots_.end() || it->first != index) {
 			return nullptr;
 		}
 
 		return &it->second;
 	}
 
-	inline auto begin() const {
-		return storage.begin();
+	const_iterator begin() const {
+		return { this, 0 };
 	}
 
-	inline auto end() const {
-		return storage.end();
+	const_iterator end() const {
+		return { this, slots_.size() };
 	}
 
-	inline auto begin() {
-		return storage.begin();
+	iterator begin() {
+		return { this, 0 };
 	}
 
-	inline auto end() {
-		return storage.end();
+	iterator end() {
+		return { this, slots_.size() };
 	}
 
 	auto values() const {
-		return storage | std::views::values;
+		return *this | std::views::values;
+	}
+
+	auto values() {
+		return *this | std::views::values;
 	}
 
-	auto values()  {
-		return storage | std::views::values;
+	std::size_t size() const {
+		return count_;
 	}
 
-	auto size() const {
-		return storage.size();
+	bool dense() const {
+		return dense_;
 	}
 };
 
-} // dbc, ember
\ No newline at end of file
+} // dbc, ember
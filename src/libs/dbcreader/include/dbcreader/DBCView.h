@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <dbcreader/Bundle.h>
+#include <dbcreader/DBCHeader.h>
+#include <dbcreader/DBCMap.h>
+#include <dbcreader/Validation.h>
+#include <shared/util/polyfill/start_lifetime_as>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/endian/arithmetic.hpp>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+namespace ember::dbc {
+
+/*
+ * Read-only view of a DBC file that's mapped into memory. Records are
+ * used in their on-disk format (see DiskDefs.h) rather than being copied
+ * into memory structs and strings are views into the file's string block,
+ * so processes that map the same file share its pages.
+ *
+ * References to other DBCs aren't resolved - look the ID up in the
+ * referenced DBC's view instead.
+ *
+ * Views may be opened from individual DBC files, in which case the ID index
+ * is built as the file is opened, or from a bundle, which carries prebuilt
+ * indices.
+ */
+template<typename Record>
+class DBCView final {
+	enum class Index {
+		NONE, MAP, DENSE, SORTED
+	};
+
+	std::shared_ptr<const boost::interprocess::mapped_region> region_;
+	std::span<const Record> records_;
+	std::string_view strings_;
+	Index index_type_ = Index::NONE;
+	DBCMap<std::uint32_t> index_;
+	std::span<const boost::endian::little_uint32_t> dense_;
+	std::span<const BundleIndexEntry> sorted_;
+	std::size_t dense_base_ = 0;
+
+	// definitions without any fields still produce a struct but have zero byte records
+	static constexpr std::size_t RECORD_SIZE = std::is_empty_v<Record>? 0 : sizeof(Record);
+
+	DBCView(const std::string& path, const char* name, std::size_t fields) {
+		namespace bi = boost::interprocess;
+
+		bi::file_mapping file(path.c_str(), bi::read_only);
+		auto region = std::make_shared<bi::mapped_region>(file, bi::read_only);
+
+		const auto data = static_cast<const char*>(region->get_address());
+		const auto header = std::start_lifetime_as<const DBCHeader>(data);
+		detail::validate_dbc(name, header, RECORD_SIZE, fields, region->get_size());
+
+		const auto records = std::start_lifetime_as<const Record>(data + sizeof(DBCHeader));
+		records_ = { records, header->records };
+		strings_ = { data + sizeof(DBCHeader) + (RECORD_SIZE * records_.size()), header->string_block_len };
+		region_ = std::move(region);
+	}
+
+	const Record* at(std::size_t position) const {
+		return position < records_.size()? &records_[position] : nullptr;
+	}
+
+public:
+	DBCView() = default;
+
+	// for DBCs without a primary key, where records are found by their index
+	static DBCView open(const std::string& path, const char* name, std::size_t fields) {
+		return DBCView(path, name, fields);
+	}
+
+	template<typename Key>
+	static DBCView open(const std::string& path, const char* name, std::size_t fields, Key key) {
+		DBCView view(path, name, fields);
+		view.index_type_ = Index::MAP;
+
+		std::size_t first = std::numeric_limits<std::size_t>::max();
+		std::size_t last = 0;
+
+		for(const auto& record : view.records_) {
+			const std::size_t id = key(record);
+			first = std::min(first, id);
+			last = std::max(last, id);
+		}
+
+		view.index_.reserve(first, last, view.records_.size());
+
+		for(std::uint32_t i = 0; i < view.records_.size(); ++i) {
+			view.index_.emplace_back(key(view.records_[i]), i);
+		}
+
+		return view;
+	}
+
+	static DBCView open(const Bundle& bundle, const char* name, std::size_t fields) {
+		const auto entry = bundle.find(name);
+
+		if(!entry) {
+			std::stringstream err;
+			err << name << ": " << "Not present in the bundle";
+			throw std::runtime_error(err.str());
+		}
+
+		if(entry->record_size != RECORD_SIZE || entry->fields != fields) {
+			std::stringstream err;
+			err << name << ": " << "Expected " << fields << " fields, " << RECORD_SIZE << " byte records "
+			    << "but bundle has " << entry->fields << " fields and " << entry->record_size << " byte records";
+			throw std::runtime_error(err.str());
+		}
+
+		DBCView view;
+		view.region_ = bundle.region();
+		view.records_ = { std::start_lifetime_as<const Record>(bundle.data(entry->records_offset)), entry->records };
+		view.strings_ = bundle.strings();
+
+		switch(static_cast<BundleIndex>(entry->index_type.value())) {
+			case BundleIndex::NONE:
+				break;
+			case BundleIndex::DENSE:
+				view.index_type_ = Index::DENSE;
+				view.dense_base_ = entry->index_base;
+				view.dense_ = {
+					std::start_lifetime_as<const boost::endian::little_uint32_t>(bundle.data(entry->index_offset)),
+					entry->index_size
+				};
+				break;
+			case BundleIndex::SORTED:
+				view.index_type_ = Index::SORTED;
+				view.sorted_ = {
+					std::start_lifetime_as<const BundleIndexEntry>(bundle.data(entry->index_offset)),
+					entry->index_size
+				};
+				break;
+		}
+
+		return view;
+	}
+
+	const Record* operator[](std::size_t id) const {
+		switch(index_type_) {
+			case Index::NONE:
+				return at(id);
+			case Index::MAP: {
+				const auto index = index_[id];
+				return index? &records_[*index] : nullptr;
+			}
+			case Index::DENSE: {
+				const auto slot = id - dense_base_;
+
+				if(slot >= dense_.size() || !dense_[slot]) {
+					return nullptr;
+				}
+
+				return at(dense_[slot] - 1);
+			}
+			case Index::SORTED: {
+				auto it = std::ranges::lower_bound(sorted_, id, {}, [](const BundleIndexEntry& entry) {
+					return std::size_t(entry.id);
+				});
+
+				if(it == sorted_.end() || it->id != id) {
+					return nullptr;
+				}
+
+				return at(it->position);
+			}
+		}
+
+		return nullptr;
+	}
+
+	// returns the string at the given offset into the string block
+	std::string_view string(std::uint32_t offset) const {
+		if(offset >= strings_.size()) {
+			return {};
+		}
+
+		const auto str = strings_.substr(offset);
+		return str.substr(0, str.find('\0'));
+	}
+
+	std::span<const Record> records() const {
+		return records_;
+	}
+
+	auto begin() const {
+		return records_.begin();
+	}
+
+	auto end() const {
+		return records_.end();
+	}
+
+	std::size_t size() const {
+		return records_.size();
+	}
+};
+
+} // dbc, ember
@@ -11,23 +11,31 @@
 #include <shared/util/StringHash.h>
 #include <dbcreader/Loader.h>
 #include <dbcreader/Storage.h>
+#include <dbcreader/Timing.h>
 #include <boost/unordered/unordered_flat_map.hpp>
 #include <concepts>
 #include <functional>
 #include <memory>
 
-namespace ember::dbc {
+namespace ember {
+
+class ThreadPool;
+
+namespace dbc {
 
 class DiskLoader final : public Loader {
 	using DBCLoadFunc = std::function<void(Storage&, const std::string&)>;
 	using LogCB = std::function<void(const std::string&)>;
 
 	const LogCB log_cb_;
+	const TimingCB timing_cb_;
 	const std::string dir_path_;
 	boost::unordered_flat_map<std::string, DBCLoadFunc, StringHash, std::equal_to<>> dbc_map;
 
+	const DBCLoadFunc& loader(std::string_view dbc) const;
+
 public:
-	DiskLoader(std::string dir_path, LogCB log_cb = [](const std::string&){});
+	DiskLoader(std::string dir_path, LogCB log_cb = [](const std::string&){}, TimingCB timing_cb = {});
 	~DiskLoader() = default;
 
 	Storage load(std::convertible_to<std::string_view> auto&& ...whitelist) const {
@@ -35,8 +43,20 @@ public:
 		return load({ list.begin(), list.end() });
 	}
 
+	Storage load(ThreadPool& pool, std::convertible_to<std::string_view> auto&& ...whitelist) const {
+		std::initializer_list<std::string_view> list { whitelist... };
+		return load({ list.begin(), list.end() }, pool);
+	}
+
 	Storage load() const override;
 	Storage load(std::span<const std::string_view> whitelist) const override;
+
+	/*
+	 * Each DBC is written to its own map, so they're loaded concurrently,
+	 * with the calling thread helping out
+	 */
+	Storage load(ThreadPool& pool) const;
+	Storage load(std::span<const std::string_view> whitelist, ThreadPool& pool) const;
 };
 
-} // dbc, ember
\ No newline at end of file
+}} // dbc, ember
\ No newline at end of file
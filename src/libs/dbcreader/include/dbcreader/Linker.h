@@ -8,10 +8,22 @@
 
 #pragma once
 
-namespace ember::dbc {
+#include <dbcreader/Timing.h>
+
+namespace ember {
+
+class ThreadPool;
+
+namespace dbc {
 
 struct Storage;
 
-void link(Storage& storage);
+void link(Storage& storage, const TimingCB& timing_cb = {});
+
+/*
+ * Linking a DBC only writes to its own records and only looks up the
+ * records it references, so every DBC can be linked independently
+ */
+void link(Storage& storage, ThreadPool& pool, const TimingCB& timing_cb = {});
 
-} // dbc, ember
\ No newline at end of file
+}} // dbc, ember
\ No newline at end of file
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/util/StringHash.h>
+#include <dbcreader/MappedStorage.h>
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <concepts>
+#include <functional>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace ember::dbc {
+
+/*
+ * Maps DBC files rather than copying their records into memory structs,
+ * for read-only use. The returned storage must outlive any records or
+ * strings taken from it. See DBCView for details.
+ */
+class MappedLoader final {
+	using DBCMapFunc = std::function<void(MappedStorage&, const std::string&)>;
+	using LogCB = std::function<void(const std::string&)>;
+
+	const LogCB log_cb_;
+	const std::string dir_path_;
+	boost::unordered_flat_map<std::string, DBCMapFunc, StringHash, std::equal_to<>> dbc_map;
+
+public:
+	MappedLoader(std::string dir_path, LogCB log_cb = [](const std::string&){});
+
+	MappedStorage load(std::convertible_to<std::string_view> auto&& ...whitelist) const {
+		std::initializer_list<std::string_view> list { whitelist... };
+		return load({ list.begin(), list.end() });
+	}
+
+	MappedStorage load() const;
+	MappedStorage load(std::span<const std::string_view> whitelist) const;
+};
+
+} // dbc, ember
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string_view>
+
+namespace ember::dbc {
+
+// reports how long a stage (loading, linking) took for each DBC
+using TimingCB = std::function<void(std::string_view dbc, std::chrono::nanoseconds elapsed)>;
+
+} // dbc, ember
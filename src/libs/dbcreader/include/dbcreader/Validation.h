@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2014 - 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <dbcreader/DBCHeader.h>
+#include <sstream>
+#include <stdexcept>
+#include <cstddef>
+
+namespace ember::dbc::detail {
+
+inline void validate_dbc(const char* name, const DBCHeader* header, std::size_t expect_size,
+                         std::size_t expect_fields, std::size_t dbc_size) {
+	if(dbc_size < sizeof(DBCHeader)) {
+		std::stringstream err;
+		err << name << ": " << "File is too small to hold a header (" << dbc_size << " bytes)";
+		throw std::runtime_error(err.str());
+	}
+
+	if(header->magic != DBC_MAGIC) {
+		std::stringstream err;
+		err << name << ": " << "Invalid header magic - found 0x" << std::hex << header->magic
+		    << ", expected 0x" << DBC_MAGIC;
+		throw std::runtime_error(err.str());
+	}
+
+	if(header->record_size != expect_size || header->fields != expect_fields) {
+		std::stringstream err;
+		err << name << ": " << "Expected " << expect_fields << " fields, " << expect_size << " byte records "
+		    << "but DBC has " << header->fields << " fields and " << header->record_size << " byte records";
+		throw std::runtime_error(err.str());
+	}
+
+	std::size_t calculated_size = sizeof(DBCHeader) + header->string_block_len
+	                              + (header->record_size * header->records);
+
+	if(calculated_size != dbc_size) {
+		std::stringstream err;
+		err << name << ": " << "Invalid size! Expected " << calculated_size << " bytes but the file was "
+		    << dbc_size << " bytes";
+		throw std::runtime_error(err.str());
+	}
+}
+
+} // detail, dbc, ember
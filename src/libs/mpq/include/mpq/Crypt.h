@@ -8,11 +8,14 @@
 
 #pragma once
 
+#include <mpq/SharedDefs.h>
 #include <shared/util/polyfill/start_lifetime_as>
 #include <array>
 #include <bit>
 #include <span>
+#include <string_view>
 #include <cctype>
+#include <cstddef>
 #include <cstdint>
 
 // Thanks to https://www.zezula.net/en/mpq/techinfo.html for these time-savers
@@ -67,4 +70,28 @@ static constexpr std::uint32_t hash_string(std::string_view key, std::uint32_t t
 	return seed1;
 }
 
+struct NameHash {
+	std::uint32_t a;
+	std::uint32_t b;
+
+	auto operator<=>(const NameHash&) const = default;
+};
+
+// computes the name A and B hashes in a single pass, rather than using hash_string twice
+static NameHash hash_name(std::string_view key) {
+	static constexpr auto table = crypt_table();
+	std::uint32_t a1 = 0x7FED7FED, a2 = 0xEEEEEEEE;
+	std::uint32_t b1 = 0x7FED7FED, b2 = 0xEEEEEEEE;
+
+	for(auto byte : key) {
+		const auto ch = std::toupper(byte);
+		a1 = table[(MPQ_HASH_NAME_A << 8) + ch] ^ (a1 + a2);
+		a2 = ch + a1 + a2 + (a2 << 5) + 3;
+		b1 = table[(MPQ_HASH_NAME_B << 8) + ch] ^ (b1 + b2);
+		b2 = ch + b1 + b2 + (b2 << 5) + 3;
+	}
+
+	return { a1, b1 };
+}
+
 } // v0, mpq, ember
\ No newline at end of file
@@ -28,6 +28,7 @@ constexpr std::uint32_t MPQ_HASH_TABLE_INDEX = 0;
 constexpr std::uint32_t MPQ_HASH_NAME_A = 1;
 constexpr std::uint32_t MPQ_HASH_NAME_B = 2;
 constexpr std::uint32_t MPQ_HASH_FILE_KEY = 3;
+constexpr std::uint16_t LOCALE_NEUTRAL = 0;
 constexpr std::uint32_t BLOCK_SIZE = 0x200;
 constexpr std::uint32_t SECTOR_SIZE_HINT = 0x200 << 3;
 
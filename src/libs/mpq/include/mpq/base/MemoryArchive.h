@@ -9,40 +9,82 @@
 #pragma once
 
 #include <mpq/base/Archive.h>
+#include <mpq/Crypt.h>
+#include <mpq/Exception.h>
+#include <expected>
 #include <filesystem>
+#include <functional>
+#include <span>
 #include <string>
 #include <vector>
 
+namespace ember {
+
+class ThreadPool;
+
+} // ember
+
 namespace ember::mpq {
 
 class ExtractionSink;
 
 class MemoryArchive : public Archive {
+public:
+	using ExtractResult = std::expected<std::span<const std::byte>, exception>;
+	using ExtractHandler = std::function<void(const std::string& path, ExtractResult result)>;
+
 protected:
+	struct IndexEntry {
+		NameHash hash;
+		std::uint16_t locale;
+		std::uint32_t index;
+	};
+
 	std::span<std::byte> buffer_;
 	std::span<BlockTableEntry> block_table_;
 	std::span<HashTableEntry> hash_table_;
 	const v0::Header* header_;
 	std::vector<std::string> files_;
+	std::vector<IndexEntry> index_;
 	
 	void validate();
-	void load_listfile(std::uint64_t fpos_hi);
+	void build_index();
+	void load_listfile();
 	void parse_listfile(std::string buffer);
+	std::size_t find(const NameHash& hash, std::uint16_t locale, bool fallback) const;
+
+	virtual std::uint64_t file_position_hi(std::size_t index) const;
+	std::uint32_t file_key(const std::filesystem::path& path, const BlockTableEntry& entry) const;
+	std::vector<std::uint32_t> sector_table(const BlockTableEntry& entry, std::uint32_t key,
+	                                        std::uint64_t fpos_hi) const;
 
-	void extract_compressed(BlockTableEntry& entry, std::uint32_t key,
-	                        std::uint64_t fpos_hi, ExtractionSink& store);
+	std::span<const std::byte> file_data(const BlockTableEntry& entry, std::uint64_t fpos_hi,
+	                                     std::uint32_t offset, std::uint32_t size) const;
 
-	void extract_uncompressed(BlockTableEntry& entry, std::uint32_t key,
-	                          std::uint64_t fpos_hi, ExtractionSink& store);
+	void extract(const BlockTableEntry& entry, std::uint32_t key,
+	             std::uint64_t fpos_hi, ExtractionSink& store) const;
 
-	void extract_file_ext(const std::filesystem::path& path, ExtractionSink& store,
-	                      std::uint64_t fpos_hi);
+	void extract_compressed(const BlockTableEntry& entry, std::uint32_t key,
+	                        std::uint64_t fpos_hi, ExtractionSink& store) const;
 
-	void extract_single_unit(BlockTableEntry& entry, const std::uint32_t key,
-							 const std::uint64_t fpos_hi, ExtractionSink& store);
+	void extract_uncompressed(const BlockTableEntry& entry, std::uint32_t key,
+	                          std::uint64_t fpos_hi, ExtractionSink& store) const;
 
-	void extract_compressed_sector(std::span<const std::byte> input, std::span<std::byte> output,
-	                               Flags flags, ExtractionSink& store, int def_comp = -1);
+	void extract_file_ext(const std::filesystem::path& path, ExtractionSink& store) const;
+
+	std::size_t extract_parallel_ext(std::size_t index, const std::filesystem::path& path,
+	                                 std::span<std::byte> output, ThreadPool& pool) const;
+
+	void extract_single_unit(const BlockTableEntry& entry, std::uint32_t key,
+	                         std::uint64_t fpos_hi, ExtractionSink& store) const;
+
+	std::span<const std::byte> decode_sector(std::span<const std::byte> input,
+	                                         std::span<std::byte> output,
+	                                         Flags flags, std::uint32_t key,
+	                                         int def_comp = -1) const;
+
+	std::size_t decompress_sector(std::span<const std::byte> input, std::span<std::byte> output,
+	                              Flags flags, int def_comp = -1) const;
 
 	int default_compression(std::span<const std::uint32_t> sectors,
 	                        const std::byte* const offset,
@@ -56,11 +98,19 @@ public:
 	std::span<const BlockTableEntry> block_table() const override;
 	std::span<const HashTableEntry> hash_table() const override;
 	std::size_t file_lookup(std::string_view name, const std::uint16_t locale) const override;
+	std::vector<std::size_t> lookup_many(std::span<const std::string> names,
+	                                     std::uint16_t locale = 0) const;
 	std::span<std::uint32_t> file_sectors(const BlockTableEntry& entry);
 	std::span<const std::string> files() const override;
 	void files(std::span<std::string_view> files) override;
 	const BlockTableEntry& file_entry(std::size_t index) const override;
 	BlockTableEntry& file_entry(std::size_t index) override;
+
+	std::size_t extract_parallel(const std::filesystem::path& path, std::span<std::byte> output,
+	                             ThreadPool& pool) const;
+
+	void extract_files(std::span<const std::string> paths, ThreadPool& pool,
+	                   const ExtractHandler& handler) const;
 };
 
 
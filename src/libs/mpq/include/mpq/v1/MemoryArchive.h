@@ -24,6 +24,7 @@ class MemoryArchive : public mpq::MemoryArchive {
 	std::span<std::uint16_t> fetch_btable_hi_pos() const;
 	std::uint64_t high_mask(std::uint16_t value) const;
 	std::uint64_t extend(std::uint16_t hi, std::uint32_t lo) const;
+	std::uint64_t file_position_hi(std::size_t index) const override;
 
 public:
 	MemoryArchive(std::span<std::byte> buffer);
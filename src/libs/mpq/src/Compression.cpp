@@ -100,7 +100,7 @@ std::expected<std::size_t, int> decompress_zlib(std::span<const std::byte> input
 	auto dest = reinterpret_cast<Bytef*>(output.data());
 	auto src = reinterpret_cast<const Bytef*>(input.data());
 
-	auto ret = uncompress(dest, &dest_len, src + 1, input.size_bytes());
+	auto ret = uncompress(dest, &dest_len, src + 1, input.size_bytes() - 1);
 
 	if(ret != Z_OK) {
 		return std::unexpected(ret);
@@ -174,7 +174,7 @@ std::expected<std::size_t, int> do_decompression(std::span<const std::byte> inpu
 		case MPQ_COMPRESSION_BZIP2:
 			return decompress_bzip2(input, output);
 		case MPQ_COMPRESSION_PKWARE:
-			return decompress_pklib({ input.data() + 1, input.size_bytes() }, output);
+			return decompress_pklib(input.subspan(1), output);
 		case MPQ_COMPRESSION_ZLIB:
 			return decompress_zlib(input, output);
 		default:
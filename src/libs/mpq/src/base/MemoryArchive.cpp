@@ -13,12 +13,16 @@
 #include <mpq/MemorySink.h>
 #include <mpq/MPQ.h>
 #include <mpq/Structures.h>
+#include <shared/threading/ThreadPool.h>
 #include <shared/util/polyfill/start_lifetime_as>
 #include <boost/endian/conversion.hpp>
 #include <boost/container/small_vector.hpp>
+#include <algorithm>
 #include <bit>
 #include <iterator>
+#include <tuple>
 #include <cmath>
+#include <cstring>
 
 namespace ember::mpq {
 
@@ -28,20 +32,23 @@ MemoryArchive::MemoryArchive(std::span<std::byte> buffer)
 	validate();
 }
 
-void MemoryArchive::load_listfile(const std::uint64_t fpos_hi) {
-	auto index = file_lookup("(listfile)", 0);
+void MemoryArchive::load_listfile() {
+	const std::filesystem::path path("(listfile)");
+	const auto index = file_lookup(path.string(), 0);
 
 	if(index == npos) {
 		return;
 	}
 	
 	const auto& entry = file_entry(index);
+	const auto key = file_key(path, entry);
+	const auto fpos_hi = file_position_hi(index);
 
 	std::string buffer;
 
 	buffer.resize_and_overwrite(entry.uncompressed_size, [&](char* strbuf, std::size_t size) {
 		MemorySink sink(std::as_writable_bytes(std::span(strbuf, size)));
-		extract_file_ext("(listfile)", sink, fpos_hi);
+		extract(entry, key, fpos_hi, sink);
 		return size;
 	});
 
@@ -64,34 +71,71 @@ int MemoryArchive::version() const {
 	return boost::endian::little_to_native(header_->format_version);
 }
 
-std::size_t MemoryArchive::file_lookup(std::string_view name, const std::uint16_t locale) const {
-	const auto table = hash_table();
-	auto index = hash_string(name, MPQ_HASH_TABLE_INDEX);
+/*
+ * Indexes the hash table by name hash so that lookups don't have to
+ * compute the table index hash or probe the table. Deleted and out of
+ * range entries are skipped.
+ */
+void MemoryArchive::build_index() {
+	index_.clear();
+	index_.reserve(hash_table_.size());
 
-	if(!table.empty()) {
-		index %= table.size();
-	}
-	
-	if(table[index].block_index == MPQ_HASH_ENTRY_EMPTY) {
-		return npos;
+	for(std::size_t i = 0; i < hash_table_.size(); ++i) {
+		const auto& entry = hash_table_[i];
+
+		if(entry.block_index >= block_table_.size()) {
+			continue;
+		}
+
+		index_.emplace_back(NameHash{ entry.name_1, entry.name_2 }, entry.locale,
+		                    static_cast<std::uint32_t>(i));
 	}
 
-	const auto name_key_a = hash_string(name, MPQ_HASH_NAME_A);
-	const auto name_key_b = hash_string(name, MPQ_HASH_NAME_B);
-	const auto end = (index - 1) > table.size()? table.size() : index - 1;
+	std::ranges::sort(index_, [](const IndexEntry& lhs, const IndexEntry& rhs) {
+		return std::tie(lhs.hash, lhs.locale, lhs.index) < std::tie(rhs.hash, rhs.locale, rhs.index);
+	});
+}
 
-	for(auto i = index; i != end; ++i, i %= table.size()) {
-		if(table[i].block_index == MPQ_HASH_ENTRY_EMPTY) {
-			return npos;
+/*
+ * Returns the hash table index for the file with the given locale or,
+ * if requested and there's no such file, the locale neutral version
+ */
+std::size_t MemoryArchive::find(const NameHash& hash, const std::uint16_t locale,
+                                const bool fallback) const {
+	const auto [begin, end] = std::ranges::equal_range(index_, hash, {}, &IndexEntry::hash);
+	std::size_t neutral = npos;
+
+	for(auto it = begin; it != end; ++it) {
+		if(it->locale == locale) {
+			return it->index;
 		}
 
-		if(table[i].name_1 == name_key_a && table[i].name_2 == name_key_b
-		   && table[i].locale == locale) {
-			return i;
+		if(it->locale == LOCALE_NEUTRAL && neutral == npos) {
+			neutral = it->index;
 		}
 	}
 
-	return npos;
+	return fallback? neutral : npos;
+}
+
+std::size_t MemoryArchive::file_lookup(std::string_view name, const std::uint16_t locale) const {
+	return find(hash_name(name), locale, false);
+}
+
+/*
+ * Resolves many paths at once, returning the hash table index for each or
+ * npos if the file doesn't exist. Files that don't exist for the requested
+ * locale fall back to the locale neutral version, if there is one.
+ */
+std::vector<std::size_t> MemoryArchive::lookup_many(std::span<const std::string> names,
+                                                    const std::uint16_t locale) const {
+	std::vector<std::size_t> indices(names.size());
+
+	for(std::size_t i = 0; i < names.size(); ++i) {
+		indices[i] = find(hash_name(names[i]), locale, true);
+	}
+
+	return indices;
 }
 
 std::span<std::uint32_t> MemoryArchive::file_sectors(const BlockTableEntry& entry) {
@@ -108,24 +152,77 @@ std::span<std::uint32_t> MemoryArchive::file_sectors(const BlockTableEntry& entr
 	return { sector_begin, count };
 }
 
+std::uint64_t MemoryArchive::file_position_hi(std::size_t) const {
+	return 0;
+}
+
+std::uint32_t MemoryArchive::file_key(const std::filesystem::path& path,
+                                      const BlockTableEntry& entry) const {
+	auto key = hash_string(path.filename().string(), MPQ_HASH_FILE_KEY);
+
+	if(entry.flags & MPQ_FILE_FIX_KEY) {
+		key = (key + entry.file_position) ^ entry.uncompressed_size;
+	}
+
+	return key;
+}
+
+/*
+ * Returns a view of the file's data within the archive, checking that
+ * it's in bounds. The archive is never modified during extraction, so
+ * it's safe to extract files from multiple threads at once
+ */
+std::span<const std::byte> MemoryArchive::file_data(const BlockTableEntry& entry,
+                                                    const std::uint64_t fpos_hi,
+                                                    const std::uint32_t offset,
+                                                    const std::uint32_t size) const {
+	const std::uint64_t begin = (entry.file_position | fpos_hi) + offset;
+
+	if(begin + size < begin || buffer_.size_bytes() < begin + size) {
+		throw exception("cannot extract file: file out of bounds");
+	}
+
+	return { buffer_.data() + begin, size };
+}
+
+std::vector<std::uint32_t> MemoryArchive::sector_table(const BlockTableEntry& entry,
+                                                       const std::uint32_t key,
+                                                       const std::uint64_t fpos_hi) const {
+	const auto sector_size = BLOCK_SIZE << header_->block_size_shift;
+	const auto count = (entry.uncompressed_size + sector_size - 1) / sector_size + 1;
+	const auto data = file_data(entry, fpos_hi, 0, count * sizeof(std::uint32_t));
+
+	// decrypt a copy rather than the archive itself
+	std::vector<std::uint32_t> sectors(count);
+	std::memcpy(sectors.data(), data.data(), data.size_bytes());
+
+	if(entry.flags & Flags::MPQ_FILE_ENCRYPTED) {
+		decrypt_block(std::as_writable_bytes(std::span(sectors)), key);
+	}
+
+	for(std::size_t i = 1; i < sectors.size(); ++i) {
+		if(sectors[i] < sectors[i - 1]) {
+			throw exception("cannot extract file: bad sector table");
+		}
+	}
+
+	return sectors;
+}
+
 void MemoryArchive::extract_file_ext(const std::filesystem::path& path,
-                                     ExtractionSink& store,
-                                     const std::uint64_t fpos_hi) {
-	auto index = file_lookup(path.string(), 0);
+                                     ExtractionSink& store) const {
+	const auto index = file_lookup(path.string(), 0);
 
 	if(index == npos) {
 		throw exception("cannot extract file: file not found");
 	}
 
-	const auto filename = path.filename().string();
-	auto& entry = file_entry(index);
-	auto key = hash_string(filename, MPQ_HASH_FILE_KEY);
-
-	if(entry.flags & MPQ_FILE_FIX_KEY) {
-		key = (key + entry.file_position) ^ entry.uncompressed_size;
-		entry.flags = static_cast<Flags>(entry.flags & ~Flags::MPQ_FILE_FIX_KEY);
-	}
+	const auto& entry = file_entry(index);
+	extract(entry, file_key(path, entry), file_position_hi(index), store);
+}
 
+void MemoryArchive::extract(const BlockTableEntry& entry, const std::uint32_t key,
+                            const std::uint64_t fpos_hi, ExtractionSink& store) const {
 	if(buffer_.size_bytes() < (entry.file_position + fpos_hi) + entry.compressed_size) {
 		throw exception("cannot extract file: file out of bounds");
 	}
@@ -137,78 +234,61 @@ void MemoryArchive::extract_file_ext(const std::filesystem::path& path,
 	} else {
 		extract_uncompressed(entry, key, fpos_hi, store);
 	}
-
-	entry.flags = static_cast<Flags>(entry.flags & ~Flags::MPQ_FILE_ENCRYPTED);
 }
 
-void MemoryArchive::extract_compressed(BlockTableEntry& entry,
-                                       std::uint32_t key,
+void MemoryArchive::extract_compressed(const BlockTableEntry& entry,
+                                       const std::uint32_t key,
                                        const std::uint64_t fpos_hi,
-                                       ExtractionSink& store) {
-	auto max_sector_size = BLOCK_SIZE << header_->block_size_shift;
+                                       ExtractionSink& store) const {
+	const auto max_sector_size = BLOCK_SIZE << header_->block_size_shift;
 	const auto file_offset = buffer_.data() + (entry.file_position | fpos_hi);
-
-	auto sectors = file_sectors(entry);
-
-	// decrypt the sector block if required
-	if(entry.flags & Flags::MPQ_FILE_ENCRYPTED) {
-		decrypt_block(std::as_writable_bytes(sectors), --key);
-	}
-
-	std::size_t ignore_count = 1;
-
-	if(entry.flags & Flags::MPQ_FILE_SECTOR_CRC) {
-		++ignore_count;
-	}
-
-	sectors = std::span(sectors.begin(), sectors.end() - ignore_count);
+	const auto sectors = sector_table(entry, key - 1, fpos_hi);
+	const int def_comp = default_compression(sectors, file_offset, entry.uncompressed_size);
 	auto remaining = entry.uncompressed_size;
 
 	boost::container::small_vector<std::byte, SECTOR_SIZE_HINT> buffer(
 		max_sector_size, boost::container::default_init
 	);
 
-	const int def_comp = default_compression(sectors, file_offset, entry.uncompressed_size);
-
-	for(auto sector = sectors.begin(); sector != sectors.end(); ++sector) {
-		std::uint32_t sector_size_actual = max_sector_size;
-		std::uint32_t sector_size = max_sector_size;
-
-		// if we're at the end of the file and need to read less
-		if(max_sector_size > remaining) {
-			sector_size = remaining;
-			sector_size_actual = remaining;
-		}
-		
-		// sector is compressed, get the actual data size
-		if(entry.flags & Flags::MPQ_FILE_COMPRESS_MASK) {
-			sector_size_actual =  *std::next(sector) - *sector;
-		}
-
-		// get the location of the data for this sector
-		std::span sector_data(
-			std::start_lifetime_as<std::byte>(file_offset + *sector), sector_size_actual
-		);
-
-		if(entry.flags & Flags::MPQ_FILE_ENCRYPTED) {
-			decrypt_block(sector_data, ++key);
-		}
+	for(std::size_t i = 0; i + 1 < sectors.size(); ++i) {
+		const auto sector_size = std::min(max_sector_size, remaining);
+		const auto input = file_data(entry, fpos_hi, sectors[i], sectors[i + 1] - sectors[i]);
+		const std::span output(buffer.data(), sector_size);
+		store(decode_sector(input, output, entry.flags, key + i, def_comp));
+		remaining -= sector_size;
+	}
+}
 
-		if(sector_size_actual < sector_size) {
-			extract_compressed_sector(sector_data, buffer, entry.flags, store, def_comp);
-		} else {
-			store(sector_data);
-		}
+/*
+ * Decrypts and decompresses a single sector. The result is a view of either
+ * the output buffer or, for sectors that are stored as-is, the input. If the
+ * sector has to be decrypted, the input is first copied into a scratch
+ * buffer that remains valid until the calling thread's next call
+ */
+std::span<const std::byte> MemoryArchive::decode_sector(std::span<const std::byte> input,
+                                                        std::span<std::byte> output,
+                                                        const Flags flags,
+                                                        const std::uint32_t key,
+                                                        const int def_comp) const {
+	if(flags & Flags::MPQ_FILE_ENCRYPTED) {
+		thread_local std::vector<std::byte> scratch;
+		scratch.resize(input.size_bytes());
+		std::memcpy(scratch.data(), input.data(), input.size_bytes());
+		decrypt_block(scratch, key);
+		input = scratch;
+	}
 
-		remaining -= sector_size;
+	if(input.size_bytes() < output.size_bytes()) {
+		return { output.data(), decompress_sector(input, output, flags, def_comp) };
 	}
+
+	return input.first(output.size_bytes());
 }
 
-void MemoryArchive::extract_compressed_sector(std::span<const std::byte> input,
-                                              std::span<std::byte> output,
-											  const Flags flags,
-                                              ExtractionSink& store,
-                                              const int def_comp) {
+std::size_t MemoryArchive::decompress_sector(std::span<const std::byte> input,
+                                             std::span<std::byte> output,
+                                             const Flags flags,
+                                             const int def_comp) const {
 	if(flags & Flags::MPQ_FILE_COMPRESS) {
 		auto ret = decompress(input, output, def_comp);
 
@@ -216,7 +296,7 @@ void MemoryArchive::extract_compressed_sector(std::span<const std::byte> input,
 			throw exception("cannot extract file: decompression failed");
 		}
 
-		store({ output.data(), *ret });
+		return *ret;
 	} else if(flags & Flags::MPQ_FILE_IMPLODE) {
 		auto ret = decompress_pklib(input, output);
 
@@ -224,39 +304,42 @@ void MemoryArchive::extract_compressed_sector(std::span<const std::byte> input,
 			throw exception("cannot extract file: decompression (explode) failed");
 		}
 
-		store({ output.data(), *ret });
+		return *ret;
 	} else {
 		throw exception("cannot extract file: unknown compression flag");
 	}
 }
 
-void MemoryArchive::extract_uncompressed(BlockTableEntry& entry,
+void MemoryArchive::extract_uncompressed(const BlockTableEntry& entry,
                                          const std::uint32_t key,
-										 const std::uint64_t fpos_hi,
-                                         ExtractionSink& store) {
-	const std::span data(
-		buffer_.data() + (entry.file_position | fpos_hi), entry.uncompressed_size
-	);
+                                         const std::uint64_t fpos_hi,
+                                         ExtractionSink& store) const {
+	const auto data = file_data(entry, fpos_hi, 0, entry.uncompressed_size);
 
-	if(entry.flags & Flags::MPQ_FILE_ENCRYPTED) {
-		decrypt_block(data, key);
+	if(!(entry.flags & Flags::MPQ_FILE_ENCRYPTED)) {
+		store(data);
+		return;
 	}
 
-	store(data);
+	std::vector<std::byte> buffer(data.begin(), data.end());
+	decrypt_block(buffer, key);
+	store(buffer);
 }
 
-void MemoryArchive::extract_single_unit(BlockTableEntry& entry, const std::uint32_t key,
-                                        const std::uint64_t fpos_hi, ExtractionSink& store) {
-	const std::span data(
-		buffer_.data() + (entry.file_position | fpos_hi), entry.uncompressed_size
-	);
+void MemoryArchive::extract_single_unit(const BlockTableEntry& entry, const std::uint32_t key,
+                                        const std::uint64_t fpos_hi, ExtractionSink& store) const {
+	auto data = file_data(entry, fpos_hi, 0, entry.compressed_size);
+	std::vector<std::byte> decrypted;
 
 	if(entry.flags & Flags::MPQ_FILE_ENCRYPTED) {
-		decrypt_block(data, key);
+		decrypted.assign(data.begin(), data.end());
+		decrypt_block(decrypted, key);
+		data = decrypted;
 	}
 
-	if(!(entry.flags & Flags::MPQ_FILE_COMPRESS_MASK)) {
-		store(data);
+	if(!(entry.flags & Flags::MPQ_FILE_COMPRESS_MASK)
+	   || entry.uncompressed_size == entry.compressed_size) {
+		store(data.first(std::min<std::size_t>(data.size_bytes(), entry.uncompressed_size)));
 		return;
 	}
 
@@ -264,11 +347,104 @@ void MemoryArchive::extract_single_unit(BlockTableEntry& entry, const std::uint3
 		entry.uncompressed_size, boost::container::default_init
 	);
 
-	if(entry.uncompressed_size != entry.compressed_size) {
-		extract_compressed_sector(data, buffer, entry.flags, store);
-	} else {
-		store(data);
+	store({ buffer.data(), decompress_sector(data, buffer, entry.flags) });
+}
+
+/*
+ * Extracts the file into the output buffer, which must be large enough to
+ * hold the uncompressed file. Sectors are decrypted and decompressed
+ * in parallel, straight into their final position in the output.
+ * 
+ * The calling thread shares the work with the pool rather than waiting
+ * on it, so this can be safely called from within one of its workers.
+ */
+std::size_t MemoryArchive::extract_parallel(const std::filesystem::path& path,
+                                            std::span<std::byte> output,
+                                            ThreadPool& pool) const {
+	const auto index = file_lookup(path.string(), 0);
+
+	if(index == npos) {
+		throw exception("cannot extract file: file not found");
+	}
+
+	return extract_parallel_ext(index, path, output, pool);
+}
+
+std::size_t MemoryArchive::extract_parallel_ext(const std::size_t index,
+                                                const std::filesystem::path& path,
+                                                std::span<std::byte> output,
+                                                ThreadPool& pool) const {
+	const auto& entry = file_entry(index);
+
+	if(output.size_bytes() < entry.uncompressed_size) {
+		throw exception("cannot extract file: output buffer too small");
+	}
+
+	const auto key = file_key(path, entry);
+	const auto fpos_hi = file_position_hi(index);
+	output = output.first(entry.uncompressed_size);
+
+	// nothing to be gained from splitting these up
+	if(entry.flags & MPQ_FILE_SINGLE_UNIT || !(entry.flags & MPQ_FILE_COMPRESS_MASK)) {
+		MemorySink sink(output);
+		extract(entry, key, fpos_hi, sink);
+		return sink.size();
 	}
+
+	const auto max_sector_size = BLOCK_SIZE << header_->block_size_shift;
+	const auto file_offset = buffer_.data() + (entry.file_position | fpos_hi);
+	const auto sectors = sector_table(entry, key - 1, fpos_hi);
+	const int def_comp = default_compression(sectors, file_offset, entry.uncompressed_size);
+
+	parallel_for(pool, sectors.size() - 1, [&](const std::size_t i) {
+		const auto offset = i * max_sector_size;
+		const auto sector = output.subspan(offset, std::min<std::size_t>(max_sector_size,
+		                                                                 output.size() - offset));
+		const auto input = file_data(entry, fpos_hi, sectors[i], sectors[i + 1] - sectors[i]);
+		const auto data = decode_sector(input, sector, entry.flags, key + i, def_comp);
+
+		if(data.size_bytes() != sector.size_bytes()) {
+			throw exception("cannot extract file: unexpected sector size");
+		}
+
+		if(data.data() != sector.data()) {
+			std::memcpy(sector.data(), data.data(), data.size_bytes());
+		}
+	});
+
+	return output.size_bytes();
+}
+
+/*
+ * Extracts each file into its own buffer, with the files themselves being
+ * extracted in parallel, as well as their sectors. The handler is invoked
+ * from whichever thread extracted the file and the data is only valid
+ * for the duration of the call.
+ */
+void MemoryArchive::extract_files(std::span<const std::string> paths, ThreadPool& pool,
+                                  const ExtractHandler& handler) const {
+	const auto indices = lookup_many(paths);
+
+	parallel_for(pool, paths.size(), [&](const std::size_t i) {
+		const auto& path = paths[i];
+		const auto index = indices[i];
+		std::vector<std::byte> buffer;
+
+		try {
+			if(index == npos) {
+				throw exception("cannot extract file: file not found");
+			}
+
+			buffer.resize(file_entry(index).uncompressed_size);
+			const auto size = extract_parallel_ext(index, path, buffer, pool);
+			buffer.resize(size);
+		} catch(const exception& e) {
+			handler(path, std::unexpected(e));
+			return;
+		}
+
+		handler(path, std::span<const std::byte>(buffer));
+	});
 }
 
 int MemoryArchive::default_compression(std::span<const std::uint32_t> sectors,
@@ -21,11 +21,12 @@ MemoryArchive::MemoryArchive(std::span<std::byte> buffer) : mpq::MemoryArchive(b
 	hash_table_ = fetch_hash_table();
 	decrypt_block(std::as_writable_bytes(block_table_), MPQ_KEY_BLOCK_TABLE);
 	decrypt_block(std::as_writable_bytes(hash_table_), MPQ_KEY_HASH_TABLE);
-	load_listfile(0);
+	build_index();
+	load_listfile();
 }
 
 void MemoryArchive::extract_file(const std::filesystem::path& path, ExtractionSink& store) {
-	extract_file_ext(path, store, 0);
+	extract_file_ext(path, store);
 }
 
 std::span<HashTableEntry> MemoryArchive::fetch_hash_table() const {
@@ -29,20 +29,8 @@ MemoryArchive::MemoryArchive(std::span<std::byte> buffer) : mpq::MemoryArchive(b
 
 	decrypt_block(std::as_writable_bytes(block_table_), MPQ_KEY_BLOCK_TABLE);
 	decrypt_block(std::as_writable_bytes(hash_table_), MPQ_KEY_HASH_TABLE);
-	
-	auto index = file_lookup("(listfile)", 0);
-
-	if(!index) {
-		return;
-	}
-
-	auto hi_mask= 0;
-
-	if(bt_hi_pos_) {
-		hi_mask = high_mask((*bt_hi_pos_)[index]);
-	}
-
-	load_listfile(hi_mask);
+	build_index();
+	load_listfile();
 }
 
 void MemoryArchive::validate() {
@@ -98,19 +86,16 @@ std::span<std::uint16_t> MemoryArchive::fetch_btable_hi_pos() const {
 }
 
 void MemoryArchive::extract_file(const std::filesystem::path& path, ExtractionSink& store) {
-	auto index = file_lookup(path.string(), 0);
-
-	if(index == npos) {
-		throw exception("cannot extract file: file not found");
-	}
-
-	auto fpos_hi = 0;
+	extract_file_ext(path, store);
+}
 
-	if(bt_hi_pos_) {
-		fpos_hi = high_mask((*bt_hi_pos_)[index]);;
+std::uint64_t MemoryArchive::file_position_hi(const std::size_t index) const {
+	if(!bt_hi_pos_) {
+		return 0;
 	}
 
-	extract_file_ext(path, store, fpos_hi);
+	// the extended table runs parallel to the block table, not the hash table
+	return high_mask((*bt_hi_pos_)[hash_table_[index].block_index]);
 }
 
 std::span<HashTableEntry> MemoryArchive::fetch_hash_table() const {
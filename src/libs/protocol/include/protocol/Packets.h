@@ -20,6 +20,7 @@
 #include <protocol/server/CharacterLoginFailed.h>
 #include <protocol/server/LogoutComplete.h>
 #include <protocol/server/AddonInfo.h>
+#include <protocol/server/ServerMessage.h>
 #include <protocol/client/AuthSession.h>
 #include <protocol/client/Ping.h>
 #include <protocol/client/CharacterCreate.h>
@@ -40,6 +41,7 @@ using SMSG_CHAR_DELETE            = ServerPacket<ServerOpcode::SMSG_CHAR_DELETE,
 using SMSG_CHAR_RENAME            = ServerPacket<ServerOpcode::SMSG_CHAR_RENAME, server::CharacterRename>;
 using SMSG_CHARACTER_LOGIN_FAILED = ServerPacket<ServerOpcode::SMSG_CHARACTER_LOGIN_FAILED, server::CharacterLoginFailed>;
 using SMSG_LOGOUT_COMPLETE        = ServerPacket<ServerOpcode::SMSG_LOGOUT_COMPLETE, server::LogoutComplete>;
+using SMSG_SERVER_MESSAGE         = ServerPacket<ServerOpcode::SMSG_SERVER_MESSAGE, server::ServerMessage>;
 
 using CMSG_AUTH_SESSION           = ClientPacket<ClientOpcode::CMSG_AUTH_SESSION, client::AuthSession>;
 using CMSG_PING                   = ClientPacket<ClientOpcode::CMSG_PING, client::Ping>;
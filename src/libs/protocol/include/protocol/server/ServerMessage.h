@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <protocol/Packet.h>
+#include <boost/assert.hpp>
+#include <boost/endian/arithmetic.hpp>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+
+namespace ember::protocol::server {
+
+namespace be = boost::endian;
+
+class ServerMessage final {
+	State state_ = State::INITIAL;
+
+public:
+	enum class Type : std::uint32_t {
+		SHUTDOWN_TIME = 1,
+		RESTART_TIME,
+		STRING,
+		SHUTDOWN_CANCELLED,
+		RESTART_CANCELLED
+	};
+
+	be::little_uint32_t type;
+	std::string message;
+
+	State read_from_stream(auto& stream) try {
+		BOOST_ASSERT_MSG(state_ != State::DONE, "Packet already complete - check your logic!");
+
+		stream >> type;
+		stream >> message;
+
+		return (state_ = State::DONE);
+	} catch(const std::exception&) {
+		return State::ERRORED;
+	}
+
+	void write_to_stream(auto& stream) const {
+		stream << type;
+		stream << message;
+	}
+};
+
+} // protocol, ember
@@ -9,84 +9,89 @@
 #pragma once
 
 #include <shared/database/daos/shared_base/IPBanBase.h>
+#include <shared/util/PrefixTrie.h>
 #include <boost/asio/ip/address.hpp>
-#include <boost/asio/ip/address_v6_range.hpp>
+#include <boost/endian/conversion.hpp>
+#include <mutex>
+#include <shared_mutex>
 #include <stdexcept>
 #include <span>
-#include <vector>
+#include <string>
 #include <cstdint>
+#include <cstring>
 
 namespace ember {
 
+/*
+ * Bans are held in a prefix trie per address family, so checking an
+ * address costs roughly the same regardless of how many ranges are
+ * banned. Bans can be added and removed while the cache is in use.
+ */
 class IPBanCache {
-	struct IPv4Entry {
-		boost::asio::ip::address_v4::uint_type range;
-		std::uint32_t mask;
-	};
-
-	std::vector<IPv4Entry> ipv4_entries_;
-	std::vector<boost::asio::ip::address_v6_range> ipv6_entries_;
-
-	// https://stackoverflow.com/a/57288759 because lazy
-	boost::asio::ip::address_v6_range build_range(const boost::asio::ip::address_v6& address,
-	                                              const std::uint32_t prefix) const {
-		auto bytes = address.to_bytes();
-		auto offset = prefix >> 3;
-		auto shift = 1 << (8 - (prefix & 0x07));
-
-		while(shift) {
-			const auto value = bytes[offset] + shift;
-			bytes[offset] = value & 0xFF;
-			shift = value >> 8;
-
-			if(offset == 0) {
-				break;
-			}
+	using IPv4Trie = PrefixTrie<32>;
+	using IPv6Trie = PrefixTrie<128>;
 
-			--offset;
-		}
+	IPv4Trie ipv4_entries_;
+	IPv6Trie ipv6_entries_;
+	mutable std::shared_mutex lock_;
 
-		const auto end = boost::asio::ip::address_v6(bytes);
-		return boost::asio::ip::address_v6_range(address, end);
+	static IPv4Trie::Key to_key(const boost::asio::ip::address_v4& ip) {
+		return { static_cast<std::uint64_t>(ip.to_uint()) << 32 };
 	}
 
-	bool check_ban(const boost::asio::ip::address_v6&& ip) const {
-		for(auto& range : ipv6_entries_) {
-			if(auto it = range.find(ip); it != range.end()) {
-				return true;
-			}
+	static IPv6Trie::Key to_key(const boost::asio::ip::address_v6& ip) {
+		const auto bytes = ip.to_bytes();
+		IPv6Trie::Key key;
+		std::memcpy(key.data(), bytes.data(), bytes.size());
+
+		for(auto& word : key) {
+			boost::endian::big_to_native_inplace(word);
 		}
 
-		return false;
+		return key;
 	}
 
-	bool check_ban(const boost::asio::ip::address_v4&& ip) const {
-		unsigned long ip_long = ip.to_ulong();
-		
-		for(auto& e : ipv4_entries_) {
-			if((ip_long & e.mask) == (e.range & e.mask)) {
+	// must be called with the lock held
+	bool check_ban(const boost::asio::ip::address_v6& ip) const {
+		if(ip.is_v4_mapped()) {
+			const auto v4 = boost::asio::ip::make_address_v4(boost::asio::ip::v4_mapped, ip);
+
+			if(ipv4_entries_.match(to_key(v4))) {
 				return true;
 			}
 		}
 
-		return false;
+		return ipv6_entries_.match(to_key(ip));
+	}
+
+	// must be called with the lock held
+	bool check_ban(const boost::asio::ip::address_v4& ip) const {
+		return ipv4_entries_.match(to_key(ip));
 	}
 
+	// must be called with the lock held
 	void load_bans(std::span<const IPEntry> bans) {
 		for(auto& [ip, cidr] : bans) {
 			load_ban(ip, cidr);
 		}
 	}
 
-	void load_ban(const std::string& ip, const std::uint32_t cidr) {
-		auto address = boost::asio::ip::address::from_string(ip);
+	// must be called with the lock held
+	bool load_ban(const std::string& ip, const std::uint32_t cidr) {
+		const auto address = boost::asio::ip::address::from_string(ip);
 
 		if(address.is_v6()) {
-			auto range = build_range(address.to_v6(), cidr);
-			ipv6_entries_.emplace_back(std::move(range));
+			if(cidr > 128) {
+				throw std::invalid_argument("Invalid IPv6 CIDR: " + ip + "/" + std::to_string(cidr));
+			}
+
+			return ipv6_entries_.insert(to_key(address.to_v6()), cidr);
 		} else {
-			std::uint32_t mask = (~0U) << (32 - cidr);
-			ipv4_entries_.emplace_back(address.to_v4().to_uint(), mask);
+			if(cidr > 32) {
+				throw std::invalid_argument("Invalid IPv4 CIDR: " + ip + "/" + std::to_string(cidr));
+			}
+
+			return ipv4_entries_.insert(to_key(address.to_v4()), cidr);
 		}
 	}
 
@@ -97,12 +102,33 @@ public:
 
 	IPBanCache() = default;
 
-	void ban(const std::string& ip, const std::uint32_t mask) {
-		load_ban(ip, mask);
+	bool ban(const std::string& ip, const std::uint32_t cidr) {
+		std::unique_lock guard(lock_);
+		return load_ban(ip, cidr);
+	}
+
+	/*
+	 * Only removes the exact range that was banned, an address in a
+	 * range that's covered by another ban will remain banned
+	 */
+	bool unban(const std::string& ip, const std::uint32_t cidr) {
+		const auto address = boost::asio::ip::address::from_string(ip);
+		std::unique_lock guard(lock_);
+
+		if(address.is_v6()) {
+			return ipv6_entries_.erase(to_key(address.to_v6()), cidr);
+		} else {
+			return ipv4_entries_.erase(to_key(address.to_v4()), cidr);
+		}
+	}
+
+	std::size_t size() const {
+		std::shared_lock guard(lock_);
+		return ipv4_entries_.size() + ipv6_entries_.size();
 	}
 
 	bool is_banned(const std::string& ip) const {
-		if(ipv4_entries_.empty() && ipv6_entries_.empty()) {
+		if(!size()) {
 			return false;
 		}
 
@@ -110,6 +136,8 @@ public:
 	}
 
 	bool is_banned(const boost::asio::ip::address& ip) const {
+		std::shared_lock guard(lock_);
+
 		if(ip.is_v6()) {
 			return check_ban(ip.to_v6());
 		} else {
@@ -118,4 +146,4 @@ public:
 	}
 };
 
-} // ember
\ No newline at end of file
+} // ember
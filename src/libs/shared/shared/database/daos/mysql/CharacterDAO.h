@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace ember::dal { 
 
@@ -61,6 +62,48 @@ class MySQLCharacterDAO final : public CharacterDAO {
 		return character;
 	}
 
+	void bind_insert(sql::PreparedStatement* stmt, const Character& character) const {
+		stmt->setString(1, character.name);
+		stmt->setUInt(2, character.account_id);
+		stmt->setUInt(3, character.realm_id);
+		stmt->setUInt(4, character.race);
+		stmt->setUInt(5, character.class_);
+		stmt->setUInt(6, character.gender);
+		stmt->setUInt(7, character.skin);
+		stmt->setUInt(8, character.face);
+		stmt->setUInt(9, character.hairstyle);
+		stmt->setUInt(10, character.haircolour);
+		stmt->setUInt(11, character.facialhair);
+		stmt->setUInt(12, character.level);
+		stmt->setUInt(13, character.zone);
+		stmt->setUInt(14, character.map);
+		stmt->setDouble(15, character.position.x);
+		stmt->setDouble(16, character.position.y);
+		stmt->setDouble(17, character.position.z);
+		stmt->setDouble(18, character.orientation);
+		stmt->setUInt(19, static_cast<std::uint32_t>(character.flags));
+		stmt->setUInt(20, character.first_login);
+		stmt->setUInt(21, character.pet_display);
+		stmt->setUInt(22, character.pet_level);
+		stmt->setUInt(23, character.pet_family);
+		stmt->setString(24, character.internal_name);
+	}
+
+	// FIND_IN_SET list, an empty string matches nothing
+	static std::string join_races(const std::vector<std::uint8_t>& races) {
+		std::string list;
+
+		for(const auto race : races) {
+			if(!list.empty()) {
+				list += ',';
+			}
+
+			list += std::to_string(race);
+		}
+
+		return list;
+	}
+
 public:
 	MySQLCharacterDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
 
@@ -194,30 +237,7 @@ public:
 
 		auto conn = pool_.try_acquire_for(5s);
 		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
-		stmt->setString(1, character.name);
-		stmt->setUInt(2, character.account_id);
-		stmt->setUInt(3, character.realm_id);
-		stmt->setUInt(4, character.race);
-		stmt->setUInt(5, character.class_);
-		stmt->setUInt(6, character.gender);
-		stmt->setUInt(7, character.skin);
-		stmt->setUInt(8, character.face);
-		stmt->setUInt(9, character.hairstyle);
-		stmt->setUInt(10, character.haircolour);
-		stmt->setUInt(11, character.facialhair);
-		stmt->setUInt(12, character.level);
-		stmt->setUInt(13, character.zone);
-		stmt->setUInt(14, character.map);
-		stmt->setDouble(15, character.position.x);
-		stmt->setDouble(16, character.position.y);
-		stmt->setDouble(17, character.position.z);
-		stmt->setDouble(18, character.orientation);
-		stmt->setUInt(19, static_cast<std::uint32_t>(character.flags));
-		stmt->setUInt(20, character.first_login);
-		stmt->setUInt(21, character.pet_display);
-		stmt->setUInt(22, character.pet_level);
-		stmt->setUInt(23, character.pet_family);
-		stmt->setString(24, character.internal_name);
+		bind_insert(stmt, character);
 
 		if(!stmt->executeUpdate()) {
 			throw exception("Unable to create character");
@@ -226,6 +246,93 @@ public:
 		throw exception(e.what());
 	}
 
+	/*
+	 * The constraints are part of the insert's WHERE clause, so a successful
+	 * creation takes a single statement. Only if nothing was inserted is a
+	 * second query made to find out which of the constraints failed.
+	 */
+	CreateResult create(const Character& character, const CreateConstraints& constraints) const override try {
+		constexpr std::string_view query =
+			"INSERT INTO characters (name, account_id, realm_id, race, class, gender, "
+			"skin, face, hairstyle, haircolour, facialhair, level, zone, "
+			"map, x, y, z, o, flags, first_login, pet_display, pet_level, "
+			"pet_family, internal_name) "
+			"SELECT ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ? FROM DUAL "
+			"WHERE NOT EXISTS (SELECT 1 FROM characters WHERE internal_name = ? AND realm_id = ? "
+			"AND deletion_date IS NULL) "
+			"AND (SELECT COUNT(*) FROM characters WHERE account_id = ? AND deletion_date IS NULL) < ? "
+			"AND (SELECT COUNT(*) FROM characters WHERE account_id = ? AND realm_id = ? "
+			"AND deletion_date IS NULL) < ? "
+			"AND NOT EXISTS (SELECT 1 FROM characters WHERE account_id = ? AND realm_id = ? "
+			"AND deletion_date IS NULL AND FIND_IN_SET(race, ?))";
+
+		const auto races = join_races(constraints.conflicting_races);
+
+		auto conn = pool_.try_acquire_for(5s);
+		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		bind_insert(stmt, character);
+		stmt->setString(25, character.internal_name);
+		stmt->setUInt(26, character.realm_id);
+		stmt->setUInt(27, character.account_id);
+		stmt->setUInt(28, constraints.account_slots);
+		stmt->setUInt(29, character.account_id);
+		stmt->setUInt(30, character.realm_id);
+		stmt->setUInt(31, constraints.realm_slots);
+		stmt->setUInt(32, character.account_id);
+		stmt->setUInt(33, character.realm_id);
+		stmt->setString(34, races);
+
+		if(stmt->executeUpdate()) {
+			return CreateResult::SUCCESS;
+		}
+
+		constexpr std::string_view check_query =
+			"SELECT EXISTS (SELECT 1 FROM characters WHERE internal_name = ? AND realm_id = ? "
+			"AND deletion_date IS NULL) AS name_in_use, "
+			"(SELECT COUNT(*) FROM characters WHERE account_id = ? AND deletion_date IS NULL) AS account_count, "
+			"(SELECT COUNT(*) FROM characters WHERE account_id = ? AND realm_id = ? "
+			"AND deletion_date IS NULL) AS realm_count, "
+			"EXISTS (SELECT 1 FROM characters WHERE account_id = ? AND realm_id = ? "
+			"AND deletion_date IS NULL AND FIND_IN_SET(race, ?)) AS faction_conflict";
+
+		stmt = driver_->prepare_cached(*conn, check_query);
+		stmt->setString(1, character.internal_name);
+		stmt->setUInt(2, character.realm_id);
+		stmt->setUInt(3, character.account_id);
+		stmt->setUInt(4, character.account_id);
+		stmt->setUInt(5, character.realm_id);
+		stmt->setUInt(6, character.account_id);
+		stmt->setUInt(7, character.realm_id);
+		stmt->setString(8, races);
+		std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
+
+		if(!res->next()) {
+			throw exception("!rowsCount checking character creation constraints");
+		}
+
+		// same precedence as the checks were originally made in
+		if(res->getBoolean("name_in_use")) {
+			return CreateResult::NAME_IN_USE;
+		}
+
+		if(res->getUInt("account_count") >= constraints.account_slots) {
+			return CreateResult::ACCOUNT_LIMIT;
+		}
+
+		if(res->getUInt("realm_count") >= constraints.realm_slots) {
+			return CreateResult::REALM_LIMIT;
+		}
+
+		if(res->getBoolean("faction_conflict")) {
+			return CreateResult::FACTION_CONFLICT;
+		}
+
+		// a concurrent change must have freed up whatever blocked the insert
+		throw exception("Unable to create character");
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
 	void update(const Character& character) const override try {
 		constexpr std::string_view query =
 			"UPDATE characters SET name = ?, internal_name = ?, account_id = ?, "
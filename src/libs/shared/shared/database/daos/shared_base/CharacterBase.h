@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016 Ember
+ * Copyright (c) 2016 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -17,6 +17,20 @@
 
 namespace ember::dal {
 
+/*
+ * Constraints checked by the database as part of creating a character, so
+ * that the checks and the insert happen in a single statement
+ */
+struct CreateConstraints {
+	std::uint32_t account_slots; // maximum characters across all realms
+	std::uint32_t realm_slots;   // maximum characters on the character's realm
+	std::vector<std::uint8_t> conflicting_races; // races that can't exist alongside the new character
+};
+
+enum class CreateResult {
+	SUCCESS, NAME_IN_USE, ACCOUNT_LIMIT, REALM_LIMIT, FACTION_CONFLICT
+};
+
 class CharacterDAO {
 public:
 	virtual std::optional<Character> character(std::uint64_t id) const = 0;
@@ -25,6 +39,7 @@ public:
 	virtual void delete_character(std::uint64_t id, bool soft_delete) const = 0;
 	virtual void restore(std::uint64_t id) const = 0;
 	virtual void create(const Character& character) const = 0;
+	virtual CreateResult create(const Character& character, const CreateConstraints& constraints) const = 0;
 	virtual void update(const Character& character) const = 0;
 	virtual int count(std::uint32_t account_id, std::uint32_t realm_id = 0) const = 0;
 	virtual ~CharacterDAO() = default;
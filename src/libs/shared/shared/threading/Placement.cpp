@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Placement.h"
+#include <limits>
+
+namespace ember {
+
+std::size_t RoundRobinPlacement::select(std::span<const ServiceLoad> loads) {
+	const auto index = next_ % loads.size();
+	next_ = index + 1;
+	return index;
+}
+
+double LeastLoadedPlacement::score(const ServiceLoad& load) const {
+	const auto connections = load.connections.load(std::memory_order_relaxed);
+	const auto messages = load.recent_messages.load(std::memory_order_relaxed);
+	const auto bytes = load.recent_bytes.load(std::memory_order_relaxed);
+	const auto latency = load.queue_latency.load(std::memory_order_relaxed);
+
+	return connections * weights_.connection
+		+ messages * weights_.message
+		+ (bytes / 1024.0) * weights_.kilobyte
+		+ (latency / 1000.0) * weights_.latency_ms;
+}
+
+std::size_t LeastLoadedPlacement::select(std::span<const ServiceLoad> loads) {
+	const auto size = loads.size();
+	auto best = start_ % size;
+	auto best_score = std::numeric_limits<double>::max();
+
+	for(std::size_t i = 0; i < size; ++i) {
+		const auto index = (start_ + i) % size;
+
+		if(const auto score = this->score(loads[index]); score < best_score) {
+			best = index;
+			best_score = score;
+		}
+	}
+
+	start_ = best + 1;
+	return best;
+}
+
+} // ember
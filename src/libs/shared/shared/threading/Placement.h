@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Load counters for a single io_context in a ServicePool.
+ *
+ * Connections may be adjusted from any thread. The traffic totals are
+ * only written by the thread running the io_context, which is also where
+ * the pool periodically folds them into the recent_* counters and samples
+ * queue latency (how late a timer handler runs compared to its deadline).
+ * Recent counters decay by half at every sample, so they reflect the last
+ * few seconds of traffic rather than a total since startup.
+ */
+struct alignas(64) ServiceLoad {
+	std::atomic_size_t connections;
+	std::atomic_size_t bytes;
+	std::atomic_size_t messages;
+	std::atomic_size_t recent_bytes;
+	std::atomic_size_t recent_messages;
+	std::atomic<std::uint64_t> queue_latency; // smoothed, microseconds
+
+	// single writer, so there's no need for a locked read-modify-write
+	void record_traffic(const std::size_t bytes_, const std::size_t messages_ = 0) {
+		bytes.store(bytes.load(std::memory_order_relaxed) + bytes_, std::memory_order_relaxed);
+		messages.store(messages.load(std::memory_order_relaxed) + messages_, std::memory_order_relaxed);
+	}
+};
+
+/*
+ * Decides which io_context a new unit of work (usually a connection)
+ * should be assigned to. Policies are only called from one thread at a
+ * time, so they can keep unsynchronised state of their own, but the load
+ * counters may be changing underneath them.
+ */
+class PlacementPolicy {
+public:
+	virtual std::size_t select(std::span<const ServiceLoad> loads) = 0;
+	virtual ~PlacementPolicy() = default;
+};
+
+class RoundRobinPlacement final : public PlacementPolicy {
+	std::size_t next_ = 0;
+
+public:
+	std::size_t select(std::span<const ServiceLoad> loads) override;
+};
+
+/*
+ * Picks the io_context with the lowest weighted load score. Ties are
+ * broken by starting the scan where the previous one left off, so an
+ * idle pool still spreads work evenly.
+ */
+class LeastLoadedPlacement final : public PlacementPolicy {
+public:
+	struct Weights {
+		double connection = 1.0;
+		double message = 0.01;     // per recent message
+		double kilobyte = 0.001;   // per recent kilobyte
+		double latency_ms = 1.0;   // per millisecond of queue latency
+	};
+
+private:
+	const Weights weights_ {};
+	std::size_t start_ = 0;
+
+public:
+	LeastLoadedPlacement() = default;
+	explicit LeastLoadedPlacement(Weights weights) : weights_(weights) {}
+
+	double score(const ServiceLoad& load) const;
+	std::size_t select(std::span<const ServiceLoad> loads) override;
+};
+
+} // ember
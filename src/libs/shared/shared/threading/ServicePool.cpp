@@ -8,6 +8,8 @@
 
 #include "ServicePool.h"
 #include <shared/threading/Utility.h>
+#include <boost/asio/post.hpp>
+#include <boost/assert.hpp>
 #include <utility>
 #include <stdexcept>
 
@@ -15,7 +17,8 @@ namespace ember {
 
 ServicePool::ServicePool(const std::size_t pool_size, const int hint)
 	: pool_size_(pool_size),
-	  next_service_(0) {
+	  loads_(std::make_unique<ServiceLoad[]>(pool_size)),
+	  placement_(std::make_unique<RoundRobinPlacement>()) {
 	if(pool_size == 0) {
 		throw std::runtime_error("Cannot have an empty ASIO IO service pool!");
 	}
@@ -25,6 +28,7 @@ ServicePool::ServicePool(const std::size_t pool_size, const int hint)
 			std::make_unique<boost::asio::io_context>(hint)
 		);
 		work_.emplace_back(std::make_shared<boost::asio::io_context::work>(*ctx));
+		samplers_.emplace_back(std::make_unique<Sampler>(boost::asio::steady_timer(*ctx)));
 	}
 }
 
@@ -32,12 +36,16 @@ ServicePool::~ServicePool() {
 	stop();
 }
 
-boost::asio::io_context& ServicePool::get() {
-	auto& service = *services_[next_service_++];
-	next_service_ %= pool_size_;
-	return service;
+std::size_t ServicePool::next() {
+	std::lock_guard guard(placement_lock_);
+	const auto index = placement_->select(loads());
+	BOOST_ASSERT_MSG(index < pool_size_, "Placement policy returned a bad service index");
+	return index;
 }
 
+boost::asio::io_context& ServicePool::get() {
+	return *services_[next()];
+}
 
 boost::asio::io_context& ServicePool::get(const std::size_t index) const {
 	if(index >= services_.size()) {
@@ -63,9 +71,42 @@ void ServicePool::run() {
 			(&boost::asio::io_context::run), services_[i].get());
 		thread::set_affinity(threads_[i], i % core_count);
 		thread::set_name(threads_[i], "Service Pool");
+		boost::asio::post(*services_[i], [this, i] { sample(i); });
 	}
 }
 
+/*
+ * Runs on the sampled io_context's own thread, so the lateness of the
+ * timer handler is how long work is currently queueing for and the
+ * traffic totals can be read without racing their writer.
+ */
+void ServicePool::sample(const std::size_t index) {
+	auto& sampler = *samplers_[index];
+	sampler.timer.expires_after(SAMPLE_INTERVAL);
+	sampler.timer.async_wait([this, index, &sampler](const boost::system::error_code& ec) {
+		if(ec) {
+			return;
+		}
+
+		auto& load = loads_[index];
+		const auto late = std::chrono::steady_clock::now() - sampler.timer.expiry();
+		const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(late).count();
+		const auto latency = load.queue_latency.load(std::memory_order_relaxed);
+		load.queue_latency.store((latency * 7 + elapsed) / 8, std::memory_order_relaxed);
+
+		const auto bytes = load.bytes.load(std::memory_order_relaxed);
+		const auto messages = load.messages.load(std::memory_order_relaxed);
+		const auto recent_bytes = load.recent_bytes.load(std::memory_order_relaxed);
+		const auto recent_messages = load.recent_messages.load(std::memory_order_relaxed);
+		load.recent_bytes.store(recent_bytes / 2 + (bytes - sampler.bytes), std::memory_order_relaxed);
+		load.recent_messages.store(recent_messages / 2 + (messages - sampler.messages), std::memory_order_relaxed);
+		sampler.bytes = bytes;
+		sampler.messages = messages;
+
+		sample(index);
+	});
+}
+
 void ServicePool::stop() {
 	work_.clear();
 
@@ -80,4 +121,25 @@ std::size_t ServicePool::size() const {
 	return pool_size_;
 }
 
+ServiceLoad& ServicePool::load(const std::size_t index) {
+	if(index >= pool_size_) {
+		throw std::out_of_range("Bad service index specified");
+	}
+
+	return loads_[index];
+}
+
+std::span<const ServiceLoad> ServicePool::loads() const {
+	return { loads_.get(), pool_size_ };
+}
+
+void ServicePool::placement(std::unique_ptr<PlacementPolicy> policy) {
+	if(!policy) {
+		throw std::invalid_argument("Service pool requires a placement policy");
+	}
+
+	std::lock_guard guard(placement_lock_);
+	placement_ = std::move(policy);
+}
+
 } // ember
\ No newline at end of file
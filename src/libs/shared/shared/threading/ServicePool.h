@@ -8,29 +8,55 @@
 
 #pragma once
 
+#include <shared/threading/Placement.h>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/container/small_vector.hpp>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <thread>
 #include <vector>
 #include <cstddef>
 
 namespace ember {
 
+/*
+ * get() hands out io_contexts according to the placement policy, which
+ * is round-robin unless another is set. Each io_context has a set of load
+ * counters that users of the pool can add to (connections, traffic) and
+ * that the pool itself samples queue latency into, for policies that
+ * want to avoid busy threads.
+ */
 class ServicePool final {
 	static constexpr auto POOL_SIZE_HINT = 16;
 	static constexpr auto ASIO_CONCURRENCY_HINT = 1;
+	static constexpr std::chrono::milliseconds SAMPLE_INTERVAL { 250 };
+
+	// only accessed by the thread running the sampled io_context
+	struct Sampler {
+		boost::asio::steady_timer timer;
+		std::size_t bytes = 0;
+		std::size_t messages = 0;
+	};
 
 	std::size_t pool_size_;
-	std::size_t next_service_;
 	boost::container::small_vector<std::unique_ptr<boost::asio::io_context>, POOL_SIZE_HINT> services_;
+	std::unique_ptr<ServiceLoad[]> loads_;
+	std::unique_ptr<PlacementPolicy> placement_;
+	std::mutex placement_lock_;
+	std::vector<std::unique_ptr<Sampler>> samplers_;
 	std::vector<std::shared_ptr<boost::asio::io_context::work>> work_;
 	std::vector<std::jthread> threads_;
 
+	void sample(std::size_t index);
+
 public:
 	explicit ServicePool(std::size_t pool_size, int hint = ASIO_CONCURRENCY_HINT);
 	~ServicePool();
 
+	std::size_t next();
 	boost::asio::io_context& get();
 	boost::asio::io_context& get(std::size_t index) const;
 	boost::asio::io_context* get_if(std::size_t index) const;
@@ -39,6 +65,10 @@ public:
 	void stop();
 	std::size_t size() const;
 
+	ServiceLoad& load(std::size_t index);
+	std::span<const ServiceLoad> loads() const;
+	void placement(std::unique_ptr<PlacementPolicy> policy);
+
 	ServicePool(const ServicePool&) = delete;
 	ServicePool& operator=(const ServicePool&) = delete;
 };
@@ -8,10 +8,16 @@
 
 #include "ThreadPool.h"
 #include <shared/threading/Utility.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 
 namespace ember {
 
-ThreadPool::ThreadPool(std::size_t initial_count) : work_(service_) {
+ThreadPool::ThreadPool(std::size_t initial_count) : work_(service_), queued_(0) {
 	workers_.reserve(initial_count);
 
 	for(std::size_t i = 0; i < initial_count; ++i) {
@@ -29,4 +35,59 @@ ThreadPool::~ThreadPool() {
 	shutdown();
 }
 
+void parallel_for(ThreadPool& pool, const std::size_t count, std::function<void(std::size_t)> task) {
+	struct State {
+		const std::size_t count;
+		const std::function<void(std::size_t)> task;
+		std::atomic_size_t next { 0 };
+		std::atomic_size_t done { 0 };
+		std::atomic_bool failed { false };
+		std::exception_ptr error;
+		std::mutex lock;
+		std::condition_variable cond;
+	};
+
+	if(!count) {
+		return;
+	}
+
+	auto state = std::make_shared<State>(count, std::move(task));
+
+	const auto work = [state] {
+		for(auto i = state->next++; i < state->count; i = state->next++) {
+			if(!state->failed) try {
+				state->task(i);
+			} catch(...) {
+				std::lock_guard guard(state->lock);
+
+				if(!state->error) {
+					state->error = std::current_exception();
+				}
+
+				state->failed = true;
+			}
+
+			if(++state->done == state->count) {
+				std::lock_guard guard(state->lock);
+				state->cond.notify_all();
+			}
+		}
+	};
+
+	const auto helpers = std::min(pool.size(), count - 1);
+
+	for(std::size_t i = 0; i < helpers; ++i) {
+		pool.run(work);
+	}
+
+	work();
+
+	std::unique_lock guard(state->lock);
+	state->cond.wait(guard, [&] { return state->done == state->count; });
+
+	if(state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
+
 } // ember
\ No newline at end of file
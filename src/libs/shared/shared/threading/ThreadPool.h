@@ -9,6 +9,8 @@
 #pragma once
 
 #include <boost/asio/io_context.hpp>
+#include <atomic>
+#include <functional>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -20,6 +22,7 @@ class ThreadPool final {
 	boost::asio::io_context service_;
 	boost::asio::io_context::work work_;
 	std::vector<std::jthread> workers_;
+	std::atomic_size_t queued_;
 
 public:
 	explicit ThreadPool(std::size_t initial_count);
@@ -29,11 +32,35 @@ public:
 #ifdef DEBUG_NO_THREADS
 		work();
 #else
-		service_.post(std::move(work));
+		++queued_;
+
+		service_.post([this, work = std::move(work)]() mutable {
+			--queued_;
+			work();
+		});
 #endif
 	}
 
+	// number of tasks waiting for a worker to become available
+	std::size_t queue_depth() const {
+		return queued_;
+	}
+
+	std::size_t size() const {
+		return workers_.size();
+	}
+
 	void shutdown();
 };
 
+/*
+ * Calls task(i) for every i in [0, count), sharing the work between the
+ * calling thread and the pool's workers. The caller only ever waits on
+ * tasks that are already running, so it's safe to call this from a pool
+ * worker, including from within another parallel_for. The first exception
+ * thrown by a task is rethrown once all running tasks have finished and
+ * any remaining tasks are skipped.
+ */
+void parallel_for(ThreadPool& pool, std::size_t count, std::function<void(std::size_t)> task);
+
 } // ember
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "TimerWheel.h"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <utility>
+
+namespace ember {
+
+boost::asio::io_context::id TimerWheel::id;
+
+TimerWheel::TimerWheel(boost::asio::io_context& ctx, const Clock::duration tick)
+	: boost::asio::io_context::service(ctx),
+	  timer_(ctx),
+	  tick_(tick),
+	  epoch_(Clock::now()),
+	  occupied_(0),
+	  current_tick_(0),
+	  wake_tick_(std::numeric_limits<std::uint64_t>::max()),
+	  active_(0),
+	  shutdown_(false) {}
+
+TimerWheel& TimerWheel::get(boost::asio::io_context& ctx) {
+	return boost::asio::use_service<TimerWheel>(ctx);
+}
+
+TimerWheel::TimerID TimerWheel::make_id(const std::uint32_t index, const std::uint32_t generation) {
+	return (static_cast<std::uint64_t>(generation) << 32) | (index + 1);
+}
+
+// rounds up, so timers never fire early
+std::uint64_t TimerWheel::tick_at(const Clock::time_point time) const {
+	const auto elapsed = time - epoch_;
+	return static_cast<std::uint64_t>((elapsed + tick_ - Clock::duration(1)) / tick_);
+}
+
+TimerWheel::TimerID TimerWheel::schedule(const Clock::duration delay, Callback callback) {
+	std::lock_guard guard(lock_);
+
+	if(shutdown_) {
+		return INVALID_TIMER;
+	}
+
+	std::uint32_t index;
+
+	if(free_.empty()) {
+		index = static_cast<std::uint32_t>(nodes_.size());
+		nodes_.emplace_back();
+		nodes_[index].generation = 0;
+	} else {
+		index = free_.back();
+		free_.pop_back();
+	}
+
+	auto& node = nodes_[index];
+	node.callback = std::move(callback);
+	node.expiry = std::max(tick_at(Clock::now() + delay), current_tick_);
+	insert(index);
+	++active_;
+
+	if(node.expiry < wake_tick_) {
+		set_timer();
+	}
+
+	return make_id(index, node.generation);
+}
+
+/*
+ * Returns false if the timer has already fired (or is in the process
+ * of doing so on another thread) or was never valid
+ */
+bool TimerWheel::cancel(const TimerID id) {
+	Callback callback;
+
+	{
+		std::lock_guard guard(lock_);
+
+		const auto index = static_cast<std::uint32_t>(id) - 1;
+		const auto generation = static_cast<std::uint32_t>(id >> 32);
+
+		if(index >= nodes_.size() || nodes_[index].generation != generation) {
+			return false;
+		}
+
+		if(nodes_[index].slot != NIL) {
+			unlink(index);
+		}
+
+		callback = std::move(nodes_[index].callback);
+		release(index);
+	}
+
+	// callback (and anything it has captured) is destroyed outside of the lock
+	return true;
+}
+
+std::size_t TimerWheel::size() const {
+	std::lock_guard guard(lock_);
+	return active_;
+}
+
+// must be called with the lock held
+void TimerWheel::insert(const std::uint32_t index) {
+	const auto expiry = nodes_[index].expiry;
+	const auto delta = std::min(expiry - current_tick_, MAX_DELTA);
+	const auto position = current_tick_ + delta;
+	std::size_t level = 0;
+
+	while(level < LEVELS - 1 && delta >= (1ull << (SLOT_BITS * (level + 1)))) {
+		++level;
+	}
+
+	const auto slot = (position >> (SLOT_BITS * level)) & SLOT_MASK;
+	link(index, static_cast<std::uint32_t>(level * SLOTS + slot));
+}
+
+// must be called with the lock held
+void TimerWheel::link(const std::uint32_t index, const std::uint32_t slot) {
+	auto& node = nodes_[index];
+	auto& head = slots_[slot].head;
+	node.prev = NIL;
+	node.next = head;
+	node.slot = slot;
+
+	if(head != NIL) {
+		nodes_[head].prev = index;
+	}
+
+	head = index;
+
+	if(slot < SLOTS) {
+		occupied_ |= 1ull << slot;
+	}
+}
+
+// must be called with the lock held
+void TimerWheel::unlink(const std::uint32_t index) {
+	auto& node = nodes_[index];
+	auto& head = slots_[node.slot].head;
+
+	if(node.prev != NIL) {
+		nodes_[node.prev].next = node.next;
+	} else {
+		head = node.next;
+	}
+
+	if(node.next != NIL) {
+		nodes_[node.next].prev = node.prev;
+	}
+
+	if(node.slot < SLOTS && head == NIL) {
+		occupied_ &= ~(1ull << node.slot);
+	}
+
+	node.slot = NIL;
+}
+
+// must be called with the lock held
+void TimerWheel::release(const std::uint32_t index) {
+	auto& node = nodes_[index];
+	++node.generation; // invalidates any outstanding IDs
+	node.slot = NIL;
+	free_.emplace_back(index);
+	--active_;
+}
+
+/*
+ * Redistributes the timers in the current slot of the given level into
+ * the levels below it, now that they're close enough to expiry
+ */
+void TimerWheel::cascade(const std::size_t level) {
+	const auto slot = level * SLOTS + ((current_tick_ >> (SLOT_BITS * level)) & SLOT_MASK);
+	auto index = std::exchange(slots_[slot].head, NIL);
+
+	while(index != NIL) {
+		const auto next = nodes_[index].next;
+		nodes_[index].slot = NIL;
+		insert(index);
+		index = next;
+	}
+}
+
+// must be called with the lock held
+void TimerWheel::advance(std::vector<TimerID>& expired) {
+	for(std::size_t level = 1; level < LEVELS; ++level) {
+		if((current_tick_ >> (SLOT_BITS * (level - 1))) & SLOT_MASK) {
+			break;
+		}
+
+		cascade(level);
+	}
+
+	const auto slot = current_tick_ & SLOT_MASK;
+	auto index = std::exchange(slots_[slot].head, NIL);
+	occupied_ &= ~(1ull << slot);
+
+	while(index != NIL) {
+		auto& node = nodes_[index];
+		node.slot = NIL;
+		expired.emplace_back(make_id(index, node.generation));
+		index = node.next;
+	}
+
+	++current_tick_;
+}
+
+/*
+ * Earliest tick at which there might be work to do, either expiring
+ * timers in the first level or cascading the levels above it
+ */
+std::uint64_t TimerWheel::next_wake() const {
+	const auto rotated = std::rotr(occupied_, static_cast<int>(current_tick_ & SLOT_MASK));
+	const auto cascade = (current_tick_ + SLOT_MASK) & ~static_cast<std::uint64_t>(SLOT_MASK);
+
+	if(rotated) {
+		return std::min(current_tick_ + std::countr_zero(rotated), cascade);
+	}
+
+	return cascade;
+}
+
+// must be called with the lock held
+void TimerWheel::set_timer() {
+	if(!active_ || shutdown_) {
+		wake_tick_ = std::numeric_limits<std::uint64_t>::max();
+		return;
+	}
+
+	wake_tick_ = next_wake();
+	timer_.expires_at(epoch_ + tick_ * wake_tick_);
+	timer_.async_wait([this](const boost::system::error_code& ec) {
+		if(!ec) { // if ec is set, the timer was re-armed or aborted (shutdown)
+			expire();
+		}
+	});
+}
+
+void TimerWheel::expire() {
+	std::vector<TimerID> expired;
+
+	{
+		std::lock_guard guard(lock_);
+
+		if(shutdown_) {
+			return;
+		}
+
+		const auto now = static_cast<std::uint64_t>((Clock::now() - epoch_) / tick_);
+
+		if(!active_) {
+			current_tick_ = std::max(current_tick_, now + 1);
+		}
+
+		while(current_tick_ <= now) {
+			advance(expired);
+		}
+
+		set_timer();
+	}
+
+	/*
+	 * Callbacks are invoked one at a time, outside of the lock, and
+	 * rechecked before each call in case an earlier callback cancelled
+	 * a timer that was due to expire in the same tick
+	 */
+	for(const auto id : expired) {
+		Callback callback;
+
+		{
+			std::lock_guard guard(lock_);
+
+			const auto index = static_cast<std::uint32_t>(id) - 1;
+
+			if(nodes_[index].generation != static_cast<std::uint32_t>(id >> 32)) {
+				continue;
+			}
+
+			callback = std::move(nodes_[index].callback);
+			release(index);
+		}
+
+		callback();
+	}
+}
+
+void TimerWheel::shutdown() {
+	std::vector<Node> nodes;
+
+	{
+		std::lock_guard guard(lock_);
+		shutdown_ = true;
+		timer_.cancel();
+		nodes.swap(nodes_);
+		free_.clear();
+		slots_.fill({});
+		occupied_ = 0;
+		active_ = 0;
+	}
+
+	// pending callbacks are destroyed outside of the lock without being invoked
+}
+
+} // ember
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Hierarchical hashed timer wheel, one per io_context, intended for the
+ * large number of coarse timeouts (idle, state, RPC) that connections
+ * need. Arming and cancelling a timer is O(1) and a single asio timer
+ * drives the wheel, rather than every connection owning its own kernel
+ * timer entry. Timers fire no earlier than requested and at most one
+ * tick late.
+ *
+ * Timers that are far in the future are held in the coarser levels and
+ * cascade down towards the first level as they approach expiry.
+ *
+ * Obtain the wheel for a given io_context with TimerWheel::get(). It may
+ * be used from any thread, although callbacks are always invoked on a
+ * thread running the io_context that the wheel belongs to. If the
+ * io_context has more than one thread, callbacks need to get themselves
+ * onto the right strand.
+ */
+class TimerWheel final : public boost::asio::io_context::service {
+public:
+	using Callback = std::function<void()>;
+	using TimerID = std::uint64_t;
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr TimerID INVALID_TIMER = 0;
+	static constexpr std::chrono::milliseconds DEFAULT_TICK { 100 };
+
+	static boost::asio::io_context::id id;
+
+private:
+	static constexpr std::size_t SLOT_BITS = 6;
+	static constexpr std::size_t SLOTS = 1u << SLOT_BITS;
+	static constexpr std::size_t SLOT_MASK = SLOTS - 1;
+	static constexpr std::size_t LEVELS = 4;
+	static constexpr std::uint64_t MAX_DELTA = (1ull << (SLOT_BITS * LEVELS)) - 1;
+	static constexpr std::uint32_t NIL = ~0u;
+
+	struct Node {
+		Callback callback;
+		std::uint64_t expiry;
+		std::uint32_t prev;
+		std::uint32_t next;
+		std::uint32_t generation;
+		std::uint32_t slot; // flattened level/slot index, NIL if not linked
+	};
+
+	struct Slot {
+		std::uint32_t head = NIL;
+	};
+
+	boost::asio::steady_timer timer_;
+	const Clock::duration tick_;
+	const Clock::time_point epoch_;
+	std::array<Slot, SLOTS * LEVELS> slots_;
+	std::uint64_t occupied_; // bitmap of non-empty first level slots
+	std::vector<Node> nodes_;
+	std::vector<std::uint32_t> free_;
+	std::uint64_t current_tick_;
+	std::uint64_t wake_tick_;
+	std::size_t active_;
+	bool shutdown_;
+	mutable std::mutex lock_;
+
+	std::uint64_t tick_at(Clock::time_point time) const;
+	std::uint64_t next_wake() const;
+	void insert(std::uint32_t index);
+	void link(std::uint32_t index, std::uint32_t slot);
+	void unlink(std::uint32_t index);
+	void release(std::uint32_t index);
+	void cascade(std::size_t level);
+	void set_timer();
+	void advance(std::vector<TimerID>& expired);
+	void expire();
+	void shutdown() override;
+
+	static TimerID make_id(std::uint32_t index, std::uint32_t generation);
+
+public:
+	explicit TimerWheel(boost::asio::io_context& ctx, Clock::duration tick = DEFAULT_TICK);
+
+	static TimerWheel& get(boost::asio::io_context& ctx);
+
+	TimerID schedule(Clock::duration delay, Callback callback);
+	bool cancel(TimerID id);
+	std::size_t size() const;
+};
+
+} // ember
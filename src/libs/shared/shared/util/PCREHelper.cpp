@@ -1,5 +1,5 @@
 ﻿/*
- * Copyright (c) 2016 Ember
+ * Copyright (c) 2016 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,44 +9,153 @@
 #include "PCREHelper.h"
 #include <boost/algorithm/string.hpp>
 #include <pcre.h>
+#include <stdexcept>
 #include <string>
 #include <memory>
+#include <utility>
 
 using namespace std::string_literals;
 
 namespace ember::util::pcre {
 
-Result utf8_jit_compile(std::string expression) {
-	int error_offset = 0;
-	const char* error = 0;
+namespace {
 
-	// <\ isn't handled by PCRE (unless you happen to be WoW.exe), replace with \b
+// <\ isn't handled by PCRE (unless you happen to be WoW.exe), replace with \b
+void replace_word_boundaries(std::string& expression) {
 	boost::replace_first(expression, R"(\<)", R"(\b)");
 	boost::replace_first(expression, R"(\>)", R"(\b)");
+}
+
+bool has_backreference(const std::string& expression) {
+	if(expression.find("(?P=") != std::string::npos) {
+		return true;
+	}
+
+	for(std::size_t i = 0; i + 1 < expression.size(); ++i) {
+		if(expression[i] != '\\') {
+			continue;
+		}
+
+		const auto next = expression[++i];
+
+		if(next == 'g' || next == 'k' || (next >= '1' && next <= '9')) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// leaves the error empty on success, rather than throwing, so failed combinations can be split
+Result compile(const std::string& expression, std::string& error) {
+	int error_offset = 0;
+	const char* reason = nullptr;
+
+	Result result {
+		{ pcre_compile(expression.c_str(), PCRE_UTF8 | PCRE_CASELESS, &reason, &error_offset, nullptr), pcre_free },
+		{ nullptr, pcre_free_study }
+	};
+
+	if(result.pcre == nullptr) {
+		error = "Could not compile expression, " + expression + ":" + (reason? reason : "");
+		return result;
+	}
 
-	auto compiled = std::unique_ptr<::pcre, void(*)(void*)>(
-		pcre_compile(expression.c_str(), PCRE_UTF8 | PCRE_CASELESS, &error, &error_offset, nullptr),
-		pcre_free
-	);
+	result.extra.reset(pcre_study(result.pcre.get(), PCRE_STUDY_JIT_COMPILE, &reason));
 
-	if(compiled == nullptr) {
-		throw std::runtime_error("Could not compile expression, " + expression + ":" + error);
+	if(result.extra == nullptr) {
+		error = "Could not JIT compile expression, " + expression + ":" + (reason? reason : "");
 	}
 
-	auto extra = std::unique_ptr<pcre_extra, void(*)(pcre_extra*)>(
-		pcre_study(compiled.get(), PCRE_STUDY_JIT_COMPILE, &error),
-		pcre_free_study
-	);
+	return result;
+}
+
+} // unnamed
 
-	if(extra == nullptr) {
-		throw std::runtime_error("Could not JIT compile expression, " + expression + ":" + error);
+Result utf8_jit_compile(std::string expression) {
+	replace_word_boundaries(expression);
+
+	std::string error;
+	auto result = compile(expression, error);
+
+	if(!error.empty()) {
+		throw std::runtime_error(error);
 	}
 
-	return { std::move(compiled), std::move(extra) };
+	return result;
 }
 
 int match(const std::string& needle, const Result& result) {
 	return pcre_exec(result.pcre.get(), result.extra.get(), needle.c_str(), needle.size(), 0, 0, nullptr, 0);
 }
 
-} // pcre, util, ember
\ No newline at end of file
+PatternSet::PatternSet(std::vector<std::string> expressions) {
+	std::vector<std::string> combinable;
+
+	for(auto& expression : expressions) {
+		replace_word_boundaries(expression);
+
+		if(has_backreference(expression)) {
+			patterns_.emplace_back(utf8_jit_compile(std::move(expression)));
+		} else {
+			combinable.emplace_back(std::move(expression));
+		}
+	}
+
+	combine(combinable);
+}
+
+void PatternSet::combine(std::span<const std::string> expressions) {
+	if(expressions.empty()) {
+		return;
+	}
+
+	// a lone expression that won't compile is an error, as it would be for utf8_jit_compile
+	if(expressions.size() == 1) {
+		std::string error;
+		auto result = compile(expressions.front(), error);
+
+		if(!error.empty()) {
+			throw std::runtime_error(error);
+		}
+
+		patterns_.emplace_back(std::move(result));
+		return;
+	}
+
+	std::string combined;
+
+	for(const auto& expression : expressions) {
+		if(!combined.empty()) {
+			combined += '|';
+		}
+
+		combined += "(?:" + expression + ")";
+	}
+
+	std::string error;
+	auto result = compile(combined, error);
+
+	if(error.empty()) {
+		patterns_.emplace_back(std::move(result));
+		return;
+	}
+
+	const auto half = expressions.size() / 2;
+	combine(expressions.first(half));
+	combine(expressions.subspan(half));
+}
+
+int PatternSet::match(const std::string& needle) const {
+	for(const auto& pattern : patterns_) {
+		const int ret = pcre::match(needle, pattern);
+
+		if(ret != PCRE_ERROR_NOMATCH) {
+			return ret;
+		}
+	}
+
+	return PCRE_ERROR_NOMATCH;
+}
+
+} // pcre, util, ember
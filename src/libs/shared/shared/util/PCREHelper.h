@@ -1,5 +1,5 @@
 ﻿/*
- * Copyright (c) 2016 Ember
+ * Copyright (c) 2016 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,7 +9,9 @@
 #pragma once
 
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 #include <pcre.h>
 #include <cstddef>
 
@@ -23,4 +25,29 @@ struct Result {
 Result utf8_jit_compile(std::string expression);
 int match(const std::string& needle, const Result& result);
 
-} // utf8, util, ember
\ No newline at end of file
+/*
+ * Matches against a set of expressions without running each of them in turn.
+ * Expressions are joined into alternations, so a set of several hundred is
+ * usually only a handful of compiled patterns. Any chunk that PCRE refuses to
+ * compile as a whole (e.g. it exceeds the compiled size limit) is split until
+ * it does, and expressions with backreferences are always compiled alone, as
+ * joining them would renumber their groups.
+ */
+class PatternSet final {
+	std::vector<Result> patterns_;
+
+	void combine(std::span<const std::string> expressions);
+
+public:
+	PatternSet() = default;
+	explicit PatternSet(std::vector<std::string> expressions);
+
+	// same return values as pcre::match, which is >= 0 if any expression matches
+	int match(const std::string& needle) const;
+
+	std::size_t compiled_size() const {
+		return patterns_.size();
+	}
+};
+
+} // pcre, util, ember
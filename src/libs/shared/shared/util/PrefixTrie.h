@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Path-compressed binary (Patricia) trie of bit prefixes, such as CIDR
+ * blocks. Keys are big-endian bit strings packed into 64-bit words, with
+ * the most significant bit of the first word being the first bit.
+ *
+ * Every node stores its full prefix rather than just the bits it adds to
+ * its parent's, which costs a little memory but allows a node to be
+ * spliced out on removal without touching its children. The trie never
+ * has more than 2n - 1 nodes and a lookup visits at most one node per
+ * branch point, rather than one per bit.
+ */
+template<std::size_t Bits>
+class PrefixTrie final {
+	static_assert(Bits > 0 && Bits <= 255, "Prefix lengths must fit into a uint8_t");
+
+public:
+	static constexpr std::size_t WORDS = (Bits + 63) / 64;
+	using Key = std::array<std::uint64_t, WORDS>;
+
+private:
+	static constexpr std::uint32_t NIL = ~0u;
+
+	struct Node {
+		Key prefix;
+		std::array<std::uint32_t, 2> children;
+		std::uint8_t length;
+		bool terminal;
+	};
+
+	std::vector<Node> nodes_;
+	std::vector<std::uint32_t> free_;
+	std::uint32_t root_ = NIL;
+	std::size_t size_ = 0;
+
+	static std::size_t bit(const Key& key, const std::size_t index) {
+		return (key[index >> 6] >> (63 - (index & 63))) & 1;
+	}
+
+	static Key masked(Key key, const std::size_t length) {
+		for(std::size_t i = 0; i < WORDS; ++i) {
+			const auto start = i * 64;
+
+			if(length <= start) {
+				key[i] = 0;
+			} else if(length < start + 64) {
+				key[i] &= ~0ull << (64 - (length - start));
+			}
+		}
+
+		return key;
+	}
+
+	// number of leading bits the keys have in common, up to the limit
+	static std::size_t common(const Key& lhs, const Key& rhs, const std::size_t limit) {
+		for(std::size_t i = 0; i < WORDS; ++i) {
+			if(const auto diff = lhs[i] ^ rhs[i]; diff) {
+				return std::min(i * 64 + std::countl_zero(diff), limit);
+			}
+		}
+
+		return limit;
+	}
+
+	std::uint32_t& slot(const std::uint32_t parent, const std::size_t side) {
+		return parent == NIL? root_ : nodes_[parent].children[side];
+	}
+
+	std::uint32_t allocate(const Key& prefix, const std::size_t length, const bool terminal) {
+		std::uint32_t index;
+
+		if(free_.empty()) {
+			index = static_cast<std::uint32_t>(nodes_.size());
+			nodes_.emplace_back();
+		} else {
+			index = free_.back();
+			free_.pop_back();
+		}
+
+		nodes_[index] = Node {
+			.prefix = prefix,
+			.children = { NIL, NIL },
+			.length = static_cast<std::uint8_t>(length),
+			.terminal = terminal
+		};
+
+		return index;
+	}
+
+	void release(const std::uint32_t index) {
+		free_.emplace_back(index);
+	}
+
+	/*
+	 * Removes a node that's no longer terminal if it's not needed as a
+	 * branch point, which may in turn leave its parent redundant
+	 */
+	void prune(const std::uint32_t index, const std::uint32_t parent, const std::size_t side,
+	           const std::uint32_t grandparent, const std::size_t parent_side) {
+		const auto [left, right] = nodes_[index].children;
+
+		if(left != NIL && right != NIL) {
+			return;
+		}
+
+		slot(parent, side) = (left != NIL)? left : right;
+		release(index);
+
+		if(left != NIL || right != NIL || parent == NIL || nodes_[parent].terminal) {
+			return;
+		}
+
+		// parent was a branch point but now only has a single child
+		slot(grandparent, parent_side) = nodes_[parent].children[side ^ 1];
+		release(parent);
+	}
+
+public:
+	/*
+	 * Returns false if the prefix was already present. Bits beyond the
+	 * prefix length are ignored.
+	 */
+	bool insert(const Key& key, const std::size_t length) {
+		const auto prefix = masked(key, length);
+		std::uint32_t parent = NIL;
+		std::size_t side = 0;
+
+		while(true) {
+			const auto index = slot(parent, side);
+
+			if(index == NIL) {
+				const auto leaf = allocate(prefix, length, true);
+				slot(parent, side) = leaf;
+				++size_;
+				return true;
+			}
+
+			const auto node_len = nodes_[index].length;
+			const auto shared = common(prefix, nodes_[index].prefix, std::min<std::size_t>(length, node_len));
+
+			if(shared == node_len) {
+				if(length == node_len) {
+					if(nodes_[index].terminal) {
+						return false;
+					}
+
+					nodes_[index].terminal = true;
+					++size_;
+					return true;
+				}
+
+				parent = index;
+				side = bit(prefix, node_len);
+				continue;
+			}
+
+			// the new prefix diverges from or is shorter than this node's
+			const auto existing_side = bit(nodes_[index].prefix, shared);
+			std::uint32_t split;
+
+			if(shared == length) {
+				split = allocate(prefix, length, true);
+			} else {
+				split = allocate(masked(prefix, shared), shared, false);
+				const auto leaf = allocate(prefix, length, true);
+				nodes_[split].children[existing_side ^ 1] = leaf;
+			}
+
+			nodes_[split].children[existing_side] = index;
+			slot(parent, side) = split;
+			++size_;
+			return true;
+		}
+	}
+
+	/*
+	 * Removes an exact prefix, as it was inserted. Returns false if it
+	 * wasn't present.
+	 */
+	bool erase(const Key& key, const std::size_t length) {
+		const auto prefix = masked(key, length);
+		std::uint32_t grandparent = NIL, parent = NIL;
+		std::size_t parent_side = 0, side = 0;
+		auto index = root_;
+
+		while(index != NIL) {
+			const auto& node = nodes_[index];
+
+			if(node.length > length || common(prefix, node.prefix, node.length) < node.length) {
+				return false;
+			}
+
+			if(node.length == length) {
+				break;
+			}
+
+			grandparent = parent;
+			parent_side = side;
+			parent = index;
+			side = bit(prefix, node.length);
+			index = node.children[side];
+		}
+
+		if(index == NIL || !nodes_[index].terminal) {
+			return false;
+		}
+
+		nodes_[index].terminal = false;
+		--size_;
+		prune(index, parent, side, grandparent, parent_side);
+		return true;
+	}
+
+	// true if any stored prefix covers the key
+	bool match(const Key& key) const {
+		auto index = root_;
+
+		while(index != NIL) {
+			const auto& node = nodes_[index];
+
+			if(common(key, node.prefix, node.length) < node.length) {
+				return false;
+			}
+
+			if(node.terminal) {
+				return true;
+			}
+
+			if(node.length == Bits) {
+				return false;
+			}
+
+			index = node.children[bit(key, node.length)];
+		}
+
+		return false;
+	}
+
+	void clear() {
+		nodes_.clear();
+		free_.clear();
+		root_ = NIL;
+		size_ = 0;
+	}
+
+	std::size_t size() const {
+		return size_;
+	}
+
+	bool empty() const {
+		return !size_;
+	}
+};
+
+} // ember
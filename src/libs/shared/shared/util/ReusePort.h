@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <boost/asio/socket_base.hpp>
+#include <boost/asio/detail/socket_option.hpp>
+#include <stdexcept>
+
+namespace ember::util {
+
+/*
+ * SO_REUSEPORT allows several sockets to listen on the same address, with
+ * the kernel spreading incoming connections between them. Only Linux and
+ * FreeBSD's SO_REUSEPORT_LB balance connections - elsewhere, the option
+ * either doesn't exist or hands every connection to one socket, so it's
+ * treated as unsupported.
+ */
+#if defined SO_REUSEPORT_LB
+using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT_LB>;
+constexpr bool reuse_port_supported = true;
+#elif defined __linux__ && defined SO_REUSEPORT
+using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+constexpr bool reuse_port_supported = true;
+#else
+constexpr bool reuse_port_supported = false;
+#endif
+
+/*
+ * Opens, binds and starts listening on an acceptor. Socket options that
+ * affect binding have to be set between opening and binding, which the
+ * acceptor's endpoint constructor doesn't allow for.
+ */
+template<typename Acceptor>
+void listen(Acceptor& acceptor, const typename Acceptor::endpoint_type& endpoint, const bool share_port) {
+	acceptor.open(endpoint.protocol());
+	acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+
+	if(share_port) {
+#if defined SO_REUSEPORT_LB || (defined __linux__ && defined SO_REUSEPORT)
+		acceptor.set_option(reuse_port(true));
+#else
+		throw std::runtime_error("Load balanced SO_REUSEPORT is not supported on this platform");
+#endif
+	}
+
+	acceptor.bind(endpoint);
+	acceptor.listen(boost::asio::socket_base::max_listen_connections);
+}
+
+} // util, ember
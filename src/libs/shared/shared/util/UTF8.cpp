@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016 - 2023 Ember
+ * Copyright (c) 2016 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,42 +8,113 @@
 
 #include "UTF8.h"
 #include <utf8cpp/utf8.h>
-#include <cctype>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <locale>
 #include <cstdint>
 #include <cstddef>
 
 namespace ember::util::utf8 {
 
-utf8_string name_format(const utf8_string& string, const std::locale& locale) {
-	utf8_string formatted = string;
-	const auto data_beg = formatted.data();
-	const auto data_end = formatted.data() + formatted.size();
-	auto it = ::utf8::iterator(data_beg, data_beg, data_end);
-	auto beg = it;
-	auto end = ::utf8::iterator(data_end, data_beg, data_end);
+namespace {
+
+/*
+ * Codepoints are classified with the wchar_t facet, as there's no standard
+ * ctype specialisation for 32-bit integers. Where wchar_t is too narrow to
+ * hold a codepoint, it's treated as being caseless and non-alphabetic.
+ */
+using CType = std::ctype<wchar_t>;
+
+constexpr auto WCHAR_MAX_CP = static_cast<std::uint32_t>(std::numeric_limits<wchar_t>::max());
+
+std::uint32_t to_lower(const std::uint32_t cp, const CType& ctype) {
+	if(cp > WCHAR_MAX_CP) {
+		return cp;
+	}
+
+	return static_cast<std::uint32_t>(ctype.tolower(static_cast<wchar_t>(cp)));
+}
+
+std::uint32_t to_upper(const std::uint32_t cp, const CType& ctype) {
+	if(cp > WCHAR_MAX_CP) {
+		return cp;
+	}
+
+	return static_cast<std::uint32_t>(ctype.toupper(static_cast<wchar_t>(cp)));
+}
+
+bool is_alpha(const std::uint32_t cp, const CType& ctype) {
+	return cp <= WCHAR_MAX_CP && ctype.is(CType::alpha, static_cast<wchar_t>(cp));
+}
+
+} // unnamed
+
+/*
+ * Equivalent to calling is_valid, length, max_consecutive (case-insensitive),
+ * is_alpha and name_format, but decodes the name only once
+ */
+NameInfo inspect_name(const utf8_string& name, const std::locale& locale) {
+	const auto& ctype = std::use_facet<CType>(locale);
+
+	NameInfo info;
+	info.formatted.reserve(name.size());
+
+	auto it = name.begin();
+	const auto end = name.end();
+	std::size_t current_run = 0;
+	std::uint32_t last = 0;
 
 	while(it != end) {
-		if(it == beg) {
-			*it.base() = std::toupper(static_cast<unsigned char>(*it), locale);
-		} else {
-			*it.base() = std::tolower(static_cast<unsigned char>(*it), locale);
+		std::uint32_t cp = 0;
+
+		if(::utf8::internal::validate_next(it, end, cp) != ::utf8::internal::UTF8_OK) {
+			info.valid = false;
+			return info;
 		}
 
-		++it;
+		const auto lower = to_lower(cp, ctype);
+		current_run = lower == last? current_run + 1 : 1;
+		info.max_consecutive = std::max(info.max_consecutive, current_run);
+		last = lower;
+
+		info.alpha = info.alpha && is_alpha(cp, ctype);
+
+		const auto formatted = info.length? lower : to_upper(cp, ctype);
+		::utf8::append(formatted, std::back_inserter(info.formatted));
+		++info.length;
+	}
+
+	return info;
+}
+
+utf8_string name_format(const utf8_string& string, const std::locale& locale) {
+	const auto& ctype = std::use_facet<CType>(locale);
+
+	utf8_string formatted;
+	formatted.reserve(string.size());
+
+	auto it = string.begin();
+	const auto end = string.end();
+
+	while(it != end) {
+		const bool first = it == string.begin();
+		const std::uint32_t cp = ::utf8::next(it, end);
+		::utf8::append(first? to_upper(cp, ctype) : to_lower(cp, ctype), std::back_inserter(formatted));
 	}
 	
 	return formatted;
 }
 
 bool is_alpha(const utf8_string& string, const std::locale& locale) {
+	const auto& ctype = std::use_facet<CType>(locale);
 	const auto data_beg = string.data();
 	const auto data_end = string.data() + string.size();
 	auto it = ::utf8::iterator(data_beg, data_beg, data_end);
 	auto end = ::utf8::iterator(data_end, data_beg, data_end);
 
 	while(it != end) {
-		if(!std::isalpha(*it, locale)) {
+		if(!is_alpha(*it, ctype)) {
 			return false;
 		}
 
@@ -55,6 +126,7 @@ bool is_alpha(const utf8_string& string, const std::locale& locale) {
 
 // Operates on codepoints
 std::size_t max_consecutive(const utf8_string& string, const bool case_insensitive, const std::locale& locale) {
+	const auto& ctype = std::use_facet<CType>(locale);
 	const auto data_beg = string.data();
 	const auto data_end = string.data() + string.size();
 	auto it = ::utf8::iterator(data_beg, data_beg, data_end);
@@ -65,7 +137,7 @@ std::size_t max_consecutive(const utf8_string& string, const bool case_insensiti
 	std::uint32_t last = 0;
 
 	while (it != end) {
-		const std::uint32_t current = case_insensitive? std::tolower(*it, locale) : *it;
+		const std::uint32_t current = case_insensitive? to_lower(*it, ctype) : *it;
 		
 		if(current == last) {
 			++current_run;
@@ -96,4 +168,4 @@ bool is_valid(const char* string, const std::size_t byte_length) {
 	return ::utf8::is_valid(string, string + byte_length);
 }
 
-} // utf8, util, ember
\ No newline at end of file
+} // utf8, util, ember
@@ -15,6 +15,20 @@
 
 namespace ember::util::utf8 {
 
+/*
+ * Results of every check applied to a character name, gathered in a single
+ * pass over the string. If the name isn't valid UTF-8, the remaining fields
+ * are incomplete and shouldn't be used.
+ */
+struct NameInfo {
+	bool valid = true;
+	bool alpha = true;
+	std::size_t length = 0;
+	std::size_t max_consecutive = 0; // case-insensitive
+	utf8_string formatted;
+};
+
+NameInfo inspect_name(const utf8_string& name, const std::locale& locale);
 utf8_string name_format(const utf8_string& string, const std::locale& locale);
 bool is_alpha(const utf8_string& string, const std::locale& locale);
 std::size_t max_consecutive(const utf8_string& string, bool case_insensitive = false, const std::locale& locale = std::locale());
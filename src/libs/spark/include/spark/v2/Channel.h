@@ -65,9 +65,11 @@ public:
 	void dispatch(const MessageHeader& header, std::span<const std::uint8_t> data);
 
 	bool send(flatbuffers::FlatBufferBuilder&& fbb, TrackedState state,
-	          std::chrono::seconds timeout = 5s);
+	          std::chrono::milliseconds timeout = 5s);
 	bool send(flatbuffers::FlatBufferBuilder&& fbb, const Token& token);
 	bool send(flatbuffers::FlatBufferBuilder&& fbb);
+
+	TrackingMetrics tracking_metrics() const;
 };
 
 } // v2, spark, ember
\ No newline at end of file
@@ -14,11 +14,10 @@
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/asio/any_io_executor.hpp>
-#include <boost/container/small_vector.hpp>
 #include <array>
+#include <deque>
 #include <functional>
 #include <memory>
-#include <queue>
 #include <span>
 #include <string>
 #include <utility>
@@ -34,21 +33,23 @@ public:
 	using CloseHandler = std::function<void()>;
 
 private:
-	static constexpr auto INITIAL_BUFFER_SIZE = 100u;         // 8KB
-	static constexpr auto MAXIMUM_BUFFER_SIZE = 1024u * 1024 ; // 1MB
+	static constexpr auto INITIAL_BUFFER_SIZE = 8192u;        // 8KB
+	static constexpr auto MAXIMUM_BUFFER_SIZE = 1024u * 1024; // 1MB
+	static constexpr auto MINIMUM_READ_SIZE = 1024u;
+	static constexpr auto MAX_GATHER_MESSAGES = 64u;
+	static constexpr auto MAX_GATHER_BYTES = 256u * 1024;   // 256KB
+	static constexpr auto MESSAGE_ALIGNMENT = alignof(std::max_align_t);
 
 	log::Logger& logger_;
 	boost::asio::ip::tcp::socket socket_;
 	boost::asio::strand<boost::asio::any_io_executor> strand_;
-	boost::container::small_vector<std::uint8_t, INITIAL_BUFFER_SIZE> buffer_{};
-	std::queue<Message> queue_;
+	std::vector<std::uint8_t> buffer_;
+	std::deque<Message> queue_;
 	CloseHandler on_close_;
 
 	void buffer_resize(const std::uint32_t size);
 	boost::asio::awaitable<void> process_queue();
 	boost::asio::awaitable<void> begin_receive(ReceiveHandler handler);
-	boost::asio::awaitable<std::uint32_t> do_receive();
-	boost::asio::awaitable<std::size_t> read_until(std::size_t offset, std::size_t read_size);
 
 public:
 	Connection(boost::asio::ip::tcp::socket socket, log::Logger& logger, CloseHandler handler);
@@ -16,37 +16,84 @@
 #include <boost/functional/hash.hpp>
 #include <boost/unordered/unordered_flat_map.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <array>
 #include <chrono>
+#include <vector>
+#include <cstddef>
 #include <cstdint>
 
 namespace ember::spark::v2 {
 
+using namespace std::chrono_literals;
+
+struct TrackingMetrics {
+	// upper bounds, the final histogram bucket counts anything slower
+	static constexpr std::array LATENCY_BUCKETS {
+		1ms, 5ms, 10ms, 25ms, 50ms, 100ms, 250ms, 500ms, 1000ms, 5000ms
+	};
+
+	std::size_t outstanding;
+	std::uint64_t completed;
+	std::uint64_t timed_out;
+	std::uint64_t cancelled;
+	std::array<std::uint64_t, LATENCY_BUCKETS.size() + 1> latency;
+};
+
+/*
+ * Requests are indexed by token for O(1) completion, with their
+ * deadlines kept in a min-heap that drives a single timer, armed for
+ * whichever deadline is soonest.
+ * 
+ * Completed requests leave their heap entries behind rather than paying
+ * to remove them. These are discarded when they reach the top of the
+ * heap or if they start to outnumber the outstanding requests.
+ */
 class Tracking final {
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr std::size_t COMPACT_THRESHOLD = 1024;
+
 	struct Request {
-		Token token;
 		TrackedState state;
-		std::chrono::seconds ttl;
+		Clock::time_point sent;
+		std::uint64_t id;
+	};
+
+	struct Deadline {
+		Clock::time_point expiry;
+		Token token;
+		std::uint64_t id;
+
+		bool operator>(const Deadline& rhs) const {
+			return expiry > rhs.expiry;
+		}
 	};
 
 	boost::unordered_flat_map<boost::uuids::uuid, Request,
 	                          boost::hash<boost::uuids::uuid>> requests_;
 
-	std::chrono::seconds frequency_ { 5 }; // temp
+	std::vector<Deadline> deadlines_;
 	boost::asio::steady_timer timer_;
+	Clock::time_point armed_;
+	std::uint64_t next_id_;
+	TrackingMetrics metrics_;
 	log::Logger* logger_;
 
-	void start_timer();
+	void set_timer(Clock::time_point expiry);
 	void expired(const boost::system::error_code& ec);
-	void timeout(Request& request);
-	void cancel(Request& request);
+	void pop_deadline();
+	void compact();
+	void record_latency(Clock::duration latency);
 
 public:
 	Tracking(boost::asio::io_context& io_context, log::Logger* logger);
 	~Tracking();
 
-	void track(Token token, TrackedState state, std::chrono::seconds ttl);
+	void track(Token token, TrackedState state, std::chrono::milliseconds timeout);
 	void on_message(const Link& link, std::span<const std::uint8_t> data, const Token& token);
 	void shutdown();
+
+	TrackingMetrics metrics() const;
 };
 
-} // spark, ember
\ No newline at end of file
+} // spark, ember
@@ -65,14 +65,14 @@ bool Channel::send(flatbuffers::FlatBufferBuilder&& fbb, const Token& token, con
 }
 
 bool Channel::send(flatbuffers::FlatBufferBuilder&& fbb, TrackedState state,
-                   std::chrono::seconds timeout) {
+                   std::chrono::milliseconds timeout) {
 	if(!is_open()) {
 		state(link_, std::unexpected(Result::CHANNEL_CLOSED));
 		return false;
 	}
 
 	const auto token = uuid_gen_();
-	tracking_.track(token, state, timeout);
+	tracking_.track(token, std::move(state), timeout);
 	send(std::move(fbb), token, false);
 	return true;
 }
@@ -101,6 +101,10 @@ Handler* Channel::handler() const {
 	return handler_;
 }
 
+TrackingMetrics Channel::tracking_metrics() const {
+	return tracking_.metrics();
+}
+
 void Channel::link_up() {
 	assert(handler_);
 	link_.channel = weak_from_this();
@@ -13,7 +13,9 @@
 #include <boost/asio/detached.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/endian/conversion.hpp>
+#include <algorithm>
 #include <format>
 #include <cassert>
 #include <cstring>
@@ -26,23 +28,39 @@ Connection::Connection(ba::ip::tcp::socket socket, log::Logger& logger, CloseHan
 	: logger_(logger),
 	  socket_(std::move(socket)),
       strand_(socket_.get_executor()),
-	  on_close_(handler) {
-	buffer_.resize(4);
-}
+	  buffer_(INITIAL_BUFFER_SIZE),
+	  on_close_(handler) {}
 
+/*
+ * Drains as much of the queue as the gather limits allow into a single
+ * write, rather than a write per message. Messages remain in the queue
+ * until they've been written, as the buffers only reference them. Any
+ * messages queued while the write is in progress go out with the next.
+ */
 ba::awaitable<void> Connection::process_queue() try {
-	while(!queue_.empty()) {
-		auto msg = std::move(queue_.front());
-		queue_.pop();
+	boost::container::small_vector<ba::const_buffer, MAX_GATHER_MESSAGES * 2> buffers;
 
-		std::array<ba::const_buffer, 2> buffers {
-			ba::const_buffer { msg.header.data(), msg.header.size() },
-			ba::const_buffer { msg.fbb.GetBufferPointer(), msg.fbb.GetSize() }
-		};
+	while(!queue_.empty()) {
+		std::size_t count = 0;
+		std::size_t bytes = 0;
+
+		for(const auto& msg : queue_) {
+			if(count == MAX_GATHER_MESSAGES || (count && bytes >= MAX_GATHER_BYTES)) {
+				break;
+			}
+
+			buffers.emplace_back(msg.header.data(), msg.header.size());
+			buffers.emplace_back(msg.fbb.GetBufferPointer(), msg.fbb.GetSize());
+			bytes += msg.header.size() + msg.fbb.GetSize();
+			++count;
+		}
 
 		co_await ba::async_write(socket_, buffers, ba::deferred);
+		queue_.erase(queue_.begin(), queue_.begin() + count);
+		buffers.clear();
 	}
 } catch(std::exception& e) {
+	queue_.clear();
 	close();
 }
 
@@ -53,7 +71,7 @@ void Connection::send(Message&& buffer) {
 		}
 
 		bool inactive = queue_.empty();
-		queue_.emplace(std::move(buffer));
+		queue_.emplace_back(std::move(buffer));
 
 		if(inactive) {
 			ba::co_spawn(strand_, process_queue(), ba::detached);
@@ -61,23 +79,6 @@ void Connection::send(Message&& buffer) {
 	});
 }
 
-/*
- * This will read until at least the read_size has been received but
- * will read as much as possible into the buffer, with the hope that the
- * entire message will be received with one receive call
- */
-ba::awaitable<std::size_t> Connection::read_until(const std::size_t offset,
-                                                  const std::size_t read_size) {
-	std::size_t received = offset;
-
-	while(received < read_size) {
-		auto buffer = ba::buffer(buffer_.data() + received, buffer_.size() - received);
-		received += co_await socket_.async_receive(buffer, ba::deferred);
-	}
-
-	co_return received;
-}
-
 void Connection::buffer_resize(const std::uint32_t size) {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
@@ -93,32 +94,75 @@ void Connection::buffer_resize(const std::uint32_t size) {
 	buffer_.resize(size);
 }
 
-ba::awaitable<std::uint32_t>  Connection::do_receive() {
-	std::uint32_t msg_size = 0;
+/*
+ * Reads as much as is available into the buffer and then slices out
+ * every complete message it contains, so a burst of small messages can
+ * be handled with a single receive. A partial message is left in place
+ * until the rest of it arrives, with the buffer only being compacted
+ * once it's running out of space.
+ * 
+ * Flatbuffers must be suitably aligned, so a message that doesn't start
+ * on an aligned boundary is copied out into a separate buffer rather than
+ * shifting everything after it, which would make slicing a receive full
+ * of unaligned messages quadratic.
+ */
+ba::awaitable<void> Connection::begin_receive(ReceiveHandler handler) try {
+	std::size_t read = 0;
+	std::size_t write = 0;
 
-	// read the message size
-	auto buf = boost::asio::buffer(buffer_.data(), sizeof(msg_size));
-	co_await socket_.async_read_some(buf, ba::deferred);
-	
-	std::memcpy(&msg_size, buffer_.data(), sizeof(msg_size));
-	boost::endian::little_to_native_inplace(msg_size);
+	// heap allocations satisfy alignof(std::max_align_t)
+	std::vector<std::uint8_t> aligned;
 
-	if(msg_size > buffer_.size()) {
-		buffer_resize(msg_size);
-	}
-
-	buf = boost::asio::buffer(buffer_.data() + sizeof(msg_size), msg_size - sizeof(msg_size));
-	co_await socket_.async_read_some(buf, ba::deferred);
-	co_return msg_size;
-}
+	auto compact = [&] {
+		std::memmove(buffer_.data(), buffer_.data() + read, write - read);
+		write -= read;
+		read = 0;
+	};
 
-ba::awaitable<void> Connection::begin_receive(ReceiveHandler handler) try {
 	while(socket_.is_open()) {
-		const auto msg_size = co_await do_receive();
+		std::uint32_t msg_size = 0;
+
+		while(write - read >= sizeof(msg_size)) {
+			std::memcpy(&msg_size, buffer_.data() + read, sizeof(msg_size));
+			boost::endian::little_to_native_inplace(msg_size);
+
+			if(msg_size < sizeof(msg_size)) {
+				throw exception("bad message size");
+			}
+
+			if(write - read < msg_size) {
+				break;
+			}
+
+			// message complete, handle it
+			std::span<const std::uint8_t> view(buffer_.data() + read, msg_size);
+
+			if(read % MESSAGE_ALIGNMENT) {
+				aligned.assign(view.begin(), view.end());
+				view = aligned;
+			}
 
-		// message complete, handle it
-		std::span view(buffer_.data(), msg_size);
-		handler(view);
+			read += msg_size;
+			msg_size = 0;
+			handler(view);
+
+			if(!socket_.is_open()) {
+				co_return;
+			}
+		}
+
+		if(read == write) {
+			read = write = 0;
+		} else if(buffer_.size() - write < std::max<std::size_t>(MINIMUM_READ_SIZE, msg_size)) {
+			compact();
+		}
+
+		if(msg_size > buffer_.size()) {
+			buffer_resize(msg_size);
+		}
+
+		auto buffer = ba::buffer(buffer_.data() + write, buffer_.size() - write);
+		write += co_await socket_.async_receive(buffer, ba::deferred);
 	}
 } catch(std::exception& e) {
 	LOG_WARN(logger_) << e.what() << LOG_ASYNC;
@@ -132,6 +176,11 @@ ba::awaitable<std::span<std::uint8_t>> Connection::receive_msg() {
 	auto buffer = ba::buffer(buffer_.data(), sizeof(msg_size));
 	co_await ba::async_read(socket_, buffer, ba::deferred);
 	std::memcpy(&msg_size, buffer_.data(), sizeof(msg_size));
+	boost::endian::little_to_native_inplace(msg_size);
+
+	if(msg_size < sizeof(msg_size)) {
+		throw exception("bad message size");
+	}
 
 	if(msg_size > buffer_.size()) {
 		buffer_resize(msg_size);
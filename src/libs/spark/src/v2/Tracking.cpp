@@ -11,24 +11,30 @@
 #include <logger/Logger.h>
 #include <shared/FilterTypes.h>
 #include <algorithm>
-#include <condition_variable>
 #include <functional>
-#include <memory>
+#include <iterator>
+#include <utility>
 
 namespace sc = std::chrono;
-using namespace std::chrono_literals;
 
 namespace ember::spark::v2 {
 
 Tracking::Tracking(boost::asio::io_context& ctx, log::Logger* logger)
 	: timer_(ctx),
-	  logger_(logger) {
-	start_timer();
+	  armed_(Clock::time_point::max()),
+	  next_id_(0),
+	  metrics_{},
+	  logger_(logger) {}
+
+void Tracking::set_timer(const Clock::time_point expiry) {
+	armed_ = expiry;
+	timer_.expires_at(expiry);
+	timer_.async_wait(std::bind_front(&Tracking::expired, this));
 }
 
-void Tracking::start_timer() {
-	timer_.expires_from_now(frequency_);
-	timer_.async_wait(std::bind_front(&Tracking::expired, this));
+void Tracking::pop_deadline() {
+	std::ranges::pop_heap(deadlines_, std::greater{});
+	deadlines_.pop_back();
 }
 
 void Tracking::expired(const boost::system::error_code& ec) {
@@ -36,19 +42,31 @@ void Tracking::expired(const boost::system::error_code& ec) {
 		return;
 	}
 
-	for(auto it = requests_.begin(); it != requests_.end();) {
-		auto& [_, request] = *it;
-		request.ttl -= frequency_;
+	armed_ = Clock::time_point::max();
+	const auto now = Clock::now();
+
+	while(!deadlines_.empty() && deadlines_.front().expiry <= now) {
+		const auto [_, token, id] = deadlines_.front();
+		pop_deadline();
 
-		if(request.ttl <= 0s) {
-			timeout(request);
-			it = requests_.erase(it);
-		} else {
-			++it;
+		auto it = requests_.find(token);
+
+		// stale entry, request has already completed
+		if(it == requests_.end() || it->second.id != id) {
+			continue;
 		}
+
+		auto state = std::move(it->second.state);
+		requests_.erase(it);
+		++metrics_.timed_out;
+
+		spark::v2::Link link; // todo
+		state(link, std::unexpected(Result::TIMED_OUT));
 	}
 
-	start_timer();
+	if(!deadlines_.empty() && deadlines_.front().expiry < armed_) {
+		set_timer(deadlines_.front().expiry);
+	}
 }
 
 void Tracking::on_message(const Link& link,
@@ -64,29 +82,59 @@ void Tracking::on_message(const Link& link,
 		return;
 	}
 
-	auto& [_, request] = *it;
-	request.state(link, data);
+	record_latency(Clock::now() - it->second.sent);
+	++metrics_.completed;
+
+	auto state = std::move(it->second.state);
 	requests_.erase(it);
+	state(link, data);
 }
 
-void Tracking::track(Token token, TrackedState state, sc::seconds ttl) {
+void Tracking::track(Token token, TrackedState state, const sc::milliseconds timeout) {
+	const auto now = Clock::now();
+	const auto expiry = now + timeout;
+	const auto id = next_id_++;
+
 	Request request {
-		.token = token,
 		.state = std::move(state),
-		.ttl = ttl
+		.sent = now,
+		.id = id
 	};
 
-	requests_.emplace(token, std::move(request));
+	requests_.insert_or_assign(token, std::move(request));
+
+	if(deadlines_.size() >= COMPACT_THRESHOLD && deadlines_.size() > requests_.size() * 2) {
+		compact();
+	}
+
+	deadlines_.emplace_back(expiry, token, id);
+	std::ranges::push_heap(deadlines_, std::greater{});
+
+	if(expiry < armed_) {
+		set_timer(expiry);
+	}
 }
 
-void Tracking::timeout(Request& request) {
-	spark::v2::Link link; // todo
-	request.state(link, std::unexpected(Result::TIMED_OUT));
+// discards heap entries for requests that have already completed
+void Tracking::compact() {
+	std::erase_if(deadlines_, [&](const Deadline& deadline) {
+		const auto it = requests_.find(deadline.token);
+		return it == requests_.end() || it->second.id != deadline.id;
+	});
+
+	std::ranges::make_heap(deadlines_, std::greater{});
+}
+
+void Tracking::record_latency(const Clock::duration latency) {
+	const auto& buckets = TrackingMetrics::LATENCY_BUCKETS;
+	const auto it = std::ranges::lower_bound(buckets, latency);
+	++metrics_.latency[std::distance(buckets.begin(), it)];
 }
 
-void Tracking::cancel(Request& request) {
-	spark::v2::Link link; // todo
-	request.state(link, std::unexpected(Result::CANCELLED));
+TrackingMetrics Tracking::metrics() const {
+	auto metrics = metrics_;
+	metrics.outstanding = requests_.size();
+	return metrics;
 }
 
 Tracking::~Tracking() {
@@ -95,10 +143,17 @@ Tracking::~Tracking() {
 
 void Tracking::shutdown() {
 	timer_.cancel();
+	armed_ = Clock::time_point::max();
+	deadlines_.clear();
+
+	auto requests = std::move(requests_);
+	requests_.clear();
 
-	for(auto& [_, request] : requests_) {
-		cancel(request);
+	for(auto& [_, request] : requests) {
+		++metrics_.cancelled;
+		spark::v2::Link link; // todo
+		request.state(link, std::unexpected(Result::CANCELLED));
 	}
 }
 
-} // spark, ember
\ No newline at end of file
+} // spark, ember
@@ -12,10 +12,16 @@
 #include "grunt/Packet.h"
 #include <shared/database/objects/User.h>
 #include <shared/database/daos/UserDAO.h>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/use_awaitable.hpp>
 #include <exception>
-#include <future>
+#include <memory>
 #include <string>
 #include <optional>
+#include <unordered_map>
 #include <utility>
 #include <cstdint>
 
@@ -23,35 +29,73 @@ namespace ember {
 
 class Action {
 public:
-	virtual void execute() = 0;
 	virtual ~Action() = default;
 };
 
-class RegisterSessionAction final : public Action {
+/*
+ * Performs blocking work, such as database queries, so it's run on the
+ * thread pool
+ */
+class BlockingAction : public Action {
+public:
+	virtual void execute() = 0;
+};
+
+/*
+ * Spends its time waiting on a remote service rather than doing any
+ * work, so it's run as a coroutine on the session's executor instead
+ * of occupying a thread pool worker
+ */
+class AsyncAction : public Action {
+public:
+	virtual boost::asio::awaitable<void> execute() = 0;
+};
+
+namespace detail {
+
+/*
+ * Adapts a callback-based RPC into an awaitable. The callback is invoked
+ * on whichever thread the response arrived on, so the completion is posted
+ * back to the awaiting coroutine's executor.
+ */
+template<typename Signature, typename Initiate>
+auto async_rpc(Initiate&& initiate) {
+	return boost::asio::async_initiate<const boost::asio::use_awaitable_t<>, Signature>(
+		[initiate = std::forward<Initiate>(initiate)](auto handler) mutable {
+			// RPC callbacks must be copyable, the handler isn't
+			auto shared = std::make_shared<decltype(handler)>(std::move(handler));
+
+			initiate([shared](auto... args) {
+				auto executor = boost::asio::get_associated_executor(*shared);
+
+				boost::asio::post(executor, [shared, ...args = std::move(args)]() mutable {
+					std::move(*shared)(std::move(args)...);
+				});
+			});
+		}, boost::asio::use_awaitable
+	);
+}
+
+} // detail
+
+class RegisterSessionAction final : public AsyncAction {
 	const AccountClient& account_svc_;
 	std::uint32_t account_id_;
 	srp6::SessionKey key_;
 
-	std::promise<rpc::Account::Status> promise_;
 	rpc::Account::Status res_;
 	std::exception_ptr exception_;
 
-	std::future<rpc::Account::Status> do_register() {
-		account_svc_.register_session(account_id_, key_, [&](rpc::Account::Status res) {
-			promise_.set_value(res);
-		});
-
-		return promise_.get_future();
-	}
-
 public:
 	RegisterSessionAction(const AccountClient& account_svc, std::uint32_t account_id, srp6::SessionKey key)
 	    : account_svc_(account_svc),
 		  account_id_(account_id),
 		  key_(std::move(key)) { }
 
-	virtual void execute() override try {
-		res_ = do_register().get();
+	virtual boost::asio::awaitable<void> execute() override try {
+		res_ = co_await detail::async_rpc<void(rpc::Account::Status)>([&](auto callback) {
+			account_svc_.register_session(account_id_, key_, std::move(callback));
+		});
 	} catch(const std::exception&) {
 		exception_ = std::current_exception();
 	}
@@ -65,31 +109,26 @@ public:
 	}
 };
 
-class FetchSessionKeyAction final : public Action {
+class FetchSessionKeyAction final : public AsyncAction {
 	const AccountClient& account_svc_;
 	std::uint32_t account_id_;
-	Botan::BigInt key_;
 	std::exception_ptr exception_;
 
-	std::promise<std::pair<rpc::Account::Status, Botan::BigInt>> promise_;
 	std::pair<rpc::Account::Status, Botan::BigInt> res_;
 
-	auto do_fetch() {
-		account_svc_.locate_session(account_id_, [&](rpc::Account::Status res,
-		                            Botan::BigInt key) {
-			promise_.set_value({res, key});
-		});
-
-		return promise_.get_future();
-	}
-
 public:
 	FetchSessionKeyAction(const AccountClient& account_svc, std::uint32_t account_id)
 		: account_svc_(account_svc),
 		  account_id_(account_id) {}
 
-	virtual void execute() override try {
-		res_ = do_fetch().get();
+	virtual boost::asio::awaitable<void> execute() override try {
+		auto [status, key] = co_await detail::async_rpc<void(rpc::Account::Status, Botan::BigInt)>(
+			[&](auto callback) {
+				account_svc_.locate_session(account_id_, std::move(callback));
+			}
+		);
+
+		res_ = { status, std::move(key) };
 	} catch(const std::exception&) {
 		exception_ = std::current_exception();
 	}
@@ -103,7 +142,7 @@ public:
 	}
 };
 
-class FetchUserAction final : public Action {
+class FetchUserAction final : public BlockingAction {
 	const utf8_string username_;
 	const dal::UserDAO& user_src_;
 	std::optional<User> user_;
@@ -133,7 +172,7 @@ public:
 	}
 };
 
-class FetchCharacterCounts final : public Action {
+class FetchCharacterCounts final : public BlockingAction {
 	const std::uint32_t user_id_;
 	const dal::UserDAO& user_src_;
 	std::unordered_map<std::uint32_t, std::uint32_t> counts_;
@@ -165,7 +204,7 @@ public:
 	}
 };
 
-class SaveSurveyAction final : public Action {
+class SaveSurveyAction final : public BlockingAction {
 	const dal::UserDAO& user_src_;
 	std::uint32_t user_id_;
 	std::uint32_t survey_id_;
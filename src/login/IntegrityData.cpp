@@ -49,13 +49,28 @@ void IntegrityData::add_versions(std::span<const GameVersion> versions, std::str
 auto IntegrityData::lookup(const GameVersion version,
                            const grunt::Platform platform,
                            const grunt::System os) const  -> std::optional<std::span<const std::byte>> {
-	if(auto it = data_.find({ version.build, platform, os }); it != data_.end()) {
+	return lookup({ version.build, platform, os });
+}
+
+auto IntegrityData::lookup(const detail::Key& key) const -> std::optional<std::span<const std::byte>> {
+	if(auto it = data_.find(key); it != data_.end()) {
 		return it->second;
 	} else {
 		return std::nullopt;
 	}
 }
 
+std::vector<detail::Key> IntegrityData::keys() const {
+	std::vector<detail::Key> keys;
+	keys.reserve(data_.size());
+
+	for(const auto& [key, _] : data_) {
+		keys.emplace_back(key);
+	}
+
+	return keys;
+}
+
 void IntegrityData::load_binaries(std::string_view path, std::uint16_t build,
                                   std::span<std::string_view> files,
                                   const grunt::System system,
@@ -59,6 +59,8 @@ public:
 	std::optional<std::span<const std::byte>> lookup(GameVersion version,
 	                                                 grunt::Platform platform,
 	                                                 grunt::System os) const;
+	std::optional<std::span<const std::byte>> lookup(const detail::Key& key) const;
+	std::vector<detail::Key> keys() const;
 };
 
 } // ember
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "IntegritySaltPool.h"
+#include "ExecutablesChecksum.h"
+#include <shared/metrics/Metrics.h>
+#include <shared/threading/Utility.h>
+#include <botan/auto_rng.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <utility>
+
+namespace ember {
+
+IntegritySaltPool::IntegritySaltPool(const IntegrityData& data, Metrics& metrics,
+                                     const std::size_t pool_size, const std::size_t refill_rate)
+	: data_(data),
+	  metrics_(metrics),
+	  pool_size_(pool_size),
+	  refill_rate_(refill_rate) {
+	for(const auto& key : data_.keys()) {
+		pools_[key].reserve(pool_size_);
+	}
+
+	if(pools_.empty() || !pool_size_) {
+		return;
+	}
+
+	worker_ = std::jthread(std::bind_front(&IntegritySaltPool::refill, this));
+	thread::set_name(worker_, "Integrity Salts");
+}
+
+// must be called with the lock held
+auto IntegritySaltPool::next_refill() const -> std::optional<detail::Key> {
+	std::optional<detail::Key> key;
+	std::size_t lowest = pool_size_;
+
+	// top up whichever pool is emptiest first
+	for(const auto& [pool_key, pool] : pools_) {
+		if(pool.size() < lowest) {
+			lowest = pool.size();
+			key = pool_key;
+		}
+	}
+
+	return key;
+}
+
+void IntegritySaltPool::refill(std::stop_token token) {
+	using namespace std::chrono;
+
+	Botan::AutoSeeded_RNG rng;
+	const auto interval = refill_rate_? steady_clock::duration(1s) / static_cast<steady_clock::rep>(refill_rate_)
+	                                  : steady_clock::duration::zero();
+	auto next = steady_clock::now();
+
+	while(!token.stop_requested()) {
+		std::optional<detail::Key> key;
+
+		{
+			std::unique_lock guard(lock_);
+
+			if(!cond_.wait(guard, token, [&] { return (key = next_refill()).has_value(); })) {
+				return;
+			}
+
+			if(interval != steady_clock::duration::zero()) {
+				next = std::max(next + interval, steady_clock::now());
+
+				cond_.wait_until(guard, token, next, [] { return false; });
+
+				if(token.stop_requested()) {
+					return;
+				}
+			}
+		}
+
+		const auto data = data_.lookup(*key);
+
+		if(!data) {
+			continue;
+		}
+
+		Entry entry{};
+		rng.randomize(entry.salt.data(), entry.salt.size());
+		entry.checksum = client_integrity::checksum(entry.salt, *data);
+
+		std::lock_guard guard(lock_);
+		pools_[*key].emplace_back(std::move(entry));
+	}
+}
+
+auto IntegritySaltPool::acquire(const GameVersion& version,
+                                const grunt::Platform platform,
+                                const grunt::System os) -> Entry {
+	std::optional<Entry> entry;
+	bool supported = false;
+
+	{
+		std::lock_guard guard(lock_);
+
+		if(auto it = pools_.find({ version.build, platform, os }); it != pools_.end()) {
+			supported = true;
+
+			if(!it->second.empty()) {
+				entry = std::move(it->second.back());
+				it->second.pop_back();
+				cond_.notify_one();
+			}
+		}
+	}
+
+	if(entry) {
+		metrics_.increment("integrity_salt_hit");
+		return *entry;
+	}
+
+	// clients we don't have binaries for are going to fail validation regardless
+	if(supported) {
+		metrics_.increment("integrity_salt_miss");
+	}
+
+	Entry fresh{};
+	Botan::AutoSeeded_RNG().randomize(fresh.salt.data(), fresh.salt.size());
+	return fresh;
+}
+
+std::size_t IntegritySaltPool::size() const {
+	std::lock_guard guard(lock_);
+	std::size_t size = 0;
+
+	for(const auto& [_, pool] : pools_) {
+		size += pool.size();
+	}
+
+	return size;
+}
+
+} // ember
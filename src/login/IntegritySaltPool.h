@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "GameVersion.h"
+#include "IntegrityData.h"
+#include "grunt/Magic.h"
+#include "grunt/server/LoginChallenge.h"
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+class Metrics;
+
+/*
+ * Checksumming the client binaries means running HMAC-SHA1 over several
+ * megabytes of data, keyed by a salt that's sent to the client in the
+ * login challenge. Rather than doing this on every login proof, a worker
+ * keeps a pool of salts with precomputed checksums for each supported
+ * client, leaving only the cheap finalisation step at proof time.
+ *
+ * Each salt is only handed out once. If a pool runs dry, a fresh salt
+ * is returned without a checksum and the caller has to compute it.
+ */
+class IntegritySaltPool final {
+public:
+	using Salt = std::array<std::uint8_t, grunt::server::LoginChallenge::CHECKSUM_SALT_LENGTH>;
+	using Checksum = std::array<std::uint8_t, 20>;
+
+	struct Entry {
+		Salt salt;
+		std::optional<Checksum> checksum;
+	};
+
+private:
+	const IntegrityData& data_;
+	Metrics& metrics_;
+	const std::size_t pool_size_;
+	const std::size_t refill_rate_;
+
+	boost::unordered_flat_map<detail::Key, std::vector<Entry>, detail::KeyHash> pools_;
+	mutable std::mutex lock_;
+	std::condition_variable_any cond_;
+	std::jthread worker_;
+
+	void refill(std::stop_token token);
+	std::optional<detail::Key> next_refill() const;
+
+public:
+	/*
+	 * pool_size is per supported client, refill_rate is the maximum
+	 * number of checksums to calculate per second (0 = unlimited)
+	 */
+	IntegritySaltPool(const IntegrityData& data, Metrics& metrics,
+	                  std::size_t pool_size, std::size_t refill_rate);
+
+	Entry acquire(const GameVersion& version, grunt::Platform platform, grunt::System os);
+	std::size_t size() const;
+};
+
+} // ember
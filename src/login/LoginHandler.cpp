@@ -227,7 +227,14 @@ void LoginHandler::build_login_challenge(grunt::server::LoginChallenge& packet)
 		packet.pin_salt = pin_salt_ = PINAuthenticator::generate_salt();
 	}
 
-	Botan::AutoSeeded_RNG().randomize(checksum_salt_.data(), checksum_salt_.size());
+	if(integrity_enforce_) {
+		auto entry = salt_pool_.acquire(challenge_.version, challenge_.platform, challenge_.os);
+		checksum_salt_ = entry.salt;
+		checksum_ = entry.checksum;
+	} else {
+		Botan::AutoSeeded_RNG().randomize(checksum_salt_.data(), checksum_salt_.size());
+	}
+
 	packet.checksum_salt = checksum_salt_;
 }
 
@@ -384,6 +391,8 @@ bool LoginHandler::validate_client_integrity(std::span<const std::uint8_t> clien
 	if(reconnect) {
 		constexpr std::array<std::uint8_t, SHA1_LENGTH> checksum{}; // all-zero hash
 		hash = client_integrity::finalise(checksum, salt);
+	} else if(checksum_) { // precomputed when the salt was drawn from the pool
+		hash = client_integrity::finalise(*checksum_, salt);
 	} else {
 		const auto& checksum = client_integrity::checksum(checksum_salt_, *data);
 		hash = client_integrity::finalise(checksum, salt);
@@ -490,8 +499,9 @@ void LoginHandler::on_character_data(const FetchCharacterCounts& action) {
 	if(state_ == LoginState::SURVEY_INITIATE) {
 		LOG_DEBUG(logger_) << "Initiating survey transfer..." << LOG_ASYNC;
 		auto meta = survey_.meta(challenge_.platform, challenge_.os);
-		assert(meta);
-		initiate_file_transfer(*meta);
+		auto data = survey_.data(challenge_.platform, challenge_.os);
+		assert(meta && data);
+		initiate_file_transfer(*meta, *data);
 	}
 }
 
@@ -557,17 +567,14 @@ void LoginHandler::send_realm_list(const grunt::Packet& packet) {
 
 	auto& [_, region] = *it;
 
-	const std::shared_ptr<const RealmMap> realms = realm_list_.realms();
+	const auto encoded = realm_list_.encoded(locale_enforce_? std::optional(region) : std::nullopt);
 	const auto& char_count = std::get<CharacterCount>(state_data_);
-	grunt::server::RealmList response;
-
-	for(const auto& [_, realm] : *realms) {
-		if(!locale_enforce_ || realm.region == region) {
-			if(auto count = char_count.find(realm.id); count != char_count.end()) {
-				response.realms.emplace_back(realm, count->second);
-			} else {
-				response.realms.emplace_back(realm, 0);
-			}
+	grunt::server::PreparedRealmList response(encoded->packet);
+
+	// the list is pre-encoded with zero counts, so only non-zero counts need patching
+	for(const auto& [realm_id, offset] : encoded->slots) {
+		if(auto count = char_count.find(realm_id); count != char_count.end() && count->second) {
+			response.characters.emplace_back(offset, gsl::narrow_cast<std::uint8_t>(count->second));
 		}
 	}
 
@@ -593,14 +600,12 @@ void LoginHandler::patch_client(const grunt::client::LoginChallenge& challenge)
 	auto& fmeta = meta->file_meta;
 
 	LOG_DEBUG(logger_) << "Initiating patch transfer, " << fmeta.name << LOG_ASYNC;
-	std::ifstream patch(fmeta.path + fmeta.name, std::ifstream::binary);
+	const auto data = patcher_.patch_data(*meta);
 
-	if(!patch) {
+	if(!data) {
 		LOG_ERROR(logger_) << "Could not open patch, " << fmeta.name << LOG_ASYNC;
 		return;
 	}
-
-	transfer_state_.file = std::move(patch);
 	
 	if(meta->mpq) {
 		fmeta.name = "Patch";
@@ -608,13 +613,13 @@ void LoginHandler::patch_client(const grunt::client::LoginChallenge& challenge)
 
 	metrics_.increment("patches_sent");
 	update_state(LoginState::PATCH_INITIATE);
-	initiate_file_transfer(fmeta);
+	initiate_file_transfer(fmeta, *data);
 }
 
-void LoginHandler::initiate_file_transfer(const FileMeta& meta) {
+void LoginHandler::initiate_file_transfer(const FileMeta& meta, std::span<const std::byte> data) {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 	
-	transfer_state_.size = meta.size;
+	transfer_state_.data = data;
 
 	grunt::server::TransferInitiate response;
 	response.filename = meta.name;
@@ -664,11 +669,18 @@ void LoginHandler::on_survey_write(const SaveSurveyAction& action) {
 	}
 }
 
-void LoginHandler::set_transfer_offset(const grunt::Packet& packet) {
+bool LoginHandler::set_transfer_offset(const grunt::Packet& packet) {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
 	auto& resume = dynamic_cast<const grunt::client::TransferResume&>(packet);
+
+	if(resume.offset > transfer_state_.data.size()) {
+		LOG_DEBUG(logger_) << "Invalid transfer resume offset from " << source_ip_ << LOG_ASYNC;
+		return false;
+	}
+
 	transfer_state_.offset = resume.offset;
+	return true;
 }
 
 void LoginHandler::handle_transfer_ack(const grunt::Packet& packet, bool survey) {
@@ -676,11 +688,14 @@ void LoginHandler::handle_transfer_ack(const grunt::Packet& packet, bool survey)
 
 	switch(packet.opcode) {
 		case grunt::Opcode::CMD_XFER_RESUME:
-			set_transfer_offset(packet);
+			if(!set_transfer_offset(packet)) {
+				update_state(LoginState::CLOSED);
+				break;
+			}
 			[[fallthrough]];
 		case grunt::Opcode::CMD_XFER_ACCEPT:
 			update_state(survey? LoginState::SURVEY_TRANSFER : LoginState::PATCH_TRANSFER);
-			transfer_chunk();
+			fill_transfer_pipeline();
 			break;
 		case grunt::Opcode::CMD_XFER_CANCEL:
 			update_state(survey? LoginState::SURVEY_RESULT : LoginState::CLOSED);
@@ -696,35 +711,35 @@ void LoginHandler::handle_transfer_abort() {
 	transfer_state_.abort = true;
 }
 
-void LoginHandler::transfer_chunk() {
+/*
+ * Chunks reference the patch or survey data directly rather than being
+ * copied into the packet, so several can be queued on the socket at once
+ * without any additional memory cost. Always sends at least one chunk,
+ * even if it's empty, so the client sees the end of the transfer.
+ */
+void LoginHandler::fill_transfer_pipeline() {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
-	auto remaining = transfer_state_.size - transfer_state_.offset;
-	std::uint16_t read_size = grunt::server::TransferData::MAX_CHUNK_SIZE;
-
-	if(read_size > remaining) {
-		read_size = gsl::narrow<std::uint16_t>(remaining);
-	}
+	do {
+		transfer_chunk();
+	} while(transfer_state_.in_flight < transfer_pipeline_
+	        && transfer_state_.offset < transfer_state_.data.size());
+}
 
-	grunt::server::TransferData response;
-	response.size = read_size;
+void LoginHandler::transfer_chunk() {
+	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
-	if(state_ == LoginState::SURVEY_TRANSFER) {
-		auto survey_mpq = survey_.data(challenge_.platform, challenge_.os)->begin();
-		survey_mpq += gsl::narrow<int>(transfer_state_.offset);
-		std::copy(survey_mpq, survey_mpq + read_size, response.chunk.data());
-	} else {
-		transfer_state_.file.read(reinterpret_cast<char*>(response.chunk.data()), read_size);
+	const auto remaining = transfer_state_.data.size() - transfer_state_.offset;
+	const auto chunk_size = std::min<std::size_t>(remaining, grunt::server::TransferData::MAX_CHUNK_SIZE);
 
-		if(!transfer_state_.file.good()) {
-			LOG_ERROR(logger_) << "Patch reading failed during transfer" << LOG_ASYNC;
-			return;
-		}
-	}
+	grunt::server::TransferData response;
+	response.size = gsl::narrow<std::uint16_t>(chunk_size);
+	response.chunk = transfer_state_.data.subspan(transfer_state_.offset, chunk_size);
 
-	transfer_state_.offset += read_size;
+	transfer_state_.offset += chunk_size;
+	++transfer_state_.in_flight;
 
-	send_cb(response, [&]() {
+	send_chunk(response, [this]() {
 		on_chunk_complete();
 	});
 }
@@ -732,12 +747,18 @@ void LoginHandler::transfer_chunk() {
 void LoginHandler::on_chunk_complete() {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
+	--transfer_state_.in_flight;
+
 	if(transfer_state_.abort) {
 		return;
 	}
 
 	// transfer complete?
-	if(transfer_state_.offset == transfer_state_.size) {
+	if(transfer_state_.offset == transfer_state_.data.size()) {
+		if(transfer_state_.in_flight) {
+			return;
+		}
+
 		switch(state_) {
 			case LoginState::SURVEY_TRANSFER:
 				update_state(LoginState::SURVEY_RESULT);
@@ -749,7 +770,7 @@ void LoginHandler::on_chunk_complete() {
 				break;
 		}
 	} else {
-		transfer_chunk();
+		fill_transfer_pipeline();
 	}
 }
 
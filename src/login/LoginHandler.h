@@ -11,6 +11,7 @@
 #include "Actions.h"
 #include "Authenticator.h"
 #include "GameVersion.h"
+#include "IntegritySaltPool.h"
 #include "LoginHandlerFwd.h"
 #include "LoginState.h"
 #include "PINAuthenticator.h"
@@ -19,8 +20,8 @@
 #include "grunt/ResultCodes.h"
 #include <logger/LoggerFwd.h>
 #include <botan/bigint.h>
+#include <algorithm>
 #include <array>
-#include <fstream>
 #include <functional>
 #include <memory>
 #include <span>
@@ -29,13 +30,14 @@
 #include <unordered_map>
 #include <utility>
 #include <variant>
+#include <cstddef>
 
 namespace ember {
 
 struct TransferState {
-	std::ifstream file;
+	std::span<const std::byte> data;
 	std::uint64_t offset;
-	std::uint64_t size;
+	std::size_t in_flight;
 	bool abort;
 };
 
@@ -58,21 +60,24 @@ class LoginHandler final {
 	const std::string source_ip_;
 	const AccountClient& acct_svc_;
 	const IntegrityData& bin_data_;
+	IntegritySaltPool& salt_pool_;
 	const Survey& survey_;
 
 	StateContainer state_data_;
 	std::optional<User> user_;
 	Botan::BigInt server_proof_;
 	std::array<std::uint8_t, CHECKSUM_SALT_LEN> checksum_salt_;
+	std::optional<IntegritySaltPool::Checksum> checksum_;
 	PINAuthenticator::SaltBytes pin_salt_;
 	std::uint32_t pin_grid_seed_;
 	grunt::client::LoginChallenge challenge_;
 	TransferState transfer_state_;
 	const bool locale_enforce_;
 	const bool integrity_enforce_;
+	const std::size_t transfer_pipeline_;
 
 	void initiate_login(const grunt::Packet& packet);
-	void initiate_file_transfer(const FileMeta& meta);
+	void initiate_file_transfer(const FileMeta& meta, std::span<const std::byte> data);
 
 	void handle_login_proof(const grunt::Packet& packet);
 	void handle_reconnect_proof(const grunt::Packet& packet);
@@ -91,8 +96,9 @@ class LoginHandler final {
 	void on_session_write(const RegisterSessionAction& action);
 	void on_survey_write(const SaveSurveyAction& action);
 
+	void fill_transfer_pipeline();
 	void transfer_chunk();
-	void set_transfer_offset(const grunt::Packet& packet);
+	bool set_transfer_offset(const grunt::Packet& packet);
 
 	bool validate_pin(const grunt::client::LoginProof& packet) const;
 	bool validate_protocol_version(const grunt::client::LoginChallenge& challenge) const;
@@ -117,19 +123,22 @@ public:
 	std::function<void(std::unique_ptr<Action> action)> execute_async;
 	std::function<void(const grunt::Packet&)> send;
 	std::function<void(const grunt::Packet&, std::function<void()>)> send_cb;
+	std::function<void(const grunt::server::TransferData&, std::function<void()>)> send_chunk;
 
 	bool update_state(const Action& action);
 	bool update_state(const grunt::Packet& packet);
 	void on_chunk_complete();
 
 	LoginHandler(const dal::UserDAO& users, const AccountClient& acct_svc, const Patcher& patcher,
-	             const IntegrityData& bin_data, const Survey& survey, log::Logger* logger,
+	             const IntegrityData& bin_data, IntegritySaltPool& salt_pool,
+	             const Survey& survey, log::Logger* logger,
 	             const RealmList& realm_list, std::string source, Metrics& metrics,
-	             bool locale_enforce, bool integrity_enforce)
+	             bool locale_enforce, bool integrity_enforce, std::size_t transfer_pipeline)
 	             : user_src_(users), patcher_(patcher), logger_(logger), acct_svc_(acct_svc),
 	               realm_list_(realm_list), source_ip_(std::move(source)), metrics_(metrics),
-	               bin_data_(bin_data), survey_(survey), transfer_state_{},
+	               bin_data_(bin_data), salt_pool_(salt_pool), survey_(survey), transfer_state_{},
 	               locale_enforce_(locale_enforce), integrity_enforce_(integrity_enforce),
+	               transfer_pipeline_(std::max<std::size_t>(transfer_pipeline, 1)),
 	               pin_grid_seed_(0) { }
 };
 
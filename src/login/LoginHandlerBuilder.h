@@ -10,6 +10,7 @@
 
 #include "LoginHandler.h"
 #include <utility>
+#include <cstddef>
 
 namespace ember {
 
@@ -21,23 +22,30 @@ class LoginHandlerBuilder final {
 	const AccountClient &acct_svc_;
 	const Survey& survey_;
 	const IntegrityData& bin_data_;
+	IntegritySaltPool& salt_pool_;
 	Metrics& metrics_;
 	bool locale_enforce_;
 	bool integrity_enforce_;
+	std::size_t transfer_pipeline_;
 
 public:
 	LoginHandlerBuilder(log::Logger* logger, const Patcher& patcher, const Survey& survey,
-	                    const IntegrityData& exe_data, const dal::UserDAO& user_dao,
+	                    const IntegrityData& exe_data, IntegritySaltPool& salt_pool,
+	                    const dal::UserDAO& user_dao,
 	                    const AccountClient& acct_svc, const RealmList& realm_list,
-	                    Metrics& metrics, bool locale_enforce, bool integrity_enforce)
+	                    Metrics& metrics, bool locale_enforce, bool integrity_enforce,
+	                    std::size_t transfer_pipeline)
 	                    : logger_(logger), patcher_(patcher), user_dao_(user_dao),
 	                      acct_svc_(acct_svc), realm_list_(realm_list), metrics_(metrics),
-	                      survey_(survey), bin_data_(exe_data), locale_enforce_(locale_enforce),
-	                      integrity_enforce_(integrity_enforce) {}
+	                      survey_(survey), bin_data_(exe_data), salt_pool_(salt_pool),
+	                      locale_enforce_(locale_enforce),
+	                      integrity_enforce_(integrity_enforce),
+	                      transfer_pipeline_(transfer_pipeline) {}
 
 	LoginHandler create(std::string source) const {
-		return { user_dao_, acct_svc_, patcher_, bin_data_, survey_, logger_, realm_list_,
-		         std::move(source), metrics_, locale_enforce_, integrity_enforce_ };
+		return { user_dao_, acct_svc_, patcher_, bin_data_, salt_pool_, survey_, logger_, realm_list_,
+		         std::move(source), metrics_, locale_enforce_, integrity_enforce_,
+		         transfer_pipeline_ };
 	}
 };
 
@@ -15,6 +15,7 @@ class Patcher;
 class Metrics;
 class Survey;
 class IntegrityData;
+class IntegritySaltPool;
 class AccountClient;
 class RealmList;
 namespace dal { class UserDAO; }
@@ -9,23 +9,32 @@
 #include "LoginSession.h"
 #include "LoginHandlerBuilder.h"
 #include "FilterTypes.h"
+#include "grunt/server/TransferData.h"
 #include <logger/Logger.h>
 #include <shared/metrics/Metrics.h>
 #include <shared/threading/ThreadPool.h>
+#include <spark/buffers/pmr/BinaryStream.h>
+#include <spark/buffers/pmr/BufferAdaptor.h>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
 #include <boost/asio/post.hpp>
+#include <chrono>
 #include <exception>
 #include <functional>
 #include <memory>
 #include <utility>
+#include <vector>
+#include <cstddef>
 
 namespace ember {
 
 LoginSession::LoginSession(SessionManager& sessions, tcp_socket socket, log::Logger* logger,
-                           ThreadPool& pool, const LoginHandlerBuilder& builder)
+                           ThreadPool& pool, Metrics& metrics, const LoginHandlerBuilder& builder)
                            : NetworkSession(sessions, std::move(socket), logger),
                              handler_(builder.create(remote_address())),
                              logger_(logger),
                              pool_(pool),
+                             metrics_(metrics),
                              grunt_handler_(logger) {
 	handler_.send = [&](auto& packet) {
 		write_packet(packet, nullptr);
@@ -35,6 +44,10 @@ LoginSession::LoginSession(SessionManager& sessions, tcp_socket socket, log::Log
 		write_packet(packet, std::move(cb));
 	};
 
+	handler_.send_chunk = [&](auto& packet, auto cb) {
+		write_chunk(packet, std::move(cb));
+	};
+
 	handler_.execute_async = [&](auto action) {
 		execute_async(std::move(action));
 	};
@@ -63,11 +76,31 @@ void LoginSession::execute_async(std::unique_ptr<Action> action) {
 
 	auto self(shared_from_this());
 	std::shared_ptr<Action> shared_act(std::move(action));
+	const auto start = std::chrono::steady_clock::now();
+
+	// RPCs only need to wait for a response, so don't tie up a worker
+	if(auto async = std::dynamic_pointer_cast<AsyncAction>(shared_act)) {
+		auto coro = [&, action = std::move(async), self, start]() -> boost::asio::awaitable<void> {
+			co_await action->execute();
+			record_latency("rpc_action_latency", start);
+
+			if(!is_stopped()) {
+				async_completion(*action.get());
+			}
+		};
+
+		boost::asio::co_spawn(get_executor(), std::move(coro), boost::asio::detached);
+		return;
+	}
 
-	pool_.run([&, action = std::move(shared_act), self]() mutable {
+	auto blocking = std::static_pointer_cast<BlockingAction>(std::move(shared_act));
+
+	pool_.run([&, action = std::move(blocking), self, start]() mutable {
 		action->execute();
 
-		boost::asio::post(get_executor(), [&, action = std::move(action), self] {
+		boost::asio::post(get_executor(), [&, action = std::move(action), self, start] {
+			record_latency("action_latency", start);
+
 			if(!is_stopped()) {
 				async_completion(*action.get());
 			}
@@ -75,6 +108,11 @@ void LoginSession::execute_async(std::unique_ptr<Action> action) {
 	});
 }
 
+void LoginSession::record_latency(const char* key, const std::chrono::steady_clock::time_point start) {
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	metrics_.timing(key, std::chrono::duration_cast<std::chrono::milliseconds>(elapsed));
+}
+
 void LoginSession::async_completion(Action& action) try {
 	LOG_TRACE_FILTER(logger_, LF_NETWORK) << log_func << LOG_ASYNC;
 
@@ -95,4 +133,16 @@ void LoginSession::write_packet(const grunt::Packet& packet, WriteCallback&& cb)
 	write(packet, std::move(cb));
 }
 
+void LoginSession::write_chunk(const grunt::server::TransferData& packet, WriteCallback&& cb) {
+	LOG_TRACE_FILTER(logger_, LF_NETWORK) << log_func << LOG_ASYNC;
+
+	std::vector<std::byte> header;
+	header.reserve(grunt::server::TransferData::HEADER_LENGTH);
+	spark::io::pmr::BufferAdaptor adaptor(header);
+	spark::io::pmr::BinaryStream stream(adaptor);
+	packet.write_header(stream);
+
+	write(std::move(header), packet.chunk, std::move(cb));
+}
+
 } // ember
\ No newline at end of file
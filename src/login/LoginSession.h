@@ -12,30 +12,36 @@
 #include "NetworkSession.h"
 #include "SocketType.h"
 #include "grunt/Packet.h"
+#include "grunt/PacketFwd.h"
 #include "grunt/Handler.h"
 #include <logger/LoggerFwd.h>
 #include <shared/threading/ThreadPool.h>
 #include <spark/buffers/pmr/Buffer.h>
+#include <chrono>
 #include <memory>
 
 namespace ember {
 
 class LoginHandlerBuilder;
+class Metrics;
 class ThreadPool;
 
 class LoginSession final : public NetworkSession<LoginSession> {
 	ThreadPool& pool_;
+	Metrics& metrics_;
 	LoginHandler handler_;
 	log::Logger* logger_;
 	grunt::Handler grunt_handler_;
 
 	void async_completion(Action& action);
 	void write_packet(const grunt::Packet& packet, WriteCallback&& cb);
+	void write_chunk(const grunt::server::TransferData& packet, WriteCallback&& cb);
 	void execute_async(std::unique_ptr<Action> action);
+	void record_latency(const char* key, std::chrono::steady_clock::time_point start);
 
 public:
 	LoginSession(SessionManager& sessions, tcp_socket socket, log::Logger* logger,
-	             ThreadPool& pool, const LoginHandlerBuilder& builder);
+	             ThreadPool& pool, Metrics& metrics, const LoginHandlerBuilder& builder);
 
 	bool handle_packet(spark::io::pmr::Buffer& buffer);
 };
@@ -17,23 +17,37 @@
 #include <shared/IPBanCache.h>
 #include <shared/memory/ASIOAllocator.h>
 #include <shared/metrics/Metrics.h>
+#include <shared/util/ReusePort.h>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #include <cstdint>
 #include <cstddef>
 
 namespace ember {
 
+/*
+ * Every acceptor shares the io_context, so with more than one (which
+ * requires SO_REUSEPORT), the kernel spreads incoming connections between
+ * them and their ban checks and session setup can run on several threads
+ * at once, rather than each accept waiting on the last.
+ */
 class NetworkListener final {
 	using tcp_acceptor = boost::asio::basic_socket_acceptor<
 		boost::asio::ip::tcp, boost::asio::io_context::executor_type>;
 
+	struct Acceptor {
+		tcp_acceptor acceptor;
+		tcp_socket socket;
+	};
+
 	boost::asio::io_context& io_context;
-	tcp_acceptor acceptor_;
-	tcp_socket socket_;
+	std::vector<std::unique_ptr<Acceptor>> acceptors_;
 
 	SessionManager sessions_;
 	const NetworkSessionBuilder& session_builder_;
@@ -41,35 +55,33 @@ class NetworkListener final {
 	Metrics& metrics_;
 	IPBanCache& ban_list_;
 
-	void accept_connection() {
+	void accept_connection(Acceptor& acceptor) {
 		LOG_TRACE_FILTER(logger_, LF_NETWORK) << log_func << LOG_ASYNC;
 
-		if(!acceptor_.is_open()) {
+		if(!acceptor.acceptor.is_open()) {
 			return;
 		}
 
-		acceptor_.async_accept(socket_, [this](boost::system::error_code ec) {
+		acceptor.acceptor.async_accept(acceptor.socket, [this, &acceptor](boost::system::error_code ec) {
 			if(ec == boost::asio::error::operation_aborted) {
 				return;
 			}
 
+			auto& socket = acceptor.socket;
+
 			if(!ec) {
-				const auto& ep = socket_.remote_endpoint(ec);
+				const auto& ep = socket.remote_endpoint(ec);
 
+				// the next connection still needs to be accepted, don't bail out early
 				if(ec) {
 					LOG_DEBUG_FILTER(logger_, LF_NETWORK)
 						<< "Aborted connection, remote peer disconnected" << LOG_ASYNC;
 					metrics_.increment("aborted_connections");
-					return;
-				}
-
-				const auto& ip = ep.address();
-
-				if(!ban_list_.is_banned(ip)) {
+				} else if(const auto& ip = ep.address(); !ban_list_.is_banned(ip)) {
 					LOG_DEBUG_FILTER(logger_, LF_NETWORK)
 						<< "Accepted connection " << ip.to_string() << LOG_ASYNC;
 					metrics_.increment("accepted_connections");
-					start_session(std::move(socket_));
+					start_session(std::move(socket));
 				} else {
 					LOG_DEBUG_FILTER(logger_, LF_NETWORK)
 						<< "Rejected connection " << ip.to_string()
@@ -78,8 +90,8 @@ class NetworkListener final {
 				}
 			}
 
-			socket_ = tcp_socket(boost::asio::make_strand(io_context));
-			accept_connection();
+			socket = tcp_socket(boost::asio::make_strand(io_context));
+			accept_connection(acceptor);
 		});
 	}
 
@@ -91,24 +103,39 @@ class NetworkListener final {
 
 public:
 	NetworkListener(boost::asio::io_context& io_context, const std::string& interface, std::uint16_t port,
-	                bool tcp_no_delay, const NetworkSessionBuilder& session_create, IPBanCache& bans,
-	                log::Logger* logger, Metrics& metrics)
-	                : acceptor_(io_context, boost::asio::ip::tcp::endpoint(
-	                            boost::asio::ip::address::from_string(interface), port)),
-	                  io_context(io_context),
-	                  socket_(boost::asio::make_strand(io_context)),
+	                bool tcp_no_delay, std::size_t acceptors, const NetworkSessionBuilder& session_create,
+	                IPBanCache& bans, log::Logger* logger, Metrics& metrics)
+	                : io_context(io_context),
 	                  session_builder_(session_create),
 	                  logger_(logger),
 	                  metrics_(metrics),
 	                  ban_list_(bans) {
-		acceptor_.set_option(boost::asio::ip::tcp::no_delay(tcp_no_delay));
-		acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-		accept_connection();
+		boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address::from_string(interface), port);
+
+		for(std::size_t i = 0; i < std::max<std::size_t>(acceptors, 1); ++i) {
+			auto& acceptor = acceptors_.emplace_back(std::make_unique<Acceptor>(
+				tcp_acceptor(io_context), tcp_socket(boost::asio::make_strand(io_context))
+			));
+
+			util::listen(acceptor->acceptor, endpoint, acceptors > 1);
+			acceptor->acceptor.set_option(boost::asio::ip::tcp::no_delay(tcp_no_delay));
+
+			// if the port was chosen by the OS, the others need to share it
+			endpoint = acceptor->acceptor.local_endpoint();
+		}
+
+		for(auto& acceptor : acceptors_) {
+			accept_connection(*acceptor);
+		}
 	}
 
 	void shutdown() {
 		LOG_TRACE_FILTER(logger_, LF_NETWORK) << log_func << LOG_ASYNC;
-		acceptor_.close();
+
+		for(auto& acceptor : acceptors_) {
+			acceptor->acceptor.close();
+		}
+
 		sessions_.stop_all();
 	}
 
@@ -117,7 +144,7 @@ public:
 	}
 
 	std::uint16_t port() const {
-		return acceptor_.local_endpoint().port();
+		return acceptors_.front()->acceptor.local_endpoint().port();
 	}
 };
 
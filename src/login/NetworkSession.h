@@ -13,18 +13,25 @@
 #include "SocketType.h"
 #include <logger/Logger.h>
 #include <spark/buffers/pmr/BinaryStream.h>
+#include <spark/buffers/pmr/BufferAdaptor.h>
 #include <spark/buffers/DynamicBuffer.h>
 #include <spark/buffers/BufferSequence.h>
 #include <shared/memory/ASIOAllocator.h>
+#include <shared/threading/TimerWheel.h>
 #include <boost/asio/io_context.hpp>
-#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <array>
 #include <chrono>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
+#include <vector>
+#include <cstddef>
 #include <cstdint>
 
 namespace ember {
@@ -37,17 +44,25 @@ public:
 private:
 	using Buffer = spark::io::DynamicBuffer<1024>;
 
+	struct QueuedWrite {
+		std::vector<std::byte> header;
+		std::span<const std::byte> payload;
+		WriteCallback cb;
+	};
+
 	const std::chrono::seconds SOCKET_ACTIVITY_TIMEOUT { 60 };
 	ASIOAllocator<thread_safe> allocator_;
 
 	SessionManager& sessions_;
 	tcp_socket socket_;
-	boost::asio::steady_timer timer_;
+	TimerWheel& timers_;
+	TimerWheel::TimerID timer_id_;
 
 	Buffer inbound_buffer_;
 	Buffer* outbound_front_;
 	Buffer* outbound_back_;
 	std::array<Buffer, 2> outbound_buffers_{};
+	std::deque<QueuedWrite> queued_writes_;
 	bool write_in_progress_;
 	bool is_active_;
 
@@ -107,6 +122,12 @@ private:
 
 					if(!outbound_front_->empty()) {
 						write(std::move(cb));
+					} else if(!queued_writes_.empty()) {
+						write_queued();
+
+						if(cb) {
+							cb();
+						}
 					} else { // all done!
 						write_in_progress_ = false;
 					
@@ -121,6 +142,47 @@ private:
 		}));
 	}
 
+	/*
+	 * Sends the queued header and payload as a single gather-write, with
+	 * the payload being referenced rather than copied. Anything written
+	 * while the queue is non-empty is appended to it to preserve ordering.
+	 */
+	void write_queued() {
+		auto self(this->shared_from_this());
+		const auto& entry = queued_writes_.front();
+
+		const std::array buffers {
+			boost::asio::buffer(entry.header),
+			boost::asio::buffer(entry.payload.data(), entry.payload.size())
+		};
+
+		set_is_active(true);
+
+		boost::asio::async_write(socket_, buffers, create_alloc_handler(allocator_,
+			[this, self](boost::system::error_code ec, std::size_t) {
+			if(ec) {
+				if(ec != boost::asio::error::operation_aborted) {
+					close_session();
+				}
+
+				return;
+			}
+
+			auto cb = std::move(queued_writes_.front().cb);
+			queued_writes_.pop_front();
+
+			if(!queued_writes_.empty()) {
+				write_queued();
+			} else {
+				write_in_progress_ = false;
+			}
+
+			if(cb) {
+				cb();
+			}
+		}));
+	}
+
 	/*
 	 * Timeout works by starting a timer that elapses every n seconds
 	 * and checks whether any activity has occured on the socket since
@@ -128,43 +190,40 @@ private:
 	 * will be closed. Any activity marks the socket as active, with
 	 * the timer setting it back to inactive each time it elapses.
 	 * 
-	 * The previous method restarted the timer on any activity but restarting
-	 * the timer on every packet is expensive. The only drawback
-	 * is that the timeout won't be as precise but the upperbound will
-	 * be roughly n*2, except in the case where the socket has never sent
-	 * any data at all (still n). Acceptable!
+	 * Restarting the timer on every packet would be cheap enough now that
+	 * timers live in the io_context's shared timer wheel rather than each
+	 * session owning one, but there's no need for precise timeouts. The
+	 * upperbound will be roughly n*2, except in the case where the socket
+	 * has never sent any data at all (still n). Acceptable!
 	 * 
-	 * Better yet would be a single timer per thread but this is complicated
-	 * by the way the threading model and session lifetime management has
-	 * been designed for the login service.
+	 * The wheel may invoke the callback on any of the threads running the
+	 * io_context, so it has to hop back onto the session's strand.
 	 */
 	void start_timer() {
 		auto self(this->shared_from_this());
 		set_is_active(false);
 
-		timer_.expires_from_now(SOCKET_ACTIVITY_TIMEOUT);
-		timer_.async_wait([this, self](const boost::system::error_code& ec) {
-			if(ec == boost::asio::error::operation_aborted) {
-				return;
-			}
+		timer_id_ = timers_.schedule(SOCKET_ACTIVITY_TIMEOUT, [this, self] {
+			boost::asio::post(socket_.get_executor(), [this, self] {
+				if(stopped_) {
+					return;
+				}
 
-			if(is_active_) {
-				start_timer();
-			} else {
-				timeout(ec);
-			}
+				if(is_active_) {
+					start_timer();
+				} else {
+					timeout();
+				}
+			});
 		});
 	}
 
 	void stop_timer() {
-		timer_.cancel();
+		timers_.cancel(timer_id_);
+		timer_id_ = TimerWheel::INVALID_TIMER;
 	}
 
-	void timeout(const boost::system::error_code& ec) {
-		if(ec || stopped_) { // if ec is set, the timer was aborted (session close / refreshed)
-			return;
-		}
-
+	void timeout() {
 		LOG_DEBUG_FILTER(logger_, LF_NETWORK)
 			<< "Idle timeout triggered on " << remote_address() << LOG_ASYNC;
 
@@ -179,7 +238,8 @@ public:
 	NetworkSession(SessionManager& sessions, tcp_socket socket, log::Logger* logger)
 	               : sessions_(sessions),
 	                 socket_(std::move(socket)),
-	                 timer_(socket_.get_executor()),
+	                 timers_(TimerWheel::get(socket_.get_executor().get_inner_executor().context())),
+	                 timer_id_(TimerWheel::INVALID_TIMER),
 	                 outbound_front_(&outbound_buffers_.front()),
 	                 outbound_back_(&outbound_buffers_.back()),
 	                 write_in_progress_(false),
@@ -206,6 +266,15 @@ public:
 			return;
 		}
 
+		if(!queued_writes_.empty()) {
+			QueuedWrite entry { .cb = std::move(cb) };
+			spark::io::pmr::BufferAdaptor adaptor(entry.header);
+			spark::io::pmr::BinaryStream stream(adaptor);
+			data.write_to_stream(stream);
+			queued_writes_.emplace_back(std::move(entry));
+			return;
+		}
+
 		spark::io::pmr::BinaryStream stream(*outbound_back_);
 		data.write_to_stream(stream); // todo, provide operator<< for packets?
 
@@ -213,11 +282,29 @@ public:
 			write_in_progress_ = true;
 			std::swap(outbound_front_, outbound_back_);
 			write(std::move(cb));
-		} else {
+		} else if(cb) {
 			cb();
 		}
 	}
 
+	/*
+	 * Writes the header followed by the payload without copying the payload
+	 * into the outbound buffers. The payload must remain valid until the
+	 * callback has been invoked or the session has been stopped.
+	 */
+	void write(std::vector<std::byte> header, std::span<const std::byte> payload, WriteCallback cb) {
+		if(!socket_.is_open()) {
+			return;
+		}
+
+		queued_writes_.emplace_back(std::move(header), payload, std::move(cb));
+
+		if(!write_in_progress_) {
+			write_in_progress_ = true;
+			write_queued();
+		}
+	}
+
 	boost::asio::any_io_executor get_executor() {
 		return socket_.get_executor();
 	}
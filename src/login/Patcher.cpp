@@ -10,6 +10,7 @@
 #include "PatchGraph.h"
 #include <shared/util/FileMD5.h>
 #include <boost/endian/conversion.hpp>
+#include <boost/interprocess/file_mapping.hpp>
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
@@ -147,6 +148,32 @@ auto Patcher::check_version(const GameVersion& client_version) const -> PatchLev
 	return PatchLevel::TOO_NEW;
 }
 
+auto Patcher::patch_data(const PatchMeta& meta) const -> std::optional<std::span<const std::byte>> try {
+	using namespace boost::interprocess;
+
+	std::lock_guard guard(mappings_lock_);
+	auto it = mappings_.find(meta.id);
+
+	if(it == mappings_.end()) {
+		const auto& fmeta = meta.file_meta;
+		file_mapping file((fmeta.path + fmeta.name).c_str(), read_only);
+		mapped_region region(file, read_only);
+
+		// the file has changed since the metadata was loaded
+		if(region.get_size() != fmeta.size) {
+			return std::nullopt;
+		}
+
+		region.advise(mapped_region::advice_sequential);
+		it = mappings_.emplace(meta.id, std::move(region)).first;
+	}
+
+	const auto& region = it->second;
+	return std::span(static_cast<const std::byte*>(region.get_address()), region.get_size());
+} catch(const boost::interprocess::interprocess_exception&) {
+	return std::nullopt;
+}
+
 std::vector<PatchMeta> Patcher::load_patches(const std::string& path,
                                              const dal::PatchDAO& dao,
                                              log::Logger* logger) {
@@ -15,10 +15,13 @@
 #include <shared/database/objects/PatchMeta.h>
 #include <shared/util/FNVHash.h>
 #include <logger/Logger.h>
+#include <boost/interprocess/mapped_region.hpp>
+#include <mutex>
 #include <span>
 #include <string>
 #include <string_view>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 #include <cstddef>
 
@@ -51,6 +54,9 @@ class Patcher final {
 	std::unordered_map<Key, PatchGraph, KeyHash> graphs_;
 	std::unordered_map<Key, std::vector<PatchMeta>, KeyHash> patch_bins;
 
+	mutable std::mutex mappings_lock_;
+	mutable std::unordered_map<std::uint32_t, boost::interprocess::mapped_region> mappings_;
+
 	const PatchMeta* locate_rollup(std::span<const PatchMeta> patches,
 	                               std::uint16_t from, std::uint16_t to) const;
 
@@ -66,6 +72,13 @@ public:
 
 	PatchLevel check_version(const GameVersion& client_version) const;
 
+	/*
+	 * Patches are mapped into memory the first time they're requested and
+	 * remain mapped for the lifetime of the patcher, so every session
+	 * transferring a patch shares the same pages
+	 */
+	std::optional<std::span<const std::byte>> patch_data(const PatchMeta& meta) const;
+
 	static std::vector<PatchMeta> load_patches(const std::string& path,
 	                                           const dal::PatchDAO& dao,
 	                                           log::Logger* logger);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015 - 2022 Ember
+ * Copyright (c) 2015 - 2024 Ember
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,11 +7,18 @@
  */
 
 #include "RealmList.h"
+#include "grunt/server/RealmList.h"
+#include <spark/buffers/pmr/BinaryStream.h>
+#include <spark/buffers/pmr/BufferAdaptor.h>
 #include <utility>
 
 namespace ember {
 
-RealmList::RealmList(std::span<const Realm> realms) : realms_(std::make_shared<RealmMap>()) {
+RealmList::RealmList() : snapshot_(std::make_shared<Snapshot>()) {
+	update({});
+}
+
+RealmList::RealmList(std::span<const Realm> realms) : RealmList() {
 	add_realm(realms);
 }
 
@@ -19,31 +26,70 @@ void RealmList::add_realm(std::span<const Realm> realms) {
 	// ensure consistency if we add from multiple workers (not a thread safety issue)
 	std::lock_guard guard(lock_);
 
-	auto realm_map = realms_.load();
-	auto copy = std::make_shared<RealmMap>(*realm_map);
+	auto copy = snapshot_.load()->realms;
 	
 	for(const auto& realm : realms) {
-		(*copy)[realm.id] = realm;
+		copy[realm.id] = realm;
 	}
 
-	realms_ = copy;
+	update(std::move(copy));
 }
 
 void RealmList::add_realm(Realm realm) {
 	// ensure consistency if we add from multiple workers (not a thread safety issue)
 	std::lock_guard guard(lock_);
 
-	auto realm_map = realms_.load();
-	auto copy = std::make_shared<RealmMap>(*realm_map);
-	(*copy)[realm.id] = std::move(realm);
+	auto copy = snapshot_.load()->realms;
+	copy[realm.id] = std::move(realm);
+	update(std::move(copy));
+}
+
+// must be called with the lock held
+void RealmList::update(RealmMap realms) {
+	auto snapshot = std::make_shared<Snapshot>();
+	snapshot->version = snapshot_.load()->version + 1;
+	snapshot->all = encode(realms, std::nullopt);
 
-	realms_ = copy;
+	for(const auto& [_, realm] : realms) {
+		if(!snapshot->regions.contains(realm.region)) {
+			snapshot->regions[realm.region] = encode(realms, realm.region);
+		}
+	}
+
+	snapshot->none = encode({}, std::nullopt);
+	snapshot->realms = std::move(realms);
+	snapshot_ = std::move(snapshot);
+}
+
+EncodedRealmList RealmList::encode(const RealmMap& realms, const std::optional<Region> region) {
+	grunt::server::RealmList packet;
+	EncodedRealmList encoded;
+	auto offset = grunt::server::RealmList::ENTRIES_OFFSET;
+
+	for(const auto& [_, realm] : realms) {
+		if(region && realm.region != *region) {
+			continue;
+		}
+
+		packet.realms.emplace_back(realm, 0);
+
+		encoded.slots.emplace_back(
+			realm.id, offset + grunt::server::RealmList::characters_offset(realm)
+		);
+
+		offset += grunt::server::RealmList::entry_size(realm);
+	}
+
+	spark::io::pmr::BufferAdaptor adaptor(encoded.packet);
+	spark::io::pmr::BinaryStream stream(adaptor);
+	packet.write_to_stream(stream);
+	return encoded;
 }
 
 std::optional<Realm> RealmList::get_realm(const std::uint32_t id) const {
-	auto realms = realms_.load();
+	const auto snapshot = snapshot_.load();
 
-	if(auto it = realms->find(id); it != realms->end()) {
+	if(auto it = snapshot->realms.find(id); it != snapshot->realms.end()) {
 		return it->second;
 	} else {
 		return std::nullopt;
@@ -51,8 +97,31 @@ std::optional<Realm> RealmList::get_realm(const std::uint32_t id) const {
 }
 
 auto RealmList::realms() const -> std::shared_ptr<const RealmMap> {
-	auto realms = realms_.load();
-	return realms;
+	auto snapshot = snapshot_.load();
+	return { snapshot, &snapshot->realms };
+}
+
+/*
+ * Returns the realm list for the given region, or every realm
+ * if no region is specified
+ */
+auto RealmList::encoded(const std::optional<Region> region) const
+	-> std::shared_ptr<const EncodedRealmList> {
+	auto snapshot = snapshot_.load();
+
+	if(!region) {
+		return { snapshot, &snapshot->all };
+	}
+
+	if(auto it = snapshot->regions.find(*region); it != snapshot->regions.end()) {
+		return { snapshot, &it->second };
+	}
+
+	return { snapshot, &snapshot->none };
+}
+
+std::uint64_t RealmList::version() const {
+	return snapshot_.load()->version;
 }
 
-} // ember
\ No newline at end of file
+} // ember
@@ -15,23 +15,60 @@
 #include <optional>
 #include <span>
 #include <unordered_map>
+#include <vector>
+#include <cstddef>
 #include <cstdint>
 
 namespace ember {
 
 using RealmMap = std::unordered_map<std::uint32_t, Realm>;
 
+/*
+ * Complete realm list packet, serialised with zero character counts,
+ * along with where each realm's count needs to be patched in
+ */
+struct EncodedRealmList {
+	struct CharacterSlot {
+		std::uint32_t realm_id;
+		std::size_t offset;
+	};
+
+	std::vector<std::uint8_t> packet;
+	std::vector<CharacterSlot> slots; // ascending order of offset
+};
+
+/*
+ * Updates are rare compared to realm list requests, so each update
+ * builds an immutable snapshot containing the realms along with their
+ * pre-encoded realm list packets, one per region, which is then swapped
+ * in atomically
+ */
 class RealmList final {
-	std::atomic<std::shared_ptr<const RealmMap>> realms_;
+	using Region = dbc::Cfg_Categories::Region;
+
+	struct Snapshot {
+		RealmMap realms;
+		std::uint64_t version = 0;
+		EncodedRealmList all;
+		EncodedRealmList none;
+		std::unordered_map<Region, EncodedRealmList> regions;
+	};
+
+	std::atomic<std::shared_ptr<const Snapshot>> snapshot_;
 	mutable std::mutex lock_;
 
+	static EncodedRealmList encode(const RealmMap& realms, std::optional<Region> region);
+	void update(RealmMap realms);
+
 public:
 	explicit RealmList(std::span<const Realm> realms);
-	RealmList() : realms_(std::make_shared<RealmMap>()){}
+	RealmList();
 	void add_realm(std::span<const Realm> realms);
 	void add_realm(Realm realm);
 	std::optional<Realm> get_realm(std::uint32_t id) const;
 	std::shared_ptr<const RealmMap> realms() const;
+	std::shared_ptr<const EncodedRealmList> encoded(std::optional<Region> region) const;
+	std::uint64_t version() const;
 };
 
 } // ember
\ No newline at end of file
@@ -19,6 +19,7 @@ namespace ember {
 namespace bai = boost::asio::ip;
 
 class LoginHandlerBuilder;
+class Metrics;
 class SessionManager;
 class ThreadPool;
 
@@ -34,15 +35,16 @@ public:
 class LoginSessionBuilder final : public NetworkSessionBuilder {
 	const LoginHandlerBuilder& builder_;
 	ThreadPool& pool_;
+	Metrics& metrics_;
 
 public:
-	LoginSessionBuilder(const LoginHandlerBuilder& builder, ThreadPool& pool)
-	                    : builder_(builder), pool_(pool) { }
+	LoginSessionBuilder(const LoginHandlerBuilder& builder, ThreadPool& pool, Metrics& metrics)
+	                    : builder_(builder), pool_(pool), metrics_(metrics) { }
 
 	std::shared_ptr<LoginSession> create(SessionManager& sessions,
 	                                     tcp_socket socket,
 	                                     log::Logger* logger) const override {
-		return std::make_shared<LoginSession>(sessions, std::move(socket), logger, pool_, builder_);
+		return std::make_shared<LoginSession>(sessions, std::move(socket), logger, pool_, metrics_, builder_);
 	}
 };
 
@@ -16,6 +16,7 @@ namespace server {
 
 class LoginChallenge;
 class LoginProof;
+class PreparedRealmList;
 class RealmList;
 class ReconnectChallenge;
 class ReconnectProof;
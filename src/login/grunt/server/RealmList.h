@@ -17,6 +17,8 @@
 #include <boost/endian/conversion.hpp>
 #include <boost/container/small_vector.hpp>
 #include <gsl/gsl_util>
+#include <span>
+#include <utility>
 #include <cstdint>
 #include <cstddef>
 
@@ -81,8 +83,21 @@ public:
 		std::uint32_t characters;
 	};
 
+	// opcode, size, unknown & realm count
+	static constexpr std::size_t ENTRIES_OFFSET = 8;
+
 	RealmList() : Packet(Opcode::CMD_REALM_LIST) {}
 
+	// offset of the character count from the start of a realm's entry
+	static std::size_t characters_offset(const Realm& realm) {
+		return sizeof(realm.type) + sizeof(realm.flags) + realm.name.size() + 1
+			+ realm.address.size() + 1 + sizeof(realm.population);
+	}
+
+	static std::size_t entry_size(const Realm& realm) {
+		return characters_offset(realm) + 3; // characters, category, ID
+	}
+
 	be::little_uint32_t unknown = 0; // appears to be ignored in public clients
 	boost::container::small_vector<RealmListEntry, DEFAULT_REALMS> realms;
 	be::little_uint16_t unknown2 = 5; // appears to be ignored in public clients
@@ -141,4 +156,39 @@ public:
 	}
 };
 
+/*
+ * Writes a realm list that was serialised ahead of time, patching in
+ * the client's character counts. Write-only.
+ */
+class PreparedRealmList final : public Packet {
+	static const std::size_t DEFAULT_REALMS = 10u;
+
+	std::span<const std::uint8_t> packet_;
+
+public:
+	explicit PreparedRealmList(std::span<const std::uint8_t> packet)
+		: Packet(Opcode::CMD_REALM_LIST), packet_(packet) {}
+
+	// offset within the packet & character count, in ascending order of offset
+	boost::container::small_vector<std::pair<std::size_t, std::uint8_t>, DEFAULT_REALMS> characters;
+
+	State read_from_stream(spark::io::pmr::BinaryStream&) override {
+		BOOST_ASSERT_MSG(false, "Prepared realm lists cannot be read, use RealmList");
+		return State::DONE;
+	}
+
+	void write_to_stream(spark::io::pmr::BinaryStream& stream) const override {
+		std::size_t written = 0;
+
+		for(const auto& [offset, count] : characters) {
+			BOOST_ASSERT_MSG(offset >= written && offset < packet_.size(), "Bad character offset");
+			stream.put(packet_.data() + written, offset - written);
+			stream << count;
+			written = offset + 1;
+		}
+
+		stream.put(packet_.data() + written, packet_.size() - written);
+	}
+};
+
 } // server, grunt, ember
\ No newline at end of file
@@ -13,7 +13,7 @@
 #include "../Exceptions.h"
 #include <boost/assert.hpp>
 #include <boost/endian/arithmetic.hpp>
-#include <vector>
+#include <span>
 #include <cstdint>
 #include <cstddef>
 
@@ -27,11 +27,17 @@ class TransferData final : public Packet {
 
 public:
 	static const std::uint16_t MAX_CHUNK_SIZE = 65535;
+	static const std::size_t HEADER_LENGTH = 3;
 
 	TransferData() : Packet(Opcode::CMD_XFER_DATA) {}
 
 	be::little_uint16_t size = 0;
-	std::array<std::byte, MAX_CHUNK_SIZE> chunk;
+
+	/*
+	 * Not owned by the packet, the data must remain valid until the
+	 * packet has been written to the socket
+	 */
+	std::span<const std::byte> chunk;
 
 	State read_from_stream(spark::io::pmr::BinaryStream& stream) override {
 		BOOST_ASSERT_MSG(state_ != State::DONE, "Packet already complete - check your logic!");
@@ -47,9 +53,15 @@ public:
 	}
 
 	void write_to_stream(spark::io::pmr::BinaryStream& stream) const override {
+		write_header(stream);
+		stream.put(chunk.data(), size);
+	}
+
+	// allows the chunk to be sent without first copying it into a buffer
+	void write_header(spark::io::pmr::BinaryStream& stream) const {
+		BOOST_ASSERT_MSG(size == chunk.size(), "Chunk size mismatch - check your logic!");
 		stream << opcode;
 		stream << size;
-		stream.put(chunk.data(), size);
 	}
 };
 
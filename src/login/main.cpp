@@ -13,6 +13,7 @@
 #include "SessionBuilders.h"
 #include "LoginHandlerBuilder.h"
 #include "IntegrityData.h"
+#include "IntegritySaltPool.h"
 #include "MonitorCallbacks.h"
 #include "NetworkListener.h"
 #include "Patcher.h"
@@ -282,20 +283,28 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	LOG_INFO_SYNC(logger, "Starting thread pool with {} threads...", concurrency);
 	ThreadPool thread_pool(concurrency);
 
-	LoginHandlerBuilder builder(logger, patcher, survey, bin_data, user_dao,
+	IntegritySaltPool salt_pool(
+		bin_data, *metrics,
+		args["integrity.salt_pool_size"].as<std::size_t>(),
+		args["integrity.salt_refill_rate"].as<std::size_t>()
+	);
+
+	LoginHandlerBuilder builder(logger, patcher, survey, bin_data, salt_pool, user_dao,
 	                            acct_svc, realm_list, *metrics,
 	                            args["locale.enforce"].as<bool>(),
-	                            args["integrity.enabled"].as<bool>());
-	LoginSessionBuilder s_builder(builder, thread_pool);
+	                            args["integrity.enabled"].as<bool>(),
+	                            args["patches.pipeline_depth"].as<std::size_t>());
+	LoginSessionBuilder s_builder(builder, thread_pool, *metrics);
 
 	const auto& interface = args["network.interface"].as<std::string>();
 	const auto port = args["network.port"].as<std::uint16_t>();
 	const auto tcp_no_delay = args["network.tcp_no_delay"].as<bool>();
+	const auto acceptors = args["network.reuse_port"].as<bool>()? concurrency : 1;
 
 	LOG_INFO_SYNC(logger, "Starting network service...");
 
 	NetworkListener server(
-		service, interface, port, tcp_no_delay, s_builder, ip_ban_cache, logger, *metrics
+		service, interface, port, tcp_no_delay, acceptors, s_builder, ip_ban_cache, logger, *metrics
 	);
 
 	LOG_INFO_SYNC(logger, "Started network service on {}:{}", interface, server.port());
@@ -326,6 +335,10 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 		metrics.gauge("sessions", server.connection_count());
 	}, 5s);
 
+	poller.add_source([&thread_pool](Metrics& metrics) {
+		metrics.gauge("thread_pool_queue", thread_pool.queue_depth());
+	}, 1s);
+
 	// Misc. information
 	LOG_INFO_SYNC(logger, "Max allowed sockets: {}", util::max_sockets_desc());
 	std::string builds;
@@ -399,10 +412,13 @@ po::variables_map parse_arguments(int argc, const char* argv[]) {
 	config_opts.add_options()
 		("locale.enforce", po::value<bool>()->required())
 		("patches.bin_path", po::value<std::string>()->required())
+		("patches.pipeline_depth", po::value<std::size_t>()->default_value(4))
 		("survey.path", po::value<std::string>()->required())
 		("survey.id", po::value<std::uint32_t>()->required())
 		("integrity.enabled", po::value<bool>()->default_value(false))
 		("integrity.bin_path", po::value<std::string>()->required())
+		("integrity.salt_pool_size", po::value<std::size_t>()->default_value(64))
+		("integrity.salt_refill_rate", po::value<std::size_t>()->default_value(50))
 		("spark.address", po::value<std::string>()->required())
 		("spark.port", po::value<std::uint16_t>()->required())
 		("nsd.host", po::value<std::string>()->required())
@@ -417,6 +433,7 @@ po::variables_map parse_arguments(int argc, const char* argv[]) {
 		("network.interface", po::value<std::string>()->required())
 		("network.port", po::value<std::uint16_t>()->required())
 		("network.tcp_no_delay", po::value<bool>()->default_value(true))
+		("network.reuse_port", po::value<bool>()->default_value(false))
 		("console_log.verbosity", po::value<std::string>()->required())
 		("console_log.filter-mask", po::value<std::uint32_t>()->default_value(0))
 		("console_log.colours", po::value<bool>()->required())
@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "BundleGenerator.h"
+#include "DBCHeader.h"
+#include "TypeUtils.h"
+#include <dbcreader/BundleFormat.h>
+#include <logger/Logger.h>
+#include <shared/util/FNVHash.h>
+#include <boost/endian/conversion.hpp>
+#include <gsl/gsl_util>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember::dbc {
+
+namespace {
+
+// matches DBCMap's threshold for choosing the dense layout
+constexpr std::size_t MAX_DENSE_RATIO = 4;
+
+struct Reference {
+	std::string dbc;
+	std::string field;
+	std::size_t offset;
+	std::size_t size;
+	std::size_t count;
+};
+
+/*
+ * Locates the fields within a record that need to be rewritten or inspected
+ * when building the bundle - string references, the primary key and keys
+ * into other DBCs.
+ */
+class RecordLayout final : public types::TypeVisitor {
+	std::size_t depth_ = 0;
+
+public:
+	std::size_t size = 0;
+	std::vector<std::size_t> strings;
+	std::vector<Reference> references;
+	std::optional<std::pair<std::size_t, std::size_t>> key; // offset, size
+
+	void visit(const types::Struct* type, const types::Field* parent) override {
+		++depth_;
+		walk_dbc_fields(*this, type, parent);
+		--depth_;
+	}
+
+	void visit(const types::Enum* type) override {}
+
+	void visit(const types::Field* field, const types::Base* parent) override {
+		const auto components = extract_components(field->underlying_type);
+		const std::size_t count = components.second.value_or(1);
+		std::size_t scalar_size = 0;
+
+		if(auto it = type_size_map.find(components.first); it != type_size_map.end()) {
+			scalar_size = it->second;
+		} else {
+			const auto base = locate_type_base(static_cast<const types::Struct&>(*field->parent), components.first);
+
+			if(!base) {
+				throw std::runtime_error("Unable to locate base type");
+			}
+
+			if(base->type == types::Type::STRUCT) {
+				for(std::size_t i = 0; i < count; ++i) {
+					visit(static_cast<const types::Struct*>(base), field);
+				}
+
+				return;
+			}
+
+			scalar_size = type_size_map.at(static_cast<const types::Enum*>(base)->underlying_type);
+		}
+
+		for(std::size_t i = 0; i < count; ++i) {
+			const auto offset = size + (i * scalar_size);
+
+			if(components.first == "string_ref") {
+				strings.emplace_back(offset);
+			} else if(components.first == "string_ref_loc") {
+				for(std::size_t j = 0; j < string_ref_loc_regions.size(); ++j) {
+					strings.emplace_back(offset + (j * sizeof(std::uint32_t)));
+				}
+			}
+		}
+
+		for(const auto& k : field->keys) {
+			if(k.type == "primary" && depth_ == 1 && count == 1) {
+				key = { size, scalar_size };
+			} else if(k.type == "foreign") {
+				references.emplace_back(k.parent, field->name, size, scalar_size, count);
+			}
+		}
+
+		size += scalar_size * count;
+	}
+};
+
+struct Table {
+	std::string name;
+	RecordLayout layout;
+	std::uint32_t fields = 0;
+	std::uint32_t records = 0;
+	std::uint32_t record_size = 0;
+	std::vector<std::byte> data;
+	std::unordered_set<std::uint32_t> ids;
+	BundleIndex index_type = BundleIndex::NONE;
+	std::uint32_t index_base = 0;
+	std::vector<std::byte> index;
+};
+
+class StringPool final {
+	std::unordered_map<std::string, std::uint32_t> offsets_;
+	std::string block_ { '\0' };
+
+public:
+	std::uint32_t intern(const std::string& string) {
+		if(string.empty()) {
+			return 0;
+		}
+
+		auto [it, inserted] = offsets_.try_emplace(string, gsl::narrow<std::uint32_t>(block_.size()));
+
+		if(inserted) {
+			block_.append(string);
+			block_.push_back('\0');
+		}
+
+		return it->second;
+	}
+
+	const std::string& block() const {
+		return block_;
+	}
+};
+
+std::uint32_t read_le(const std::byte* data, std::size_t size) {
+	namespace be = boost::endian;
+	const auto ptr = reinterpret_cast<const unsigned char*>(data);
+
+	switch(size) {
+		case 1:
+			return *ptr;
+		case 2:
+			return be::endian_load<std::uint16_t, 2, be::order::little>(ptr);
+		case 4:
+			return be::endian_load<std::uint32_t, 4, be::order::little>(ptr);
+		default:
+			throw std::runtime_error("Unsupported key size, " + std::to_string(size));
+	}
+}
+
+void write_le(std::byte* data, std::uint32_t value) {
+	namespace be = boost::endian;
+	be::endian_store<std::uint32_t, 4, be::order::little>(reinterpret_cast<unsigned char*>(data), value);
+}
+
+template<typename T>
+void append(std::vector<std::byte>& buffer, const T& value) {
+	const auto bytes = reinterpret_cast<const std::byte*>(&value);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+std::vector<std::byte> read_file(const std::filesystem::path& path) {
+	std::ifstream file(path, std::ios::binary);
+
+	if(!file) {
+		throw std::runtime_error("Unable to open DBC for reading, " + path.string());
+	}
+
+	std::vector<std::byte> data(gsl::narrow<std::size_t>(std::filesystem::file_size(path)));
+	file.read(reinterpret_cast<char*>(data.data()), data.size());
+	return data;
+}
+
+std::string read_string(std::span<const std::byte> block, std::size_t offset, std::string_view dbc) {
+	const auto begin = reinterpret_cast<const char*>(block.data());
+	const auto end = begin + block.size();
+
+	if(offset >= block.size() || std::find(begin + offset, end, '\0') == end) {
+		throw std::runtime_error(std::string(dbc) + ": string reference is outside of the string block");
+	}
+
+	return begin + offset;
+}
+
+void build_index(Table& table) {
+	if(!table.layout.key) {
+		return;
+	}
+
+	const auto [key_offset, key_size] = *table.layout.key;
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> keys; // ID, record position
+
+	for(std::uint32_t i = 0; i < table.records; ++i) {
+		const auto record = table.data.data() + (std::size_t(i) * table.record_size);
+		const auto id = read_le(record + key_offset, key_size);
+
+		// the first record with a given ID wins, as with the other loaders
+		if(table.ids.emplace(id).second) {
+			keys.emplace_back(id, i);
+		}
+	}
+
+	if(keys.empty()) {
+		table.index_type = BundleIndex::SORTED;
+		return;
+	}
+
+	const auto [min, max] = std::ranges::minmax(keys, {}, &std::pair<std::uint32_t, std::uint32_t>::first);
+	const std::size_t range = std::size_t(max.first) - min.first + 1;
+
+	if(range <= keys.size() * MAX_DENSE_RATIO) {
+		table.index_type = BundleIndex::DENSE;
+		table.index_base = min.first;
+		std::vector<be::little_uint32_t> slots(range);
+
+		for(const auto& [id, position] : keys) {
+			slots[id - min.first] = position + 1;
+		}
+
+		for(const auto& slot : slots) {
+			append(table.index, slot);
+		}
+	} else {
+		table.index_type = BundleIndex::SORTED;
+		std::ranges::sort(keys);
+
+		for(const auto& [id, position] : keys) {
+			append(table.index, BundleIndexEntry { .id = id, .position = position });
+		}
+	}
+}
+
+Table load_table(const types::Struct& dbc, const std::filesystem::path& dbc_path, StringPool& strings) {
+	Table table { .name = dbc.name };
+
+	if(table.name.size() >= BUNDLE_NAME_LEN) {
+		throw std::runtime_error(dbc.name + ": name is too long to be stored in a bundle");
+	}
+
+	const auto data = read_file(dbc_path / (dbc.name + ".dbc"));
+
+	if(data.size() < sizeof(DBCHeader)) {
+		throw std::runtime_error(dbc.name + ": file is too small to hold a header");
+	}
+
+	DBCHeader header;
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	TypeMetrics metrics;
+	walk_dbc_fields(metrics, &dbc, dbc.parent);
+	validate_dbc(dbc.name, header, metrics.record_size, metrics.fields, data.size());
+	table.layout.visit(&dbc, nullptr);
+
+	if(table.layout.size != header.record_size) {
+		throw std::runtime_error(dbc.name + ": record layout does not match the record size");
+	}
+
+	table.fields = header.fields;
+	table.records = header.records;
+	table.record_size = header.record_size;
+
+	const auto records_begin = data.begin() + sizeof(DBCHeader);
+	const auto records_end = records_begin + (std::size_t(header.records) * header.record_size);
+	table.data.assign(records_begin, records_end);
+
+	// point string references into the bundle's shared string block
+	const std::span<const std::byte> block(records_end, data.end());
+
+	for(std::uint32_t i = 0; i < table.records; ++i) {
+		const auto record = table.data.data() + (std::size_t(i) * table.record_size);
+
+		for(const auto offset : table.layout.strings) {
+			const auto string = read_string(block, read_le(record + offset, sizeof(std::uint32_t)), dbc.name);
+			write_le(record + offset, strings.intern(string));
+		}
+	}
+
+	build_index(table);
+	return table;
+}
+
+// references are left as IDs but any that don't resolve are reported here, rather than at load time
+void check_references(const std::vector<Table>& tables) {
+	std::unordered_map<std::string_view, const Table*> by_name;
+
+	for(const auto& table : tables) {
+		by_name.emplace(table.name, &table);
+	}
+
+	for(const auto& table : tables) {
+		for(const auto& ref : table.layout.references) {
+			const auto it = by_name.find(ref.dbc);
+
+			if(it == by_name.end()) {
+				LOG_WARN_GLOB << table.name << "." << ref.field << " references " << ref.dbc
+				              << ", which is not in the bundle" << LOG_ASYNC;
+				continue;
+			}
+
+			std::size_t dangling = 0;
+
+			for(std::uint32_t i = 0; i < table.records; ++i) {
+				const auto record = table.data.data() + (std::size_t(i) * table.record_size);
+
+				for(std::size_t j = 0; j < ref.count; ++j) {
+					const auto id = read_le(record + ref.offset + (j * ref.size), ref.size);
+					dangling += (id && !it->second->ids.contains(id));
+				}
+			}
+
+			if(dangling) {
+				LOG_WARN_GLOB << table.name << "." << ref.field << ": " << dangling << " reference(s) to "
+				              << ref.dbc << " do not resolve" << LOG_ASYNC;
+			}
+		}
+	}
+}
+
+} // unnamed
+
+std::vector<std::byte> build_bundle(const types::Definitions& defs, const std::filesystem::path& dbc_path) {
+	LOG_INFO_GLOB << "Building DBC bundle..." << LOG_ASYNC;
+
+	StringPool strings;
+	std::vector<Table> tables;
+
+	for(const auto& def : defs) {
+		if(def->type != types::Type::STRUCT) {
+			continue;
+		}
+
+		const auto& dbc = static_cast<const types::Struct&>(*def);
+
+		if(!dbc.dbc) {
+			continue;
+		}
+
+		LOG_DEBUG_GLOB << "Adding " << dbc.name << " to bundle" << LOG_ASYNC;
+		tables.emplace_back(load_table(dbc, dbc_path, strings));
+	}
+
+	check_references(tables);
+
+	// lay out the entries, followed by each DBC's records and index, followed by the strings
+	std::vector<std::byte> body;
+	std::size_t offset = sizeof(BundleHeader) + (tables.size() * sizeof(BundleEntry));
+
+	for(const auto& table : tables) {
+		BundleEntry entry {
+			.records = table.records,
+			.fields = table.fields,
+			.record_size = table.record_size,
+			.records_offset = gsl::narrow<std::uint32_t>(offset),
+			.index_type = std::to_underlying(table.index_type),
+			.index_base = table.index_base,
+			.index_size = gsl::narrow<std::uint32_t>(table.index.size() / (table.index_type == BundleIndex::SORTED?
+			                                         sizeof(BundleIndexEntry) : sizeof(be::little_uint32_t))),
+			.index_offset = gsl::narrow<std::uint32_t>(offset + table.data.size())
+		};
+
+		std::ranges::copy(table.name, entry.name);
+		append(body, entry);
+		offset += table.data.size() + table.index.size();
+	}
+
+	for(const auto& table : tables) {
+		body.insert(body.end(), table.data.begin(), table.data.end());
+		body.insert(body.end(), table.index.begin(), table.index.end());
+	}
+
+	const auto string_block_offset = sizeof(BundleHeader) + body.size();
+	const auto block = std::as_bytes(std::span(strings.block()));
+	body.insert(body.end(), block.begin(), block.end());
+
+	if(sizeof(BundleHeader) + body.size() > std::numeric_limits<std::uint32_t>::max()) {
+		throw std::runtime_error("Bundle is too large");
+	}
+
+	FNVHash hasher;
+	hasher.update(body.begin(), body.end());
+
+	const BundleHeader header {
+		.magic = BUNDLE_MAGIC,
+		.version = BUNDLE_VERSION,
+		.checksum = hasher.hash(),
+		.size = gsl::narrow<std::uint32_t>(sizeof(BundleHeader) + body.size()),
+		.dbcs = gsl::narrow<std::uint32_t>(tables.size()),
+		.string_block_offset = gsl::narrow<std::uint32_t>(string_block_offset),
+		.string_block_len = gsl::narrow<std::uint32_t>(strings.block().size())
+	};
+
+	std::vector<std::byte> bundle;
+	bundle.reserve(header.size);
+	append(bundle, header);
+	bundle.insert(bundle.end(), body.begin(), body.end());
+
+	LOG_INFO_GLOB << "Bundled " << tables.size() << " DBCs (" << header.size << " bytes, "
+	              << strings.block().size() << " bytes of strings)" << LOG_ASYNC;
+
+	return bundle;
+}
+
+void generate_bundle(const types::Definitions& defs, const std::string& dbc_path, const std::string& out_path) {
+	const auto bundle = build_bundle(defs, dbc_path);
+	std::filesystem::path path(out_path);
+
+	if(!std::filesystem::exists(path)) {
+		if(!std::filesystem::create_directory(path)) {
+			throw std::runtime_error(out_path + " does not exist and could not be created");
+		}
+	}
+
+	path /= "dbc.bundle";
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+	if(!file) {
+		throw std::runtime_error("Unable to open " + path.string() + " for writing");
+	}
+
+	file.write(reinterpret_cast<const char*>(bundle.data()), bundle.size());
+
+	if(!file) {
+		throw std::runtime_error("Unable to write " + path.string());
+	}
+
+	LOG_INFO_GLOB << "Wrote " << path.string() << LOG_ASYNC;
+}
+
+} // dbc, ember
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "Types.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace ember::dbc {
+
+// builds a bundle from the DBC files in dbc_path, returning the complete file
+std::vector<std::byte> build_bundle(const types::Definitions& defs, const std::filesystem::path& dbc_path);
+
+void generate_bundle(const types::Definitions& defs, const std::string& dbc_path, const std::string& out_path);
+
+} // dbc, ember
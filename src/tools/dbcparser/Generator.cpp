@@ -65,6 +65,18 @@ std::optional<std::string> locate_type(const types::Struct& base, const std::str
 	MUST_TAIL return locate_type(static_cast<types::Struct&>(*base.parent), type_name);
 }
 
+const types::Field* find_primary_key(const types::Struct& dbc) {
+	for(const auto& f : dbc.fields) {
+		for(const auto& k : f.keys) {
+			if(k.type == "primary") {
+				return &f;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
 std::string parent_alias(const types::Definitions& defs, const std::string& parent) {
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
 
@@ -119,9 +131,9 @@ std::stringstream read_template(const std::string& path, const std::string& file
 void generate_linker(const types::Definitions& defs, const std::string& output, const std::string& path) {
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
 
-	std::regex pattern(R"(([^]+)<%TEMPLATE_LINKING_FUNCTIONS%>([^]+)<%TEMPLATE_LINKING_FUNCTION_CALLS%>([^]+))");
+	std::regex pattern(R"(([^]+)<%TEMPLATE_LINKING_FUNCTIONS%>([^]+)<%TEMPLATE_LINKING_FUNCTION_TABLE%>([^]+))");
 	std::stringstream buffer(read_template(path, "Linker.cpp_"));
-	std::stringstream functions, calls;
+	std::stringstream functions, table;
 
 	for(const auto& def : defs) {
 		if(def->type != types::Type::STRUCT) {
@@ -136,13 +148,13 @@ void generate_linker(const types::Definitions& defs, const std::string& output,
 		}
 
 		std::string store_name = def->alias.empty()? pascal_to_underscore(dbc->name) : dbc->alias;
-		std::stringstream call, func;
+		std::stringstream entry, func;
 		bool write_func = false;
 		bool double_spaced = false;
 		bool first_field = true;
 		bool pack_loop_format = true;
 
-		call << "\t" << "detail::link_" << store_name << "(storage);" << '\n';
+		entry << "\t" << "{ \"" << dbc->name << "\", link_" << store_name << " }," << '\n';
 		
 		func << "void link_" << store_name << "(Storage& storage) {" << '\n';
 		func << "\t" << "for(auto& [k, i] : storage." << store_name << ") {" << '\n';
@@ -204,12 +216,12 @@ void generate_linker(const types::Definitions& defs, const std::string& output,
 		func << "}" << '\n' << '\n';
 
 		if(write_func) {
-			calls << call.str();
+			table << entry.str();
 			functions << func.str();
 		}
 	}
 
-	std::string replace_pattern("$1" + functions.str() + "$2" + calls.str() + "$3");
+	std::string replace_pattern("$1" + functions.str() + "$2" + table.str() + "$3");
 	std::string out = std::regex_replace(buffer.str(), pattern, replace_pattern);
 	save_output(output, "Linker.cpp", out);
 }
@@ -218,9 +230,9 @@ void generate_disk_loader(const types::Definitions& defs, const std::string& out
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
 	LOG_INFO_GLOB << "Generating disk loader..." << LOG_ASYNC;
 
-	std::regex pattern(R"(([^]+)<%TEMPLATE_DISK_LOAD_FUNCTIONS%>([^]+)<%TEMPLATE_DISK_LOAD_MAP_INSERTION%>([^]+)<%TEMPLATE_DISK_LOAD_FUNCTION_CALLS%>([^]+))");
+	std::regex pattern(R"(([^]+)<%TEMPLATE_DISK_LOAD_FUNCTIONS%>([^]+)<%TEMPLATE_DISK_LOAD_NAMES%>([^]+)<%TEMPLATE_DISK_LOAD_MAP_INSERTION%>([^]+))");
 	std::stringstream buffer(read_template(path, "DiskLoader.cpp_"));
-	std::stringstream functions, insertions, calls;
+	std::stringstream functions, insertions, names;
 
 	for(const auto& def : defs) {
 		if(def->type != types::Type::STRUCT) {
@@ -242,8 +254,7 @@ void generate_disk_loader(const types::Definitions& defs, const std::string& out
 
 		insertions << "\t" << "dbc_map.emplace(\"" << dbc.name << "\", " << "detail::load_" << store_name << ");" << '\n';
 
-		calls << "\t" << "log_cb_(\"Loading " << dbc.name << " DBC data...\");" << '\n';
-		calls << "\t" << "detail::load_" << store_name << "(storage, dir_path_);" << '\n';
+		names << "\t" << "\"" << dbc.name << "\"," << '\n';
 
 		functions << "void load_" << store_name << "(Storage& storage, const std::string& dir_path) {"
 			<< '\n';
@@ -257,6 +268,24 @@ void generate_disk_loader(const types::Definitions& defs, const std::string& out
 		functions << "\tvalidate_dbc(\"" << dbc.name << "\", dbc.header, " << metrics.record_size
 		          << ", " << metrics.fields << ", region.get_size()" << ");" << '\n' << '\n';
 							
+		/*
+		 * DBCs without a primary key are keyed by record index and can always
+		 * use the dense layout. Otherwise, the layout depends on how compact
+		 * the IDs turn out to be, so the range is found before loading
+		 */
+		const auto key = find_primary_key(dbc);
+
+		if(!key) {
+			functions << "\t" << "storage." << store_name << ".reserve(0, dbc.header->records - 1, "
+			          << "dbc.header->records);" << '\n' << '\n';
+		} else {
+			functions << "\t" << "const auto [first_id, last_id] = id_range(dbc, [](const auto& record) {"
+			          << '\n' << "\t\t" << "return record." << key->name << ";" << '\n' << "\t" << "});"
+			          << '\n' << '\n';
+			functions << "\t" << "storage." << store_name
+			          << ".reserve(first_id, last_id, dbc.header->records);" << '\n' << '\n';
+		}
+
 		functions << "\t" << "for(std::size_t i = 0; i < dbc.header->records; ++i) {" << '\n';
 		functions << "\t\t" << dbc.name << " entry{};" << '\n';
 		
@@ -403,7 +432,7 @@ void generate_disk_loader(const types::Definitions& defs, const std::string& out
 		functions << "}" << '\n' << '\n';
 	}
 
-	std::string replace_pattern("$1" + functions.str() + "$2" + insertions.str() + "$3" + calls.str() + "$4");
+	std::string replace_pattern("$1" + functions.str() + "$2" + names.str() + "$3" + insertions.str() + "$4");
 	std::string out = std::regex_replace(buffer.str(), pattern, replace_pattern);
 	save_output(output, "DiskLoader.cpp", out);
 }
@@ -645,6 +674,117 @@ void generate_storage(const types::Definitions& defs, const std::string& output,
 	save_output(output, "Storage.h", out);
 }
 
+void generate_mapped_storage(const types::Definitions& defs, const std::string& output, const std::string& path) {
+	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
+	std::regex pattern(R"(([^]+)<%TEMPLATE_DBC_VIEWS%>)");
+
+	std::stringstream buffer(read_template(path, "MappedStorage.h_"));
+	std::stringstream declarations;
+
+	for(const auto& def : defs) {
+		if(def->type != types::Type::STRUCT) {
+			continue;
+		}
+
+		const auto dbc = static_cast<types::Struct*>(def.get());
+
+		if(!dbc->dbc) {
+			continue;
+		}
+
+		std::string store_name = dbc->alias.empty()? pascal_to_underscore(dbc->name) : dbc->alias;
+		declarations << "\tDBCView<disk::" << dbc->name << "> " << store_name << ";\n";
+	}
+
+	std::string replace_pattern("$1" + declarations.str() + "$2");
+	std::string out = std::regex_replace(buffer.str(), pattern, replace_pattern);
+	save_output(output, "MappedStorage.h", out);
+}
+
+void generate_mapped_loader(const types::Definitions& defs, const std::string& output, const std::string& path) {
+	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
+	LOG_INFO_GLOB << "Generating mapped loader..." << LOG_ASYNC;
+
+	std::regex pattern(R"(([^]+)<%TEMPLATE_MAPPED_LOAD_FUNCTIONS%>([^]+)<%TEMPLATE_MAPPED_LOAD_NAMES%>([^]+)<%TEMPLATE_MAPPED_LOAD_MAP_INSERTION%>([^]+))");
+	std::stringstream buffer(read_template(path, "MappedLoader.cpp_"));
+	std::stringstream functions, insertions, names;
+
+	for(const auto& def : defs) {
+		if(def->type != types::Type::STRUCT) {
+			continue;
+		}
+
+		const auto& dbc = static_cast<types::Struct&>(*def);
+
+		if(!dbc.dbc) {
+			continue;
+		}
+
+		TypeMetrics metrics;
+		walk_dbc_fields(metrics, &dbc, dbc.parent);
+
+		std::string store_name = dbc.alias.empty()? pascal_to_underscore(dbc.name) : dbc.alias;
+
+		insertions << "\t" << "dbc_map.emplace(\"" << dbc.name << "\", " << "detail::map_" << store_name << ");" << '\n';
+		names << "\t" << "\"" << dbc.name << "\"," << '\n';
+
+		functions << "void map_" << store_name << "(MappedStorage& storage, const std::string& dir_path) {" << '\n';
+		functions << "\t" << "storage." << store_name << " = DBCView<disk::" << dbc.name << ">::open(dir_path + \""
+		          << dbc.name << ".dbc\", \"" << dbc.name << "\", " << metrics.fields;
+
+		if(const auto key = find_primary_key(dbc)) {
+			functions << ", [](const auto& record) {" << '\n';
+			functions << "\t\t" << "return record." << key->name << ";" << '\n';
+			functions << "\t" << "});" << '\n';
+		} else {
+			functions << ");" << '\n';
+		}
+
+		functions << "}" << '\n' << '\n';
+	}
+
+	std::string replace_pattern("$1" + functions.str() + "$2" + names.str() + "$3" + insertions.str() + "$4");
+	std::string out = std::regex_replace(buffer.str(), pattern, replace_pattern);
+	save_output(output, "MappedLoader.cpp", out);
+}
+
+void generate_bundle_loader(const types::Definitions& defs, const std::string& output, const std::string& path) {
+	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
+	LOG_INFO_GLOB << "Generating bundle loader..." << LOG_ASYNC;
+
+	std::regex pattern(R"(([^]+)<%TEMPLATE_BUNDLE_LOAD_FUNCTIONS%>([^]+)<%TEMPLATE_BUNDLE_LOAD_MAP_INSERTION%>([^]+))");
+	std::stringstream buffer(read_template(path, "BundleLoader.cpp_"));
+	std::stringstream functions, insertions;
+
+	for(const auto& def : defs) {
+		if(def->type != types::Type::STRUCT) {
+			continue;
+		}
+
+		const auto& dbc = static_cast<types::Struct&>(*def);
+
+		if(!dbc.dbc) {
+			continue;
+		}
+
+		TypeMetrics metrics;
+		walk_dbc_fields(metrics, &dbc, dbc.parent);
+
+		std::string store_name = dbc.alias.empty()? pascal_to_underscore(dbc.name) : dbc.alias;
+
+		insertions << "\t" << "dbc_map.emplace(\"" << dbc.name << "\", " << "detail::bundle_" << store_name << ");" << '\n';
+
+		functions << "void bundle_" << store_name << "(MappedStorage& storage, const Bundle& bundle) {" << '\n';
+		functions << "\t" << "storage." << store_name << " = DBCView<disk::" << dbc.name << ">::open(bundle, \""
+		          << dbc.name << "\", " << metrics.fields << ");" << '\n';
+		functions << "}" << '\n' << '\n';
+	}
+
+	std::string replace_pattern("$1" + functions.str() + "$2" + insertions.str() + "$3");
+	std::string out = std::regex_replace(buffer.str(), pattern, replace_pattern);
+	save_output(output, "BundleLoader.cpp", out);
+}
+
 void generate_common(const types::Definitions& defs, const std::string& output,
                      const std::string& template_path) {
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
@@ -661,4 +801,12 @@ void generate_disk_source(const types::Definitions& defs, const std::string& out
 	generate_disk_loader(defs, output, template_path);
 }
 
+void generate_mapped_source(const types::Definitions& defs, const std::string& output,
+                            const std::string& template_path) {
+	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
+	generate_mapped_storage(defs, output, template_path);
+	generate_mapped_loader(defs, output, template_path);
+	generate_bundle_loader(defs, output, template_path);
+}
+
 } // dbc, ember
\ No newline at end of file
@@ -16,5 +16,6 @@ namespace ember::dbc {
 
 void generate_common(const types::Definitions& defs, const std::string& output, const std::string& template_path);
 void generate_disk_source(const types::Definitions& defs, const std::string& output, const std::string& template_path);
+void generate_mapped_source(const types::Definitions& defs, const std::string& output, const std::string& template_path);
 
 } // dbc, ember
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include "Parser.h"
 #include "Generator.h"
+#include "BundleGenerator.h"
 #include "DBCGenerator.h"
 #include "SQLDDLGenerator.h"
 #include "SQLDMLGenerator.h"
@@ -82,7 +83,7 @@ void handle_options(const po::variables_map& args, const edbc::types::Definition
 	// if we're doing code generation for a DBC that references other DBCs, we
 	// need to make sure that those references are also valid, otherwise we
 	// might generate code that doesn't compile
-	if(args["disk"].as<bool>()) {
+	if(args["disk"].as<bool>() || args["mapped"].as<bool>() || args.count("bundle")) {
 		val_opts = static_cast<edbc::Validator::Options>(val_opts & ~edbc::Validator::VAL_SKIP_FOREIGN_KEYS);
 	}
 
@@ -108,11 +109,22 @@ void handle_options(const po::variables_map& args, const edbc::types::Definition
 		}
 	}
 
-	if(args["disk"].as<bool>()) {
+	if(args["disk"].as<bool>() || args["mapped"].as<bool>()) {
 		edbc::generate_common(defs, out, args["templates"].as<std::string>());
+	}
+
+	if(args["disk"].as<bool>()) {
 		edbc::generate_disk_source(defs, out, args["templates"].as<std::string>());
 	}
 
+	if(args["mapped"].as<bool>()) {
+		edbc::generate_mapped_source(defs, out, args["templates"].as<std::string>());
+	}
+
+	if(args.count("bundle")) {
+		edbc::generate_bundle(defs, args["bundle"].as<std::string>(), out);
+	}
+
 	if(args["sql-schema"].as<bool>()) {
 		edbc::generate_sql_ddl(defs, out);
 	}
@@ -218,6 +230,10 @@ po::variables_map parse_arguments(int argc, const char* argv[]) {
 			"File logging verbosity")
 		("disk", po::bool_switch(),
 			"Generate files required for loading DBC data from disk")
+		("mapped", po::bool_switch(),
+			"Generate files required for using DBC data directly from memory-mapped files")
+		("bundle", po::value<std::string>(),
+			"Build a DBC bundle from the DBC files in the given directory")
 		("print-dbcs", po::bool_switch(),
 			"Print out a summary of the DBC definitions in a table")
 		("print-fields", po::bool_switch(),
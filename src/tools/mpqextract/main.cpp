@@ -7,65 +7,159 @@
  */
 
 #include <mpq/MPQ.h>
-#include <mpq/FileSink.h>
-#include <mpq/BufferedFileSink.h>
+#include <shared/threading/ThreadPool.h>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include <regex>
+#include <string>
+#include <vector>
 #include <cstdlib>
 
-using namespace ember;
+namespace po = boost::program_options;
 
-int main(int argc, char** argv) try {
-	if(argc < 2) {
-		std::cout << "Usage: mpqextract <input.mpq> [ecma regex]\n"
-			<< "Only files matching the optional regex will be extracted\n\n"
-			<< R"a(Example: mpqextract.exe test.mpq "([a-zA-Z0-9\s_\\.\-\(\):])+(.jpg|.gif)")a";
+namespace ember {
 
-		return EXIT_FAILURE;
+void launch(const po::variables_map& args);
+po::variables_map parse_arguments(int argc, const char* argv[]);
+
+} // ember
+
+int main(int argc, const char* argv[]) try {
+	using namespace ember;
+	const po::variables_map args = parse_arguments(argc, argv);
+	launch(args);
+	return EXIT_SUCCESS;
+} catch(const std::exception& e) {
+	std::cerr << e.what();
+	return EXIT_FAILURE;
+}
+
+namespace ember {
+
+void write_file(const std::filesystem::path& path, std::span<const std::byte> data) {
+	if(path.has_parent_path()) {
+		std::filesystem::create_directories(path.parent_path());
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::out | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(data.data()), data.size_bytes());
+
+	if(!file) {
+		throw mpq::exception("extraction: file writing failed");
 	}
+}
 
-	std::filesystem::path path(argv[1]);
+void launch(const po::variables_map& args) {
+	const std::filesystem::path path(args.at("input").as<std::string>());
 	mpq::LocateResult result = mpq::locate_archive(path);
 
 	if(!result) {
-		std::cerr << "Not found, error " << result.error();
-		return EXIT_FAILURE;
+		throw std::runtime_error(std::format("Not found, error {}", result.error().value()));
 	}
 
-	std::unique_ptr<mpq::Archive> archive = mpq::open_archive(path, *result);
+	std::unique_ptr<mpq::MemoryArchive> archive = mpq::open_archive(path, *result);
 
 	if(!archive) {
-		std::cerr << "No archive";
-		return EXIT_FAILURE;
+		throw std::runtime_error("No archive");
 	}
 
-	const std::string pattern = argc >= 3? argv[2] : "";
+	const auto pattern = args.count("regex")? args.at("regex").as<std::string>() : "";
 	const std::regex regex(pattern, std::regex::ECMAScript);
+	std::vector<std::string> matches, files;
 
-	for(auto& f : archive->files()) try {
-		if(!pattern.empty()) {
-			if(!std::regex_match(f, regex)) {
-				continue;
-			}
+	for(auto& f : archive->files()) {
+		if(pattern.empty() || std::regex_match(f, regex)) {
+			matches.emplace_back(f);
 		}
-		
-		auto index = archive->file_lookup(f, 0);
+	}
 
-		if(index == mpq::npos) {
-			continue;
-		}
+	const auto indices = archive->lookup_many(matches);
 
-		const auto& entry = archive->file_entry(index);
-		mpq::BufferedFileSink sink(f, entry.uncompressed_size);
-		archive->extract_file(f, sink);
-		sink.flush();
-	} catch(mpq::exception& e) {
-		std::cerr << std::format("{} ({})\n", e.what(), f);
+	for(std::size_t i = 0; i < matches.size(); ++i) {
+		if(indices[i] != mpq::npos) {
+			files.emplace_back(std::move(matches[i]));
+		}
 	}
 
+	const auto jobs = std::max(args.at("jobs").as<unsigned int>(), 1u);
+	const auto benchmark = args.at("benchmark").as<bool>();
+
+	// the calling thread also takes part in extraction
+	ThreadPool pool(jobs - 1);
+	std::atomic_size_t extracted = 0, bytes = 0;
+	std::mutex lock;
+
+	auto handler = [&](const std::string& file, mpq::MemoryArchive::ExtractResult result) {
+		try {
+			if(!result) {
+				throw result.error();
+			}
+
+			if(!benchmark) {
+				write_file(file, *result);
+			}
+
+			++extracted;
+			bytes += result->size_bytes();
+		} catch(const mpq::exception& e) {
+			std::lock_guard guard(lock);
+			std::cerr << std::format("{} ({})\n", e.what(), file);
+		}
+	};
+
+	const auto start = std::chrono::steady_clock::now();
+	archive->extract_files(files, pool, handler);
+
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+	const auto megabytes = bytes / (1024.0 * 1024.0);
+
+	std::cout << std::format("Extracted {} of {} files ({:.2f} MB) in {:.3f}s using {} job(s), {:.2f} MB/s\n",
+	                         extracted.load(), files.size(), megabytes, elapsed.count(), jobs,
+	                         elapsed.count()? megabytes / elapsed.count() : 0.0);
+
 	std::cout << "Zug zug, work complete!";
-	return EXIT_SUCCESS;
-} catch(std::exception& e) {
-	std::cerr << e.what();
-	return EXIT_FAILURE;
-}
\ No newline at end of file
+}
+
+po::variables_map parse_arguments(int argc, const char* argv[]) {
+	po::options_description opt("Options");
+
+	opt.add_options()
+		("help,h", "Displays a list of available options")
+		("input,i", po::value<std::string>()->required(),
+			"Path to the MPQ archive")
+		("regex,r", po::value<std::string>(),
+			"Only files matching this ECMAScript regex will be extracted")
+		("jobs,j", po::value<unsigned int>()->default_value(1),
+			"Number of threads to use for extraction")
+		("benchmark,b", po::bool_switch(),
+			"Extract to memory only, without writing any files, and report throughput");
+
+	po::positional_options_description pos;
+	pos.add("input", 1);
+	pos.add("regex", 1);
+
+	po::variables_map options;
+	po::store(po::command_line_parser(argc, argv).positional(pos).options(opt)
+	          .style(po::command_line_style::default_style & ~po::command_line_style::allow_guessing)
+	          .run(), options);
+
+	if(options.count("help") || argc <= 1) {
+		std::cout << "Usage: mpqextract <input.mpq> [ecma regex] [options]\n\n"
+			<< R"a(Example: mpqextract test.mpq "([a-zA-Z0-9\s_\\.\-\(\):])+(.jpg|.gif)" --jobs 8)a"
+			<< "\n\n" << opt;
+		std::exit(EXIT_SUCCESS);
+	}
+
+	po::notify(options);
+
+	return options;
+}
+
+} // ember
@@ -9,6 +9,7 @@
 #include "ConsoleSink.h"
 #include <protocol/Opcodes.h>
 #include <shared/util/FormatPacket.h>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -63,6 +64,24 @@ void ConsoleSink::handle(const fblog::Message& message) {
 		std::istringstream ss(message.time()->c_str());
 		ss >> std::get_time(&time, time_fmt_);
 		std::cout << std::put_time(&time, "%a, %B %d, %Y @ %H:%M:%S UTC\n");
+	} else if(message.timestamp()) {
+		const std::chrono::sys_time<std::chrono::nanoseconds> tp {
+			std::chrono::nanoseconds(message.timestamp())
+		};
+
+		const auto seconds = std::chrono::floor<std::chrono::seconds>(tp);
+		const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tp - seconds);
+		const auto tt = std::chrono::system_clock::to_time_t(seconds);
+		std::tm time;
+
+#if _MSC_VER && !__INTEL_COMPILER
+		gmtime_s(&time, &tt);
+#else
+		gmtime_r(&tt, &time);
+#endif
+
+		std::cout << std::put_time(&time, "%a, %B %d, %Y @ %H:%M:%S.")
+		          << std::setw(3) << std::setfill('0') << ms.count() << " UTC\n";
 	} else {
 		std::cout << "<missing time>\n";
 	}
@@ -80,6 +99,10 @@ void ConsoleSink::handle(const fblog::Message& message) {
 	std::cout << "\n</message>\n" << std::endl; // explicit flush to avoid stalls for ongoing streams
 }
 
+void ConsoleSink::handle_dropped(const std::uint32_t count) {
+	std::cout << "<dropped " << count << " packet(s)>\n" << std::endl;
+}
+
 void ConsoleSink::print_opcode(const fblog::Message& message) const {
 	protocol::ClientOpcode c_op;
 	protocol::ServerOpcode s_op;
@@ -20,6 +20,7 @@ class ConsoleSink final : public Sink {
 public:
 	void handle(const fblog::Header& header) override;
 	void handle(const fblog::Message& message) override;
+	void handle_dropped(std::uint32_t count) override;
 };
 
 } // ember
\ No newline at end of file
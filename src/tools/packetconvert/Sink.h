@@ -9,6 +9,7 @@
 #pragma once
 
 #include "PacketLog_generated.h"
+#include <cstdint>
 
 namespace ember {
 
@@ -16,6 +17,7 @@ class Sink {
 public:
 	virtual void handle(const fblog::Header& header) = 0;
 	virtual void handle(const fblog::Message& message) = 0;
+	virtual void handle_dropped(std::uint32_t count) = 0;
 
 	virtual ~Sink() = default;
 };
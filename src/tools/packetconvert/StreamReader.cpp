@@ -10,6 +10,7 @@
 #include <boost/endian/conversion.hpp>
 #include <boost/container/small_vector.hpp>
 #include <thread>
+#include <cstring>
 
 namespace ember {
 
@@ -135,6 +136,63 @@ void StreamReader::handle_message(std::span<const std::uint8_t> buff) {
 	}
 }
 
+/*
+ * Blocks are written by the gateway's asynchronous capture mode and hold
+ * a batch of raw packets rather than flatbuffers, so each packet is
+ * converted into a message for the benefit of the sinks
+ */
+void StreamReader::handle_block(std::span<const std::uint8_t> buff) {
+	auto read = [&](auto& value) {
+		if(buff.size() < sizeof(value)) {
+			throw std::runtime_error("Truncated packet capture block");
+		}
+
+		std::memcpy(&value, buff.data(), sizeof(value));
+		boost::endian::little_to_native_inplace(value);
+		buff = buff.subspan(sizeof(value));
+	};
+
+	std::uint32_t dropped = 0;
+	read(dropped);
+
+	while(!buff.empty()) {
+		std::uint64_t timestamp = 0;
+		std::uint8_t direction = 0;
+		std::uint32_t length = 0;
+
+		read(timestamp);
+		read(direction);
+		read(length);
+
+		if(buff.size() < length) {
+			throw std::runtime_error("Truncated packet capture block");
+		}
+
+		flatbuffers::FlatBufferBuilder fbb;
+		const auto payload = fbb.CreateVector(buff.data(), length);
+
+		fblog::MessageBuilder mb(fbb);
+		mb.add_timestamp(timestamp);
+		mb.add_direction(static_cast<fblog::Direction>(direction));
+		mb.add_payload(payload);
+		fbb.Finish(mb.Finish());
+
+		const auto message = flatbuffers::GetRoot<fblog::Message>(fbb.GetBufferPointer());
+
+		for(auto& sink : sinks_) {
+			sink->handle(*message);
+		}
+
+		buff = buff.subspan(length);
+	}
+
+	if(dropped) {
+		for(auto& sink : sinks_) {
+			sink->handle_dropped(dropped);
+		}
+	}
+}
+
 void StreamReader::handle_buffer(const fblog::Type type, std::span<const std::uint8_t> buff) {
 	switch(type) {
 		case fblog::Type::HEADER:
@@ -143,6 +201,9 @@ void StreamReader::handle_buffer(const fblog::Type type, std::span<const std::ui
 		case fblog::Type::MESSAGE:
 			handle_message(buff);
 			break;
+		case fblog::Type::BLOCK:
+			handle_block(buff);
+			break;
 		default:
 			throw std::runtime_error("Unknown message type");
 	}
@@ -37,6 +37,7 @@ class StreamReader final {
 	void handle_buffer(const fblog::Type type, std::span<const std::uint8_t> buff);
 	void handle_message(std::span<const std::uint8_t> buff);
 	void handle_header(std::span<const std::uint8_t> buff);
+	void handle_block(std::span<const std::uint8_t> buff);
 	bool try_read(std::ifstream& file, std::span<std::uint8_t> buffer);
 	template<typename T> std::optional<T> try_read(std::ifstream& file);
 
@@ -53,7 +53,7 @@ void launch(const po::variables_map& args) {
 	auto skip = stream? args.at("skip").as<bool>() : false;
 	const auto size = std::filesystem::file_size(filename);
 
-	StreamReader reader(file, stream, size, skip, interval);
+	StreamReader reader(file, size, stream, skip, interval);
 	const auto& opts = args.at("output").as<std::vector<OutputOption>>();
 	std::vector<std::reference_wrapper<const OutputOption>> sorted(opts.begin(), opts.end());
 
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Benchmark.h"
+#include "Spark_generated.h"
+#include <spark/v2/Connection.h>
+#include <spark/v2/MessageHeader.h>
+#include <spark/v2/Utility.h>
+#include <logger/Logger.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <iostream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+namespace ba = boost::asio;
+
+namespace ember {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+spark::v2::Message make_message(const std::string& payload) {
+	spark::core::HelloT hello {
+		.description = payload
+	};
+
+	spark::v2::Message msg;
+	spark::v2::finish(hello, msg);
+	spark::v2::write_header(msg);
+	return msg;
+}
+
+} // unnamed
+
+/*
+ * Measures the raw Connection layer over loopback, without any of the
+ * channel/handler machinery on top. The first phase fires a burst of
+ * messages in one direction to measure throughput, the second bounces a
+ * single message back and forth to measure round-trip latency.
+ */
+void run_benchmark(log::Logger& logger, const BenchmarkOptions& options) {
+	ba::io_context ctx;
+	ba::ip::tcp::acceptor acceptor(ctx, { ba::ip::address_v4::loopback(), 0 });
+	ba::ip::tcp::socket client_socket(ctx);
+	client_socket.connect(acceptor.local_endpoint());
+	auto server_socket = acceptor.accept();
+
+	spark::v2::Connection client(std::move(client_socket), logger, {});
+	spark::v2::Connection server(std::move(server_socket), logger, {});
+
+	const std::string payload(options.payload_size, 'x');
+	std::size_t received = 0;
+	std::size_t received_bytes = 0;
+	std::size_t round_trips = 0;
+	Clock::time_point start, burst_end, ping_start;
+
+	server.start([&](std::span<const std::uint8_t> msg) {
+		if(received < options.messages) {
+			received_bytes += msg.size();
+
+			if(++received == options.messages) {
+				burst_end = Clock::now();
+				ping_start = Clock::now();
+				client.send(make_message(payload));
+			}
+		} else {
+			server.send(make_message(payload)); // echo
+		}
+	});
+
+	client.start([&](std::span<const std::uint8_t>) {
+		if(++round_trips < options.round_trips) {
+			client.send(make_message(payload));
+		} else {
+			ctx.stop();
+		}
+	});
+
+	std::vector<spark::v2::Message> burst;
+	burst.reserve(options.messages);
+
+	for(std::size_t i = 0; i < options.messages; ++i) {
+		burst.emplace_back(make_message(payload));
+	}
+
+	start = Clock::now();
+
+	for(auto& msg : burst) {
+		client.send(std::move(msg));
+	}
+
+	ctx.run();
+
+	const auto ping_end = Clock::now();
+	const auto burst_secs = std::chrono::duration<double>(burst_end - start).count();
+	const auto rtt_us = std::chrono::duration<double, std::micro>(ping_end - ping_start).count()
+		/ options.round_trips;
+
+	std::cout << "Messages: " << options.messages << " x " << options.payload_size << "b payload\n"
+	          << "Throughput: " << (options.messages / burst_secs) << " msg/s, "
+	          << (received_bytes / burst_secs / (1024 * 1024)) << " MB/s\n"
+	          << "Round trip (" << options.round_trips << "): " << rtt_us << "us average\n";
+
+	client.close();
+	server.close();
+}
+
+} // ember
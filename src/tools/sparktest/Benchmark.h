@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <logger/LoggerFwd.h>
+#include <cstddef>
+
+namespace ember {
+
+struct BenchmarkOptions {
+	std::size_t messages;
+	std::size_t payload_size;
+	std::size_t round_trips;
+};
+
+void run_benchmark(log::Logger& logger, const BenchmarkOptions& options);
+
+} // ember
@@ -8,22 +8,44 @@
 
 #include "HelloService.h"
 #include "HelloClient.h"
+#include "Benchmark.h"
 #include <logger/Logger.h>
 #include <logger/ConsoleSink.h>
 #include <logger/FileSink.h>
 #include <spark/v2/Server.h>
 #include <boost/asio/io_context.hpp>
+#include <algorithm>
+#include <iostream>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <cstdlib>
 
 using namespace ember;
 
-void init_logger(log::Logger* logger);
+void init_logger(log::Logger* logger, std::string_view verbosity);
+
+/*
+ * Usage: sparktest [bench [messages] [payload size] [round trips]]
+ */
+int main(int argc, char** argv) {
+	const bool bench = argc >= 2 && std::string_view(argv[1]) == "bench";
 
-int main() {
 	auto logger = std::make_unique<log::Logger>();
-	init_logger(logger.get());
+	init_logger(logger.get(), bench? "warning" : "trace");
 	log::global_logger(logger.get());
 
+	if(bench) {
+		const BenchmarkOptions options {
+			.messages = argc >= 3? std::stoull(argv[2]) : 100'000,
+			.payload_size = argc >= 4? std::stoull(argv[3]) : 64,
+			.round_trips = argc >= 5? std::max(std::stoull(argv[4]), 1ull) : 10'000
+		};
+
+		run_benchmark(*logger, options);
+		return EXIT_SUCCESS;
+	}
+
 	boost::asio::io_context ctx;
 	spark::v2::Server spark(ctx, "test_server", "0.0.0.0", 8000, logger.get());
 	spark::v2::Server spark_cli(ctx, "test_client", "0.0.0.0", 8001, logger.get());
@@ -34,9 +56,8 @@ int main() {
 	ctx.run();
 }
 
-void init_logger(log::Logger* logger) {
-	const auto& con_verbosity = log::severity_string("trace");
-	const auto& file_verbosity = log::severity_string("trace");
+void init_logger(log::Logger* logger, std::string_view verbosity) {
+	const auto& con_verbosity = log::severity_string(verbosity);
 
 	auto consink = std::make_unique<log::ConsoleSink>(con_verbosity, log::Filter(0));
 	consink->colourise(true);
@@ -9,6 +9,7 @@
 #include "Launch.h"
 #include "MapRunner.h"
 #include <dbcreader/DBCReader.h>
+#include <shared/threading/ThreadPool.h>
 #include <boost/container/static_vector.hpp>
 #include <boost/program_options.hpp>
 #include <algorithm>
@@ -39,10 +40,12 @@ int launch(const boost::program_options::variables_map& args, log::Logger& logge
 		LOG_DEBUG(logger) << message << LOG_SYNC;
 	});
 
-	auto dbc_store = loader.load("Map", "GameTips");
+	// only needed during startup, the calling thread takes the other DBC
+	ThreadPool pool(1);
+	auto dbc_store = loader.load(pool, "Map", "GameTips");
 
 	LOG_INFO(logger) << "Resolving DBC references..." << LOG_SYNC;
-	dbc::link(dbc_store);
+	dbc::link(dbc_store, pool);
 
 	print_tip(dbc_store.game_tips, logger);
 
@@ -86,20 +89,16 @@ bool validate_maps(std::span<const std::int32_t> maps,
                    const dbc::DBCMap<dbc::Map>& dbc,
                    log::Logger& logger) {
 	const auto validate = [&](const auto id) {
-		auto it = std::ranges::find_if(dbc, [&](auto& record) {
-			return record.second.id == id;
-		});
+		const auto map = dbc[id];
 
-		if(it == dbc.end()) {
+		if(!map) {
 			LOG_ERROR_SYNC(logger, "Unknown map ID ({}) specified", id);
 			return false;
 		}
 
-		auto& [_, map] = *it;
-
-		if(map.instance_type != dbc::Map::InstanceType::NORMAL) {
+		if(map->instance_type != dbc::Map::InstanceType::NORMAL) {
 			LOG_ERROR_SYNC(logger, "Map {} ({}) is not an open world area",
-			               map.id, map.map_name.en_gb);
+			               map->id, map->map_name.en_gb);
 			return false;
 		}
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gateway/CompressMessage.h>
+#include <spark/buffers/pmr/BufferAdaptor.h>
+#include <boost/endian/conversion.hpp>
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+using namespace ember;
+
+namespace {
+
+// loosely resembles update object blocks - repetitive with some noise
+std::vector<std::uint8_t> generate_payload(const std::size_t size, const unsigned int seed) {
+	std::vector<std::uint8_t> payload(size);
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<unsigned int> dist(0, 255);
+
+	for(std::size_t i = 0; i < size; ++i) {
+		payload[i] = (i % 16 < 12)? static_cast<std::uint8_t>(i % 7) : static_cast<std::uint8_t>(dist(rng));
+	}
+
+	return payload;
+}
+
+std::vector<std::uint8_t> decompress(const std::vector<std::uint8_t>& message) {
+	std::uint32_t size = 0;
+	std::memcpy(&size, message.data(), sizeof(size));
+	boost::endian::little_to_native_inplace(size);
+
+	std::vector<std::uint8_t> out(size);
+	uLongf out_len = size;
+	const auto ret = uncompress(out.data(), &out_len, message.data() + sizeof(size),
+	                            static_cast<uLong>(message.size() - sizeof(size)));
+
+	if(ret != Z_OK || out_len != size) {
+		return {};
+	}
+
+	return out;
+}
+
+} // unnamed
+
+TEST(CompressMessage, RoundTrip) {
+	const auto payload = generate_payload(4096, 1);
+
+	for(int level = 1; level <= MAX_COMPRESSION_LEVEL; ++level) {
+		std::vector<std::uint8_t> out;
+		spark::io::pmr::BufferAdaptor adaptor(out);
+		ASSERT_EQ(compress_message(payload, adaptor, level), Z_OK);
+		ASSERT_LT(out.size(), payload.size());
+		ASSERT_EQ(decompress(out), payload) << "Level " << level;
+	}
+}
+
+TEST(CompressMessage, ContextReuse) {
+	// alternate levels and sizes to make sure the reused stream is reset properly
+	for(int i = 0; i < 32; ++i) {
+		const auto payload = generate_payload(128 + i * 97, i);
+		std::vector<std::uint8_t> out;
+		spark::io::pmr::BufferAdaptor adaptor(out);
+		ASSERT_EQ(compress_message(payload, adaptor, 1 + (i % MAX_COMPRESSION_LEVEL)), Z_OK);
+		ASSERT_EQ(decompress(out), payload);
+	}
+}
+
+TEST(CompressMessage, Incompressible) {
+	std::vector<std::uint8_t> payload(COMPRESSION_THRESHOLD);
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<unsigned int> dist(0, 255);
+
+	for(auto& byte : payload) {
+		byte = static_cast<std::uint8_t>(dist(rng));
+	}
+
+	std::vector<std::uint8_t> out;
+	spark::io::pmr::BufferAdaptor adaptor(out);
+	ASSERT_EQ(compress_message(payload, adaptor, MAX_COMPRESSION_LEVEL), Z_OK);
+	ASSERT_EQ(decompress(out), payload);
+}
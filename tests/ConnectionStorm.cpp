@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gateway/ClientConnection.h>
+#include <gateway/EventDispatcher.h>
+#include <gateway/Locator.h>
+#include <gateway/NetworkListener.h>
+#include <gateway/ServerConfig.h>
+#include <logger/Logger.h>
+#include <shared/threading/ServicePool.h>
+#include <shared/util/ReusePort.h>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace ember;
+namespace bai = boost::asio::ip;
+
+namespace {
+
+/*
+ * Connects the given number of clients, waiting on each until the
+ * gateway's auth challenge arrives, at which point its session has been
+ * registered. The sockets are returned so that the sessions stay open.
+ */
+std::vector<bai::tcp::socket> connect(boost::asio::io_context& ctx, const std::uint16_t port,
+                                      const std::size_t count) {
+	const bai::tcp::endpoint endpoint(bai::address_v4::loopback(), port);
+	std::vector<bai::tcp::socket> clients;
+
+	for(std::size_t i = 0; i < count; ++i) {
+		auto& socket = clients.emplace_back(ctx);
+		socket.connect(endpoint);
+
+		std::uint8_t byte;
+		boost::asio::read(socket, boost::asio::buffer(&byte, 1));
+	}
+
+	return clients;
+}
+
+// sessions per io_context, going by the service index in their UUIDs
+std::vector<std::size_t> sessions_by_service(NetworkListener& listener, const std::size_t services) {
+	std::vector<std::size_t> sessions(services);
+
+	listener.sessions().for_each([&](const ClientConnection& client) {
+		++sessions.at(client.uuid().service());
+	});
+
+	return sessions;
+}
+
+void accept_all(const bool reuse_port) {
+	constexpr std::size_t CLIENTS = 64;
+
+	log::Logger logger;
+	log::global_logger(logger);
+
+	ServicePool pool(4);
+	pool.run();
+
+	EventDispatcher dispatcher(pool);
+	Locator::set(&dispatcher);
+
+	const ServerConfig config {};
+	NetworkListener listener(pool, "127.0.0.1", 0, true, reuse_port, config, &logger);
+
+	boost::asio::io_context ctx;
+	auto clients = connect(ctx, listener.port(), CLIENTS);
+
+	// expectations rather than assertions, the globals need resetting either way
+	const auto sessions = sessions_by_service(listener, pool.size());
+	EXPECT_EQ(std::accumulate(sessions.begin(), sessions.end(), std::size_t(0)), CLIENTS);
+
+	// each session must be counted against the io_context its UUID names
+	for(std::size_t i = 0; i < pool.size(); ++i) {
+		EXPECT_EQ(pool.load(i).connections.load(), sessions[i]);
+	}
+
+	// whether spread by the kernel or by the placement policy
+	EXPECT_GT(std::ranges::count_if(sessions, [](auto count) { return count > 0; }), 1);
+
+	listener.shutdown();
+	pool.stop();
+	Locator::set(static_cast<EventDispatcher*>(nullptr));
+	log::global_logger(nullptr);
+}
+
+} // unnamed
+
+TEST(ConnectionStorm, ReusePort_SharedPort) {
+	if(!util::reuse_port_supported) {
+		GTEST_SKIP();
+	}
+
+	boost::asio::io_context ctx;
+	bai::tcp::acceptor first(ctx), second(ctx);
+	util::listen(first, { bai::address_v4::loopback(), 0 }, true);
+	ASSERT_NO_THROW(util::listen(second, first.local_endpoint(), true));
+	ASSERT_EQ(first.local_endpoint(), second.local_endpoint());
+}
+
+TEST(ConnectionStorm, Exclusive_PortInUse) {
+	boost::asio::io_context ctx;
+	bai::tcp::acceptor first(ctx), second(ctx);
+	util::listen(first, { bai::address_v4::loopback(), 0 }, false);
+	ASSERT_THROW(util::listen(second, first.local_endpoint(), false), boost::system::system_error);
+}
+
+TEST(ConnectionStorm, ReusePort_AcceptsAll) {
+	if(!util::reuse_port_supported) {
+		GTEST_SKIP();
+	}
+
+	accept_all(true);
+}
+
+TEST(ConnectionStorm, Exclusive_AcceptsAll) {
+	accept_all(false);
+}
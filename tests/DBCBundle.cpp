@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <tools/dbcparser/BundleGenerator.h>
+#include <dbcreader/Bundle.h>
+#include <dbcreader/BundleLoader.h>
+#include <dbcreader/DBCHeader.h>
+#include <dbcreader/DBCView.h>
+#include <logger/Logger.h>
+#include <boost/endian/arithmetic.hpp>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace ember;
+using namespace std::string_literals;
+namespace be = boost::endian;
+
+namespace {
+
+#pragma pack(push, 1)
+
+struct Record {
+	be::little_uint32_t id;
+	be::little_uint32_t name;
+	be::little_int32_t value;
+};
+
+struct Reference {
+	be::little_uint32_t id;
+	be::little_uint32_t item_class;
+};
+
+#pragma pack(pop)
+
+constexpr std::size_t FIELDS = 3;
+constexpr std::size_t ITEM_CLASS_FIELDS = 12;
+
+using Words = std::vector<std::uint32_t>;
+
+dbc::types::Field& add_field(dbc::types::Struct& dbc, std::string name, std::string type,
+                             std::vector<dbc::types::Key> keys = {}) {
+	auto& field = dbc.fields.emplace_back();
+	field.name = std::move(name);
+	field.underlying_type = std::move(type);
+	field.keys = std::move(keys);
+	field.parent = &dbc;
+	return field;
+}
+
+dbc::types::Struct& add_dbc(dbc::types::Definitions& defs, std::string name) {
+	auto dbc = std::make_unique<dbc::types::Struct>();
+	dbc->name = std::move(name);
+	dbc->dbc = true;
+	auto& ref = *dbc;
+	defs.emplace_back(std::move(dbc));
+	return ref;
+}
+
+// "Test", matching Record
+void define_test(dbc::types::Definitions& defs, const bool keyed) {
+	auto& dbc = add_dbc(defs, "Test");
+
+	if(keyed) {
+		add_field(dbc, "id", "uint32", { { .type = "primary" } });
+	} else {
+		add_field(dbc, "id", "uint32");
+	}
+
+	add_field(dbc, "name", "string_ref");
+	add_field(dbc, "value", "int32");
+}
+
+// mirrors ItemClass.xml, so the bundle can be loaded through BundleLoader
+void define_item_class(dbc::types::Definitions& defs) {
+	auto& dbc = add_dbc(defs, "ItemClass");
+	auto type = std::make_unique<dbc::types::Enum>();
+	type->name = "Class";
+	type->underlying_type = "int32";
+	type->parent = &dbc;
+	dbc.children.emplace_back(std::move(type));
+
+	add_field(dbc, "id", "uint32", { { .type = "primary" } });
+	add_field(dbc, "subclass_map", "uint32");
+	add_field(dbc, "item_class", "Class");
+	add_field(dbc, "class_name", "string_ref_loc");
+}
+
+/*
+ * Builds bundles from synthetic DBCs written to a temporary directory,
+ * using the same generator as dbc-parser --bundle.
+ */
+class DBCBundle : public ::testing::Test {
+public:
+	void SetUp() override {
+		logger = std::make_unique<log::Logger>();
+		log::global_logger(logger.get());
+		dir = std::filesystem::temp_directory_path() / "ember_dbc_bundle_test";
+		std::filesystem::remove_all(dir);
+		std::filesystem::create_directory(dir);
+	}
+
+	void TearDown() override {
+		std::filesystem::remove_all(dir);
+		log::global_logger(nullptr);
+	}
+
+	// every field in these DBCs is four bytes wide
+	void write_dbc(const std::string& name, std::size_t fields, const std::vector<Words>& records,
+	               const std::string& strings) {
+		const std::size_t words = records.empty()? 0 : records.front().size();
+
+		const dbc::DBCHeader header {
+			.magic = dbc::DBC_MAGIC,
+			.records = static_cast<std::uint32_t>(records.size()),
+			.fields = static_cast<std::uint32_t>(fields),
+			.record_size = static_cast<std::uint32_t>(words * sizeof(std::uint32_t)),
+			.string_block_len = static_cast<std::uint32_t>(strings.size())
+		};
+
+		std::ofstream file(dir / (name + ".dbc"), std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		for(const auto& record : records) {
+			for(const auto word : record) {
+				const be::little_uint32_t value = word;
+				file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+			}
+		}
+
+		file.write(strings.data(), strings.size());
+	}
+
+	// a "Test" record per ID, named after the ID
+	void write_test(const std::vector<std::uint32_t>& ids) {
+		std::string strings(1, '\0');
+		std::vector<Words> records;
+
+		for(const auto id : ids) {
+			const auto name = static_cast<std::uint32_t>(strings.size());
+			records.emplace_back(Words { id, name, static_cast<std::uint32_t>(-static_cast<std::int32_t>(id)) });
+
+			strings += "record " + std::to_string(id) + '\0';
+		}
+
+		write_dbc("Test", FIELDS, records, strings);
+	}
+
+	std::filesystem::path build(const dbc::types::Definitions& defs) {
+		const auto bundle = dbc::build_bundle(defs, dir);
+		const auto path = dir / "test.bundle";
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(bundle.data()), bundle.size());
+		return path;
+	}
+
+	std::unique_ptr<log::Logger> logger;
+	std::filesystem::path dir;
+};
+
+void corrupt(const std::filesystem::path& path, std::size_t offset) {
+	std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+	file.seekp(offset);
+	file.put('\xff');
+}
+
+} // unnamed
+
+TEST_F(DBCBundle, Indices) {
+	// the generator picks a dense index for compact IDs and a sorted one otherwise
+	const std::vector<std::pair<std::vector<std::uint32_t>, dbc::BundleIndex>> cases {
+		{ { 7, 3, 5, 12 }, dbc::BundleIndex::DENSE },
+		{ { 7, 3, 5000, 12 }, dbc::BundleIndex::SORTED }
+	};
+
+	dbc::types::Definitions defs;
+	define_test(defs, true);
+
+	for(const auto& [ids, type] : cases) {
+		write_test(ids);
+		const auto path = build(defs);
+		const dbc::Bundle bundle(path.string());
+		const auto entry = bundle.find("Test");
+		ASSERT_NE(entry, nullptr);
+		ASSERT_EQ(entry->index_type, std::to_underlying(type));
+
+		const auto view = dbc::DBCView<Record>::open(bundle, "Test", FIELDS);
+		ASSERT_EQ(view.size(), ids.size());
+
+		for(const auto id : ids) {
+			const auto record = view[id];
+			ASSERT_NE(record, nullptr);
+			ASSERT_EQ(record->id, id);
+			ASSERT_EQ(record->value, -static_cast<std::int32_t>(id));
+			ASSERT_EQ(view.string(record->name), "record " + std::to_string(id));
+		}
+
+		ASSERT_EQ(view[0], nullptr);
+		ASSERT_EQ(view[4], nullptr);
+		ASSERT_EQ(view[5001], nullptr);
+	}
+}
+
+TEST_F(DBCBundle, DuplicateIDs) {
+	dbc::types::Definitions defs;
+	define_test(defs, true);
+	write_test({ 1, 2, 1 });
+
+	const dbc::Bundle bundle(build(defs).string());
+	const auto view = dbc::DBCView<Record>::open(bundle, "Test", FIELDS);
+
+	// the first record with a given ID wins
+	ASSERT_EQ(view.size(), 3);
+	ASSERT_EQ(view[1], &view.records()[0]);
+}
+
+TEST_F(DBCBundle, Unkeyed) {
+	dbc::types::Definitions defs;
+	define_test(defs, false);
+	write_test({ 100, 200 });
+
+	const dbc::Bundle bundle(build(defs).string());
+	ASSERT_EQ(bundle.find("Test")->index_type, std::to_underlying(dbc::BundleIndex::NONE));
+
+	const auto view = dbc::DBCView<Record>::open(bundle, "Test", FIELDS);
+	ASSERT_EQ(view.size(), 2);
+	ASSERT_EQ(view[0]->id, 100);
+	ASSERT_EQ(view[1]->id, 200);
+	ASSERT_EQ(view[2], nullptr);
+}
+
+TEST_F(DBCBundle, SharedStrings) {
+	dbc::types::Definitions defs;
+	define_test(defs, true);
+
+	auto& other = add_dbc(defs, "Other");
+	add_field(other, "id", "uint32", { { .type = "primary" } });
+	add_field(other, "name", "string_ref");
+	add_field(other, "value", "int32");
+
+	// duplicate strings within and across DBCs, at different offsets in each file
+	const auto test_strings = "\0shared\0only test\0"s;
+	const auto other_strings = "\0padding\0shared\0"s;
+	write_dbc("Test", FIELDS, { { 1, 1, 0 }, { 2, 1, 0 }, { 3, 8, 0 }, { 4, 0, 0 } }, test_strings);
+	write_dbc("Other", FIELDS, { { 1, 9, 0 } }, other_strings);
+
+	const dbc::Bundle bundle(build(defs).string());
+	const auto test = dbc::DBCView<Record>::open(bundle, "Test", FIELDS);
+	const auto other_view = dbc::DBCView<Record>::open(bundle, "Other", FIELDS);
+
+	ASSERT_EQ(test.string(test[1]->name), "shared");
+	ASSERT_EQ(test.string(test[3]->name), "only test");
+	ASSERT_EQ(other_view.string(other_view[1]->name), "shared");
+	ASSERT_EQ(test[1]->name, test[2]->name);
+	ASSERT_EQ(test[1]->name, other_view[1]->name);
+	ASSERT_EQ(test[4]->name, 0);
+	ASSERT_EQ(test.string(test[4]->name), "");
+
+	// strings that no record refers to aren't carried over
+	ASSERT_EQ(bundle.strings().find("padding"), std::string_view::npos);
+}
+
+TEST_F(DBCBundle, Layout) {
+	dbc::types::Definitions defs;
+	define_test(defs, true);
+	define_item_class(defs);
+
+	auto& reference = add_dbc(defs, "Reference");
+	add_field(reference, "id", "uint32", { { .type = "primary" } });
+	add_field(reference, "item_class", "uint32", { { .type = "foreign", .parent = "ItemClass" } });
+
+	write_test({ 1, 2, 3 });
+	write_dbc("ItemClass", ITEM_CLASS_FIELDS, {
+		{ 2, 20, 1, 7, 0, 0, 1, 0, 0, 0, 0, 0 },
+		{ 4, 40, 0, 14, 0, 0, 0, 0, 0, 0, 0, 0 }
+	}, "\0Waffe\0Weapon\0Armour\0"s);
+
+	// the dangling reference is only reported and is left as it was
+	write_dbc("Reference", 2, { { 1, 2 }, { 2, 3 }, { 3, 0 } }, std::string(1, '\0'));
+
+	const auto path = build(defs);
+
+	{
+		const dbc::Bundle bundle(path.string());
+		ASSERT_EQ(bundle.entries().size(), 3);
+		std::size_t end = sizeof(dbc::BundleHeader) + (bundle.entries().size() * sizeof(dbc::BundleEntry));
+
+		// each DBC's records are followed by its index, in definition order
+		for(const auto& entry : bundle.entries()) {
+			ASSERT_EQ(entry.records_offset, end);
+			ASSERT_EQ(entry.index_offset, entry.records_offset + (entry.records * entry.record_size));
+			ASSERT_EQ(entry.index_type, std::to_underlying(dbc::BundleIndex::DENSE));
+			end = entry.index_offset + (entry.index_size * sizeof(be::little_uint32_t));
+		}
+
+		const auto view = dbc::DBCView<Reference>::open(bundle, "Reference", 2);
+		ASSERT_EQ(view[1]->item_class, 2);
+		ASSERT_EQ(view[2]->item_class, 3);
+		ASSERT_EQ(view[3]->item_class, 0);
+	}
+
+	const dbc::BundleLoader loader(path.string());
+	const auto storage = loader.load("ItemClass");
+	ASSERT_EQ(storage.item_class.size(), 2);
+	ASSERT_EQ(storage.item_class[3], nullptr);
+
+	const auto weapon = storage.item_class[2];
+	ASSERT_NE(weapon, nullptr);
+	ASSERT_EQ(weapon->subclass_map, 20);
+	ASSERT_EQ(storage.item_class.string(weapon->class_name.en_gb), "Weapon");
+	ASSERT_EQ(storage.item_class.string(weapon->class_name.de_de), "Waffe");
+
+	const auto armour = storage.item_class[4];
+	ASSERT_NE(armour, nullptr);
+	ASSERT_EQ(storage.item_class.string(armour->class_name.en_gb), "Armour");
+	ASSERT_EQ(storage.item_class.string(armour->class_name.de_de), "");
+
+	// the generator doesn't know about Test or Reference
+	ASSERT_THROW(loader.load(), std::runtime_error);
+}
+
+TEST_F(DBCBundle, GeneratorValidation) {
+	dbc::types::Definitions defs;
+	define_test(defs, true);
+
+	// missing file
+	ASSERT_THROW(dbc::build_bundle(defs, dir), std::runtime_error);
+
+	// string reference past the end of the string block
+	write_dbc("Test", FIELDS, { { 1, 64, 0 } }, std::string(1, '\0'));
+	ASSERT_THROW(dbc::build_bundle(defs, dir), std::runtime_error);
+
+	// unterminated string
+	write_dbc("Test", FIELDS, { { 1, 1, 0 } }, "\0abc"s);
+	ASSERT_THROW(dbc::build_bundle(defs, dir), std::runtime_error);
+
+	// field count doesn't match the definition
+	write_dbc("Test", FIELDS + 1, { { 1, 0, 0 } }, std::string(1, '\0'));
+	ASSERT_THROW(dbc::build_bundle(defs, dir), std::runtime_error);
+}
+
+TEST_F(DBCBundle, GenerateBundle) {
+	dbc::types::Definitions defs;
+	define_test(defs, true);
+	write_test({ 1 });
+
+	// the output directory is created if it doesn't exist
+	const auto out = dir / "out";
+	dbc::generate_bundle(defs, dir.string(), out.string());
+
+	const dbc::Bundle bundle((out / "dbc.bundle").string());
+	ASSERT_NE(bundle.find("Test"), nullptr);
+}
+
+TEST_F(DBCBundle, OutlivesBundle) {
+	dbc::types::Definitions defs;
+	define_test(defs, true);
+	write_test({ 1 });
+
+	const auto path = build(defs);
+	dbc::DBCView<Record> view;
+
+	{
+		const dbc::Bundle bundle(path.string());
+		view = dbc::DBCView<Record>::open(bundle, "Test", FIELDS);
+	}
+
+	// the view keeps the mapping alive
+	ASSERT_EQ(view.string(view[1]->name), "record 1");
+}
+
+TEST_F(DBCBundle, Validation) {
+	dbc::types::Definitions defs;
+	define_test(defs, true);
+	write_test({ 1 });
+
+	auto path = build(defs);
+
+	{
+		const dbc::Bundle bundle(path.string());
+		ASSERT_EQ(bundle.find("Missing"), nullptr);
+		ASSERT_THROW(dbc::DBCView<Record>::open(bundle, "Missing", FIELDS), std::runtime_error);
+		ASSERT_THROW(dbc::DBCView<Record>::open(bundle, "Test", FIELDS + 1), std::runtime_error);
+	}
+
+	// unsupported version
+	corrupt(path, offsetof(dbc::BundleHeader, version));
+	ASSERT_THROW(dbc::Bundle(path.string(), dbc::Bundle::Checksum::SKIP), std::runtime_error);
+
+	// flip a byte in the body, which only the checksum catches
+	path = build(defs);
+	corrupt(path, sizeof(dbc::BundleHeader) + sizeof(dbc::BundleEntry));
+	ASSERT_THROW(dbc::Bundle(path.string()), std::runtime_error);
+	ASSERT_NO_THROW(dbc::Bundle(path.string(), dbc::Bundle::Checksum::SKIP));
+
+	corrupt(path, 0);
+	ASSERT_THROW(dbc::Bundle(path.string(), dbc::Bundle::Checksum::SKIP), std::runtime_error);
+
+	path = build(defs);
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+	ASSERT_THROW(dbc::Bundle(path.string(), dbc::Bundle::Checksum::SKIP), std::runtime_error);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <dbcreader/DBCMap.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace ember;
+
+namespace {
+
+struct Record {
+	std::size_t id;
+	std::string name;
+};
+
+} // unnamed
+
+TEST(DBCMap, Dense) {
+	dbc::DBCMap<Record> map;
+	map.reserve(10, 19, 8);
+	ASSERT_TRUE(map.dense());
+
+	for(std::size_t id = 10; id < 20; ++id) {
+		if(id != 13 && id != 17) {
+			map.emplace_back(id, Record{ id, std::to_string(id) });
+		}
+	}
+
+	ASSERT_EQ(map.size(), 8);
+	ASSERT_TRUE(map.dense());
+
+	for(std::size_t id = 0; id < 30; ++id) {
+		const auto record = map[id];
+
+		if(id < 10 || id >= 20 || id == 13 || id == 17) {
+			ASSERT_EQ(record, nullptr);
+		} else {
+			ASSERT_NE(record, nullptr);
+			ASSERT_EQ(record->id, id);
+			ASSERT_EQ(record->name, std::to_string(id));
+		}
+	}
+
+	// unoccupied slots are skipped
+	std::vector<std::size_t> ids;
+
+	for(const auto& [id, record] : map) {
+		ASSERT_EQ(id, record.id);
+		ids.emplace_back(id);
+	}
+
+	const std::vector<std::size_t> expected { 10, 11, 12, 14, 15, 16, 18, 19 };
+	ASSERT_EQ(ids, expected);
+	ASSERT_EQ(std::ranges::distance(map.values()), 8);
+}
+
+TEST(DBCMap, Sparse) {
+	dbc::DBCMap<Record> map;
+	const std::vector<std::size_t> ids { 90000, 5, 400, 70000, 1 };
+	map.reserve(1, 90000, ids.size());
+	ASSERT_FALSE(map.dense());
+
+	for(const auto id : ids) {
+		map.emplace_back(id, Record{ id, std::to_string(id) });
+	}
+
+	ASSERT_EQ(map.size(), ids.size());
+
+	for(const auto id : ids) {
+		ASSERT_NE(map[id], nullptr);
+		ASSERT_EQ(map[id]->id, id);
+	}
+
+	ASSERT_EQ(map[0], nullptr);
+	ASSERT_EQ(map[6], nullptr);
+	ASSERT_EQ(map[90001], nullptr);
+
+	// iterates in ID order regardless of insertion order
+	ASSERT_TRUE(std::ranges::is_sorted(map, {}, [](const auto& entry) { return entry.first; }));
+}
+
+TEST(DBCMap, Unreserved) {
+	dbc::DBCMap<Record> map;
+	map.emplace_back(3, Record{ 3 });
+	map.emplace_back(1, Record{ 1 });
+	ASSERT_FALSE(map.dense());
+	ASSERT_EQ(map.size(), 2);
+	ASSERT_EQ(map[1]->id, 1);
+	ASSERT_EQ(map[3]->id, 3);
+	ASSERT_EQ(map[2], nullptr);
+}
+
+TEST(DBCMap, DuplicateID) {
+	for(const auto dense : { true, false }) {
+		dbc::DBCMap<Record> map;
+		map.reserve(0, dense? 1 : 1000, 2);
+		ASSERT_EQ(map.dense(), dense);
+
+		// the first record with a given ID is kept
+		map.emplace_back(1, Record{ 1, "first" });
+		map.emplace_back(1, Record{ 1, "second" });
+		ASSERT_EQ(map.size(), 1);
+		ASSERT_EQ(map[1]->name, "first");
+	}
+}
+
+TEST(DBCMap, DenseOutOfRange) {
+	dbc::DBCMap<Record> map;
+	map.reserve(100, 103, 4);
+	ASSERT_TRUE(map.dense());
+
+	map.emplace_back(101, Record{ 101 });
+	map.emplace_back(103, Record{ 103 });
+
+	// an ID outside of the reserved range switches to the sparse layout
+	map.emplace_back(5, Record{ 5 });
+	map.emplace_back(5000, Record{ 5000 });
+	ASSERT_FALSE(map.dense());
+	ASSERT_EQ(map.size(), 4);
+
+	std::vector<std::size_t> ids;
+
+	for(const auto& record : map.values()) {
+		ids.emplace_back(record.id);
+	}
+
+	const std::vector<std::size_t> expected { 5, 101, 103, 5000 };
+	ASSERT_EQ(ids, expected);
+	ASSERT_EQ(map[100], nullptr);
+}
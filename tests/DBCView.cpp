@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <dbcreader/DBCView.h>
+#include <boost/endian/arithmetic.hpp>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+namespace be = boost::endian;
+
+namespace {
+
+#pragma pack(push, 1)
+
+struct Record {
+	be::little_uint32_t id;
+	be::little_uint32_t name;
+	be::little_int32_t value;
+};
+
+#pragma pack(pop)
+
+constexpr std::size_t FIELDS = 3;
+
+// writes a DBC containing a record per ID, named after the ID
+std::filesystem::path write_dbc(const std::vector<std::uint32_t>& ids,
+                                std::uint32_t magic = dbc::DBC_MAGIC) {
+	std::string strings(1, '\0');
+	std::vector<Record> records;
+
+	for(const auto id : ids) {
+		records.emplace_back(Record {
+			.id = id,
+			.name = static_cast<std::uint32_t>(strings.size()),
+			.value = -static_cast<std::int32_t>(id)
+		});
+
+		strings += "record " + std::to_string(id) + '\0';
+	}
+
+	const dbc::DBCHeader header {
+		.magic = magic,
+		.records = static_cast<std::uint32_t>(records.size()),
+		.fields = FIELDS,
+		.record_size = sizeof(Record),
+		.string_block_len = static_cast<std::uint32_t>(strings.size())
+	};
+
+	const auto path = std::filesystem::temp_directory_path() / "ember_dbc_view_test.dbc";
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+	file.write(strings.data(), strings.size());
+	return path;
+}
+
+} // unnamed
+
+TEST(DBCView, Keyed) {
+	const std::vector<std::uint32_t> ids { 7, 3, 5000, 12 };
+	const auto path = write_dbc(ids);
+
+	{
+		const auto view = dbc::DBCView<Record>::open(path.string(), "Test", FIELDS, [](const auto& record) {
+			return record.id;
+		});
+
+		ASSERT_EQ(view.size(), ids.size());
+
+		for(const auto id : ids) {
+			const auto record = view[id];
+			ASSERT_NE(record, nullptr);
+			ASSERT_EQ(record->id, id);
+			ASSERT_EQ(record->value, -static_cast<std::int32_t>(id));
+			ASSERT_EQ(view.string(record->name), "record " + std::to_string(id));
+		}
+
+		ASSERT_EQ(view[0], nullptr);
+		ASSERT_EQ(view[4], nullptr);
+		ASSERT_EQ(view[5001], nullptr);
+
+		// records are iterated in file order
+		std::vector<std::uint32_t> order;
+
+		for(const auto& record : view) {
+			order.emplace_back(record.id);
+		}
+
+		ASSERT_EQ(order, ids);
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST(DBCView, Unkeyed) {
+	const auto path = write_dbc({ 100, 200 });
+
+	{
+		const auto view = dbc::DBCView<Record>::open(path.string(), "Test", FIELDS);
+		ASSERT_EQ(view.size(), 2);
+		ASSERT_EQ(view[0]->id, 100);
+		ASSERT_EQ(view[1]->id, 200);
+		ASSERT_EQ(view[2], nullptr);
+		ASSERT_EQ(view[100], nullptr);
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST(DBCView, Strings) {
+	const auto path = write_dbc({ 1 });
+
+	{
+		const auto view = dbc::DBCView<Record>::open(path.string(), "Test", FIELDS);
+		ASSERT_EQ(view.string(0), "");
+		ASSERT_EQ(view.string(1), "record 1");
+		ASSERT_EQ(view.string(8), "1");
+
+		// offsets past the end of the string block are treated as empty
+		ASSERT_EQ(view.string(10000), "");
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST(DBCView, Validation) {
+	auto path = write_dbc({ 1 }, 0);
+	ASSERT_THROW(dbc::DBCView<Record>::open(path.string(), "Test", FIELDS), std::runtime_error);
+
+	path = write_dbc({ 1 });
+	ASSERT_THROW(dbc::DBCView<Record>::open(path.string(), "Test", FIELDS + 1), std::runtime_error);
+
+	// truncate the string block
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+	ASSERT_THROW(dbc::DBCView<Record>::open(path.string(), "Test", FIELDS), std::runtime_error);
+
+	std::filesystem::remove(path);
+}
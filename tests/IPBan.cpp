@@ -8,8 +8,14 @@
 
 #include <shared/IPBanCache.h>
 #include <gtest/gtest.h>
+#include <boost/asio/ip/address.hpp>
+#include <algorithm>
 #include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
 #include <vector>
+#include <cstdint>
 
 class IPBanTest : public ::testing::Test {
 public:
@@ -105,3 +111,125 @@ TEST_F(IPBanTest, IPv6BannedInRange) {
 TEST_F(IPBanTest, IPv6NotBanned) {
 	EXPECT_FALSE(bans->is_banned("2001:0db9::"));
 }
+
+TEST_F(IPBanTest, IPv4Mapped) {
+	EXPECT_TRUE(bans->is_banned("::ffff:192.88.99.62"));
+	EXPECT_FALSE(bans->is_banned("::ffff:192.88.99.63"));
+}
+
+TEST_F(IPBanTest, Unban) {
+	ASSERT_FALSE(bans->unban("192.88.99.62", 31)) << "Unbanned range that was never banned";
+	ASSERT_TRUE(bans->unban("192.88.99.62", 32));
+	ASSERT_FALSE(bans->unban("192.88.99.62", 32));
+	EXPECT_FALSE(bans->is_banned("192.88.99.62"));
+
+	ASSERT_TRUE(bans->unban("2001:db8::", 64));
+	EXPECT_FALSE(bans->is_banned("2001:db8::"));
+	EXPECT_EQ(bans->size(), 4);
+
+	// other bans should be unaffected
+	EXPECT_TRUE(bans->is_banned("203.62.113.83"));
+	EXPECT_TRUE(bans->is_banned("169.254.26.21"));
+}
+
+TEST_F(IPBanTest, OverlappingRanges) {
+	ASSERT_TRUE(bans->ban("172.16.125.0", 24));
+	ASSERT_FALSE(bans->ban("172.16.125.1", 24)) << "Duplicate range was added";
+	ASSERT_TRUE(bans->unban("172.16.0.0", 16));
+
+	// still covered by the narrower range
+	EXPECT_TRUE(bans->is_banned("172.16.125.134"));
+	EXPECT_FALSE(bans->is_banned("172.16.117.92"));
+
+	ASSERT_TRUE(bans->unban("172.16.125.0", 24));
+	EXPECT_FALSE(bans->is_banned("172.16.125.134"));
+}
+
+TEST_F(IPBanTest, InvalidCIDR) {
+	EXPECT_THROW(bans->ban("10.0.0.0", 33), std::invalid_argument);
+	EXPECT_THROW(bans->ban("2001:db8::", 129), std::invalid_argument);
+}
+
+TEST(IPBan, BanAll) {
+	ember::IPBanCache bans;
+	EXPECT_FALSE(bans.is_banned("10.0.0.1"));
+	bans.ban("0.0.0.0", 0);
+	EXPECT_TRUE(bans.is_banned("10.0.0.1"));
+	EXPECT_TRUE(bans.is_banned("255.255.255.255"));
+	EXPECT_FALSE(bans.is_banned("::1"));
+}
+
+namespace {
+
+struct Range {
+	std::uint32_t address;
+	std::uint32_t cidr;
+
+	bool contains(const std::uint32_t ip) const {
+		const auto mask = cidr? ~0u << (32 - cidr) : 0u;
+		return (ip & mask) == (address & mask);
+	}
+};
+
+std::string to_string(const std::uint32_t address) {
+	return boost::asio::ip::address_v4(address).to_string();
+}
+
+std::vector<Range> random_ranges(std::mt19937& rng, const std::size_t count) {
+	std::uniform_int_distribution<std::uint32_t> addr_dist;
+	std::uniform_int_distribution<std::uint32_t> cidr_dist(16, 32);
+	std::vector<Range> ranges;
+
+	for(std::size_t i = 0; i < count; ++i) {
+		ranges.emplace_back(addr_dist(rng), cidr_dist(rng));
+	}
+
+	return ranges;
+}
+
+} // unnamed
+
+// compares the cache against a linear scan while adding and removing ranges
+TEST(IPBan, Randomised) {
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<std::uint64_t> addr_dist(0, ~0u);
+	auto ranges = random_ranges(rng, 2000);
+	ember::IPBanCache bans;
+
+	auto verify = [&](const std::vector<Range>& active) {
+		for(std::size_t i = 0; i < 2000; ++i) {
+			// mix of addresses inside banned ranges and random ones
+			const auto& range = active.empty()? Range{} : active[i % active.size()];
+			const std::uint32_t ip = (i & 1)? addr_dist(rng) : range.address ^ static_cast<std::uint32_t>(addr_dist(rng) >> range.cidr);
+			const auto expected = std::ranges::any_of(active, [&](const Range& r) { return r.contains(ip); });
+			ASSERT_EQ(bans.is_banned(boost::asio::ip::address_v4(ip)), expected) << to_string(ip);
+		}
+	};
+
+	// random ranges can collide, so only track the ones that were added
+	std::erase_if(ranges, [&](const Range& range) {
+		return !bans.ban(to_string(range.address), range.cidr);
+	});
+
+	verify(ranges);
+
+	// remove every other range
+	std::vector<Range> remaining;
+
+	for(std::size_t i = 0; i < ranges.size(); ++i) {
+		if(i & 1) {
+			remaining.emplace_back(ranges[i]);
+		} else {
+			ASSERT_TRUE(bans.unban(to_string(ranges[i].address), ranges[i].cidr));
+		}
+	}
+
+	verify(remaining);
+
+	for(const auto& range : remaining) {
+		ASSERT_TRUE(bans.unban(to_string(range.address), range.cidr));
+	}
+
+	ASSERT_EQ(bans.size(), 0);
+	verify({});
+}
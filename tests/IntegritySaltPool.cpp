@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <login/IntegritySaltPool.h>
+#include <login/ExecutablesChecksum.h>
+#include <login/IntegrityData.h>
+#include <shared/metrics/Metrics.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+namespace {
+
+const GameVersion version {
+	.major = 1,
+	.minor = 12,
+	.build = 5875,
+};
+
+struct CountingMetrics final : Metrics {
+	std::unordered_map<std::string, std::intmax_t> counts;
+
+	void increment(const char* key, std::intmax_t value) override {
+		counts[key] += value;
+	}
+};
+
+bool wait_for_size(const IntegritySaltPool& pool, const std::size_t size) {
+	const auto deadline = std::chrono::steady_clock::now() + 10s;
+
+	while(pool.size() < size) {
+		if(std::chrono::steady_clock::now() > deadline) {
+			return false;
+		}
+
+		std::this_thread::sleep_for(1ms);
+	}
+
+	return true;
+}
+
+} // unnamed
+
+TEST(IntegritySaltPool, PrecomputedChecksum) {
+	IntegrityData data;
+	data.add_version(version, "test_data/");
+	CountingMetrics metrics;
+	IntegritySaltPool pool(data, metrics, 8, 0);
+	ASSERT_TRUE(wait_for_size(pool, 8));
+
+	const auto bins = data.lookup(version, grunt::Platform::x86, grunt::System::Win);
+	ASSERT_TRUE(bins);
+	std::set<IntegritySaltPool::Salt> salts;
+
+	for(int i = 0; i < 8; ++i) {
+		const auto entry = pool.acquire(version, grunt::Platform::x86, grunt::System::Win);
+		ASSERT_TRUE(entry.checksum);
+		ASSERT_EQ(*entry.checksum, client_integrity::checksum(entry.salt, *bins));
+		ASSERT_TRUE(salts.emplace(entry.salt).second) << "Salt was handed out twice";
+	}
+
+	ASSERT_EQ(metrics.counts["integrity_salt_hit"], 8);
+
+	// pool should be refilled in the background
+	ASSERT_TRUE(wait_for_size(pool, 8));
+}
+
+TEST(IntegritySaltPool, Miss) {
+	IntegrityData data;
+	data.add_version(version, "test_data/");
+	CountingMetrics metrics;
+	IntegritySaltPool pool(data, metrics, 0, 0); // never refilled
+
+	const auto entry = pool.acquire(version, grunt::Platform::x86, grunt::System::Win);
+	ASSERT_FALSE(entry.checksum);
+	ASSERT_EQ(metrics.counts["integrity_salt_miss"], 1);
+
+	// no binaries for this client, so not counted as a miss
+	const auto unsupported = pool.acquire(version, grunt::Platform::PPC, grunt::System::OSX);
+	ASSERT_FALSE(unsupported.checksum);
+	ASSERT_EQ(metrics.counts["integrity_salt_miss"], 1);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <login/NetworkListener.h>
+#include <logger/Logger.h>
+#include <shared/IPBanCache.h>
+#include <shared/metrics/Metrics.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+
+using namespace ember;
+using namespace std::chrono_literals;
+namespace bai = boost::asio::ip;
+
+namespace {
+
+class CountingMetrics final : public Metrics {
+public:
+	std::map<std::string, std::intmax_t> counters;
+
+	void increment(const char* key, std::intmax_t value) override {
+		counters[key] += value;
+	}
+};
+
+// every connection in these tests is aborted or banned before reaching this
+class NoSessions final : public NetworkSessionBuilder {
+public:
+	std::shared_ptr<LoginSession> create(SessionManager&, tcp_socket, log::Logger*) const override {
+		throw std::logic_error("Unexpected session");
+	}
+};
+
+} // unnamed
+
+TEST(LoginListener, AbortedConnection) {
+	log::Logger logger;
+	boost::asio::io_context service;
+	CountingMetrics metrics;
+	NoSessions builder;
+	IPBanCache bans;
+	bans.ban("127.0.0.1", 32);
+
+	NetworkListener listener(service, "127.0.0.1", 0, true, 1, builder, bans, &logger, metrics);
+	const bai::tcp::endpoint endpoint(bai::address_v4::loopback(), listener.port());
+
+	// reset while still waiting to be accepted, so the peer's endpoint can't be read
+	boost::asio::io_context ctx;
+	bai::tcp::socket aborted(ctx);
+	aborted.connect(endpoint);
+	aborted.set_option(boost::asio::socket_base::linger(true, 0));
+	aborted.close();
+
+	bai::tcp::socket banned(ctx);
+	banned.connect(endpoint);
+
+	while(!metrics.counters.contains("rejected_connections") && service.run_one_for(5s));
+
+	// the second connection is only seen if the loop carried on accepting
+	ASSERT_EQ(metrics.counters["aborted_connections"], 1);
+	ASSERT_EQ(metrics.counters["rejected_connections"], 1);
+	ASSERT_EQ(metrics.counters["accepted_connections"], 0);
+	listener.shutdown();
+}
@@ -7,10 +7,18 @@
  */
 
 #include <mpq/MPQ.h>
+#include <mpq/Crypt.h>
 #include <mpq/DynamicMemorySink.h>
+#include <mpq/SharedDefs.h>
+#include <shared/threading/ThreadPool.h>
 #include <shared/util/FileMD5.h>
 #include <botan/bigint.h>
 #include <gtest/gtest.h>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
 
 using namespace ember;
 
@@ -234,4 +242,113 @@ TEST(MPQ, Locate_BadAlignment) {
 	std::span span(data + 1, sizeof(data) - 1); // force misaligned buffer
 	auto result = mpq::locate_archive(span);
 	ASSERT_EQ(result.error(), mpq::ErrorCode::BAD_ALIGNMENT);
-}
\ No newline at end of file
+}
+
+// every file should extract identically whether sectors are handled in parallel or not
+TEST(MPQ, Extract_Parallel) {
+	auto archive = mpq::open_archive("test_data/mpqs/v1_16.mpq", 0);
+	ASSERT_TRUE(archive);
+	ThreadPool pool(4);
+
+	const std::vector<std::string> paths {
+		"owl.wav", "owl.mp3", "elevated_1920_1080.ex_", "ember.jpg", "ember.png",
+		"(listfile)", "(attributes)", "compressed.txt"
+	};
+
+	std::map<std::string, std::vector<std::byte>> expected;
+
+	for(const auto& path : paths) {
+		const auto index = archive->file_lookup(path, 0);
+		ASSERT_NE(index, mpq::Archive::npos);
+		std::vector<std::byte> output(archive->file_entry(index).uncompressed_size);
+		ASSERT_EQ(archive->extract_parallel(path, output, pool), output.size());
+
+		// extraction mustn't modify the archive, so a second pass has to match the first
+		mpq::DynamicMemorySink sink;
+		ASSERT_NO_THROW(archive->extract_file(path, sink));
+		ASSERT_TRUE(std::ranges::equal(sink.data(), output)) << path;
+		expected[path] = std::move(output);
+	}
+
+	std::mutex lock;
+	std::map<std::string, std::vector<std::byte>> extracted;
+
+	archive->extract_files(paths, pool, [&](const std::string& path, auto result) {
+		ASSERT_TRUE(result) << path;
+		std::lock_guard guard(lock);
+		extracted[path].assign(result->begin(), result->end());
+	});
+
+	ASSERT_EQ(extracted, expected);
+}
+
+TEST(MPQ, Extract_ParallelErrors) {
+	auto archive = mpq::open_archive("test_data/mpqs/v1_16.mpq", 0);
+	ASSERT_TRUE(archive);
+	ThreadPool pool(2);
+
+	std::vector<std::byte> output(16);
+	ASSERT_THROW(archive->extract_parallel("no_such_file", output, pool), mpq::exception);
+	ASSERT_THROW(archive->extract_parallel("owl.wav", output, pool), mpq::exception);
+
+	const std::vector<std::string> paths { "no_such_file", "compressed.txt" };
+	std::size_t failed = 0, succeeded = 0;
+	std::mutex lock;
+
+	archive->extract_files(paths, pool, [&](const std::string& path, auto result) {
+		std::lock_guard guard(lock);
+		result? ++succeeded : ++failed;
+	});
+
+	ASSERT_EQ(failed, 1);
+	ASSERT_EQ(succeeded, 1);
+}
+
+TEST(MPQ, HashName) {
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<int> len_dist(0, 40);
+	std::uniform_int_distribution<int> char_dist(0x20, 0x7e);
+	std::vector<std::string> names;
+
+	for(int i = 0; i < 100; ++i) {
+		std::string name(len_dist(rng), '\0');
+
+		for(auto& c : name) {
+			c = static_cast<char>(char_dist(rng));
+		}
+
+		names.emplace_back(std::move(name));
+	}
+
+	for(const auto& name : names) {
+		const auto hash = mpq::hash_name(name);
+		ASSERT_EQ(hash.a, mpq::hash_string(name, mpq::MPQ_HASH_NAME_A));
+		ASSERT_EQ(hash.b, mpq::hash_string(name, mpq::MPQ_HASH_NAME_B));
+	}
+}
+
+TEST(MPQ, LookupMany) {
+	auto archive = mpq::open_archive("test_data/mpqs/v1_16.mpq", 0);
+	ASSERT_TRUE(archive);
+
+	std::vector<std::string> names(archive->files().begin(), archive->files().end());
+	ASSERT_FALSE(names.empty());
+	names.emplace_back("no_such_file");
+	names.emplace_back("OWL.WAV"); // case-insensitive
+
+	const auto indices = archive->lookup_many(names);
+	ASSERT_EQ(indices.size(), names.size());
+
+	for(std::size_t i = 0; i < names.size(); ++i) {
+		ASSERT_EQ(indices[i], archive->file_lookup(names[i], 0)) << names[i];
+	}
+
+	ASSERT_EQ(indices[indices.size() - 2], mpq::Archive::npos);
+	ASSERT_EQ(indices.back(), archive->file_lookup("owl.wav", 0));
+	ASSERT_NE(indices.back(), mpq::Archive::npos);
+
+	// no file for this locale, so should fall back to the neutral locale
+	const auto localised = archive->lookup_many(names, 0x409);
+	ASSERT_EQ(localised, indices);
+	ASSERT_EQ(archive->file_lookup("owl.wav", 0x409), mpq::Archive::npos);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <character/NameCache.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+TEST(NameCache, InsertErase) {
+	NameCache cache(10, 1h);
+	ASSERT_FALSE(cache.taken(1, "Chaosvex"));
+
+	cache.insert(1, "Chaosvex");
+	ASSERT_TRUE(cache.taken(1, "Chaosvex"));
+	ASSERT_FALSE(cache.taken(2, "Chaosvex")); // names are per realm
+	ASSERT_FALSE(cache.taken(1, "Bankalt"));
+
+	cache.insert(1, "Chaosvex");
+	ASSERT_EQ(cache.size(), 1);
+
+	cache.erase(1, "Chaosvex");
+	ASSERT_FALSE(cache.taken(1, "Chaosvex"));
+	ASSERT_EQ(cache.size(), 0);
+}
+
+TEST(NameCache, Expiry) {
+	NameCache cache(10, 0s);
+	cache.insert(1, "Chaosvex");
+	ASSERT_FALSE(cache.taken(1, "Chaosvex"));
+}
+
+TEST(NameCache, Capacity) {
+	NameCache cache(3, 1h);
+
+	for(int i = 0; i < 5; ++i) {
+		cache.insert(1, "Name" + std::to_string(i));
+	}
+
+	ASSERT_EQ(cache.size(), 3);
+	ASSERT_FALSE(cache.taken(1, "Name0"));
+	ASSERT_FALSE(cache.taken(1, "Name1"));
+	ASSERT_TRUE(cache.taken(1, "Name4"));
+
+	// refreshing an entry makes it the newest
+	cache.insert(1, "Name2");
+	cache.insert(1, "Name5");
+	ASSERT_EQ(cache.size(), 3);
+	ASSERT_TRUE(cache.taken(1, "Name2"));
+	ASSERT_FALSE(cache.taken(1, "Name3"));
+	ASSERT_TRUE(cache.taken(1, "Name5"));
+
+	// repeated refreshes don't grow the insertion history without bound
+	for(int i = 0; i < 100; ++i) {
+		cache.insert(1, "Name5");
+	}
+
+	ASSERT_EQ(cache.size(), 3);
+	ASSERT_TRUE(cache.taken(1, "Name5"));
+}
+
+TEST(NameCache, Disabled) {
+	NameCache cache(0, 1h);
+	cache.insert(1, "Chaosvex");
+	ASSERT_FALSE(cache.taken(1, "Chaosvex"));
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/util/PCREHelper.h>
+#include <shared/util/UTF8.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace ember;
+
+namespace {
+
+bool match_each(const std::vector<util::pcre::Result>& patterns, const std::string& needle) {
+	for(const auto& pattern : patterns) {
+		if(util::pcre::match(needle, pattern) >= 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+std::vector<util::pcre::Result> compile_each(const std::vector<std::string>& expressions) {
+	std::vector<util::pcre::Result> patterns;
+
+	for(const auto& expression : expressions) {
+		patterns.emplace_back(util::pcre::utf8_jit_compile(expression));
+	}
+
+	return patterns;
+}
+
+} // unnamed
+
+TEST(NameFilter, MatchesIndividualPatterns) {
+	const std::vector<std::string> expressions {
+		"^arthas$", R"(\<thrall\>)", "sylvanas", "^[a-z]*fel$", "g[o0]+d", "(ab)\\1"
+	};
+
+	const util::pcre::PatternSet set(expressions);
+	const auto individual = compile_each(expressions);
+
+	const std::string needles[] {
+		"Arthas", "Arthasx", "Thrall", "Thrallson", "Lesylvanas", "Vilefel", "Felvile",
+		"Good", "G00d", "Gd", "Abab", "Ab", "Chaosvex"
+	};
+
+	for(const auto& needle : needles) {
+		EXPECT_EQ(set.match(needle) >= 0, match_each(individual, needle)) << needle;
+	}
+
+	// the backreference is kept apart, everything else shares a pattern
+	EXPECT_EQ(set.compiled_size(), 2);
+}
+
+TEST(NameFilter, SplitsLargeSets) {
+	std::vector<std::string> expressions;
+
+	for(std::size_t i = 0; i < 2000; ++i) {
+		expressions.emplace_back("^name" + std::to_string(i) + "$");
+	}
+
+	const util::pcre::PatternSet set(expressions);
+	EXPECT_GE(set.compiled_size(), 1);
+	EXPECT_LT(set.compiled_size(), expressions.size());
+
+	EXPECT_GE(set.match("Name0"), 0);
+	EXPECT_GE(set.match("Name1999"), 0);
+	EXPECT_EQ(set.match("Name2000"), PCRE_ERROR_NOMATCH);
+}
+
+TEST(NameFilter, Empty) {
+	const util::pcre::PatternSet set;
+	EXPECT_EQ(set.compiled_size(), 0);
+	EXPECT_EQ(set.match("Anything"), PCRE_ERROR_NOMATCH);
+}
+
+TEST(NameFilter, InvalidExpression) {
+	ASSERT_THROW(util::pcre::PatternSet({ "valid", "(unbalanced" }), std::runtime_error);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gateway/OutboundQueue.h>
+#include <gateway/SharedPacket.h>
+#include <protocol/Packets.h>
+#include <spark/buffers/DynamicBuffer.h>
+#include <boost/asio/buffer.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+using namespace std::literals;
+
+namespace {
+
+using Queue = OutboundQueue<spark::io::DynamicBuffer<8>>;
+
+std::string flatten(const Queue& queue, const std::size_t max = 64) {
+	std::vector<boost::asio::const_buffer> sequence;
+	queue.gather(sequence, max);
+	std::string out;
+
+	for(const auto& buffer : sequence) {
+		out.append(static_cast<const char*>(buffer.data()), buffer.size());
+	}
+
+	return out;
+}
+
+std::string payload_of(const SharedPacket& packet) {
+	const auto payload = packet.payload();
+	return { reinterpret_cast<const char*>(payload.data()), payload.size() };
+}
+
+} // unnamed
+
+TEST(OutboundQueue, SharedPacketLayout) {
+	protocol::SMSG_PONG pong;
+	pong->sequence_id = 0x01020304;
+	const auto packet = make_shared_packet(pong);
+
+	ASSERT_EQ(packet->data().size(), protocol::ServerHeader::WIRE_SIZE + 4);
+	ASSERT_EQ(packet->payload().size(), 4);
+	ASSERT_EQ(packet->payload()[0], 0x04);
+
+	// size covers the opcode and payload, big endian
+	const auto header = packet->header();
+	ASSERT_EQ(header[0], 0x00);
+	ASSERT_EQ(header[1], 0x06);
+}
+
+TEST(OutboundQueue, Interleaving) {
+	protocol::SMSG_PONG pong;
+	pong->sequence_id = 0x41424344;
+	const auto packet = make_shared_packet(pong);
+
+	Queue queue;
+	queue.buffer().write("0123456789", 10);
+	queue.attach(packet);
+	queue.buffer().write("abc", 3);
+	queue.attach(packet);
+	queue.buffer().write("xyz", 3);
+
+	const auto payload = payload_of(*packet);
+	const auto expected = "0123456789"s + payload + "abc" + payload + "xyz";
+	ASSERT_EQ(queue.size(), expected.size());
+	ASSERT_EQ(flatten(queue), expected);
+}
+
+TEST(OutboundQueue, PartialConsume) {
+	protocol::SMSG_PONG pong;
+	pong->sequence_id = 0x61626364;
+	const auto packet = make_shared_packet(pong);
+	const auto payload = payload_of(*packet);
+
+	for(std::size_t step = 1; step < 12; ++step) {
+		Queue queue;
+		queue.buffer().write("header", 6);
+		queue.attach(packet);
+		queue.attach(packet);
+		queue.buffer().write("trailer!", 8);
+		queue.attach(packet);
+
+		std::string expected = "header"s + payload + payload + "trailer!" + payload;
+
+		while(!queue.empty()) {
+			ASSERT_EQ(flatten(queue), expected) << "Step " << step;
+			const auto consume = std::min(step, expected.size());
+			queue.consume(consume);
+			expected.erase(0, consume);
+		}
+
+		ASSERT_TRUE(expected.empty());
+	}
+}
+
+TEST(OutboundQueue, GatherLimit) {
+	protocol::SMSG_PONG pong;
+	const auto packet = make_shared_packet(pong);
+
+	Queue queue;
+
+	for(int i = 0; i < 10; ++i) {
+		queue.buffer().write("hdr", 3);
+		queue.attach(packet);
+	}
+
+	std::vector<boost::asio::const_buffer> sequence;
+	queue.gather(sequence, 5);
+	ASSERT_EQ(sequence.size(), 5);
+}
+
+TEST(OutboundQueue, SharedServerMessage) {
+	protocol::SMSG_SERVER_MESSAGE message;
+	message->type = std::to_underlying(protocol::server::ServerMessage::Type::STRING);
+	message->message = "Hi";
+	const auto packet = make_shared_packet(message);
+
+	// type followed by the terminated string
+	const auto payload = payload_of(*packet);
+	ASSERT_EQ(payload, "\x03\x00\x00\x00Hi\x00"s);
+
+	const auto header = packet->header();
+	ASSERT_EQ(header[1], 0x09);
+	ASSERT_EQ(header[2], 0x91);
+	ASSERT_EQ(header[3], 0x02);
+}
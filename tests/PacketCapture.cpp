@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gateway/packetlog/CaptureRing.h>
+#include <gateway/packetlog/PacketCapture.h>
+#include <logger/Logger.h>
+#include <boost/endian/conversion.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Captured {
+	std::uint64_t timestamp;
+	std::uint8_t direction;
+	std::vector<std::uint8_t> payload;
+};
+
+std::vector<std::uint8_t> make_payload(const std::size_t size, const std::uint8_t seed) {
+	std::vector<std::uint8_t> payload(size);
+
+	for(std::size_t i = 0; i < size; ++i) {
+		payload[i] = static_cast<std::uint8_t>(seed + i);
+	}
+
+	return payload;
+}
+
+template<typename T>
+T read_le(std::span<const std::uint8_t>& data) {
+	T value;
+	std::memcpy(&value, data.data(), sizeof(value));
+	data = data.subspan(sizeof(value));
+	return boost::endian::little_to_native(value);
+}
+
+// parses a capture file using the framing described in PacketLog.fbs
+std::vector<Captured> parse(const std::filesystem::path& path, std::uint32_t& dropped,
+                            std::size_t& headers) {
+	std::ifstream file(path, std::ios::binary);
+	const std::vector<std::uint8_t> contents((std::istreambuf_iterator<char>(file)),
+	                                         std::istreambuf_iterator<char>());
+	std::span<const std::uint8_t> data(contents);
+	std::vector<Captured> packets;
+
+	while(!data.empty()) {
+		const auto size = read_le<std::uint32_t>(data);
+		const auto type = read_le<std::uint32_t>(data);
+		auto body = data.subspan(0, size);
+		data = data.subspan(size);
+
+		if(type == 0) { // header
+			++headers;
+			continue;
+		}
+
+		EXPECT_EQ(type, 2); // block
+		dropped += read_le<std::uint32_t>(body);
+
+		while(!body.empty()) {
+			Captured packet;
+			packet.timestamp = read_le<std::uint64_t>(body);
+			packet.direction = read_le<std::uint8_t>(body);
+			const auto length = read_le<std::uint32_t>(body);
+			packet.payload.assign(body.begin(), body.begin() + length);
+			body = body.subspan(length);
+			packets.emplace_back(std::move(packet));
+		}
+	}
+
+	return packets;
+}
+
+} // unnamed
+
+TEST(CaptureRing, Wraparound) {
+	CaptureRing ring(256);
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<std::size_t> dist(0, 60);
+	std::uint64_t pushed = 0, drained = 0;
+
+	for(int round = 0; round < 1000; ++round) {
+		const auto count = dist(rng) % 4 + 1;
+
+		for(std::size_t i = 0; i < count; ++i) {
+			const auto payload = make_payload(dist(rng), static_cast<std::uint8_t>(pushed));
+			const CaptureRing::Record record {
+				.file = reinterpret_cast<CaptureFile*>(1),
+				.timestamp = pushed,
+				.length = static_cast<std::uint32_t>(payload.size()),
+				.direction = PacketDirection::INBOUND
+			};
+
+			if(ring.push(record, payload)) {
+				++pushed;
+			}
+		}
+
+		ring.drain([&](const CaptureRing::Record& record, std::span<const std::uint8_t> payload) {
+			ASSERT_EQ(record.timestamp, drained);
+			const auto expected = make_payload(record.length, static_cast<std::uint8_t>(drained));
+			ASSERT_TRUE(std::ranges::equal(payload, expected));
+			++drained;
+		});
+	}
+
+	ASSERT_EQ(pushed, drained);
+	ASSERT_GT(pushed, 1000);
+}
+
+TEST(CaptureRing, Full) {
+	CaptureRing ring(256);
+	const auto payload = make_payload(100, 0);
+	const CaptureRing::Record record { .file = reinterpret_cast<CaptureFile*>(1) };
+
+	ASSERT_TRUE(ring.push(record, payload));
+	ASSERT_TRUE(ring.push(record, payload));
+	ASSERT_FALSE(ring.push(record, payload));
+
+	// larger than the ring can ever hold
+	ASSERT_FALSE(ring.push(record, make_payload(ring.capacity(), 0)));
+
+	ASSERT_EQ(ring.drain([](auto&&...) {}), 2);
+	ASSERT_TRUE(ring.push(record, payload));
+}
+
+TEST(PacketCapture, Write) {
+	constexpr std::size_t PACKETS = 5000;
+	const auto dir = std::filesystem::temp_directory_path() / "ember_capture_test";
+	std::filesystem::remove_all(dir);
+
+	log::Logger logger;
+
+	{
+		PacketCapture capture(dir.string(), 64 * 1024, 5ms, &logger);
+
+		// one thread per file, as with connections
+		auto producer = [&](const std::string& name, const std::uint8_t seed) {
+			auto file = capture.create(name, "gateway", "127.0.0.1");
+
+			for(std::size_t i = 0; i < PACKETS; ++i) {
+				const auto payload = make_payload(i % 200, static_cast<std::uint8_t>(seed + i));
+				const auto direction = i % 2? PacketDirection::OUTBOUND : PacketDirection::INBOUND;
+				const std::chrono::system_clock::time_point time(std::chrono::nanoseconds(i + 1));
+				capture.capture(*file, payload, time, direction);
+
+				// give the writer a chance to keep up
+				if(i % 100 == 0) {
+					std::this_thread::sleep_for(1ms);
+				}
+			}
+
+			capture.close(std::move(file));
+		};
+
+		std::jthread first(producer, "first", 0);
+		std::jthread second(producer, "second", 100);
+	}
+
+	for(const auto& [name, seed] : { std::pair("first", 0), std::pair("second", 100) }) {
+		std::uint32_t dropped = 0;
+		std::size_t headers = 0;
+		const auto packets = parse(dir / (std::string(name) + ".bin"), dropped, headers);
+
+		ASSERT_EQ(headers, 1);
+		ASSERT_EQ(packets.size() + dropped, PACKETS);
+
+		// packets are written in the order captured, with gaps for any that were dropped
+		std::uint64_t last = 0;
+
+		for(const auto& packet : packets) {
+			ASSERT_GT(packet.timestamp, last);
+			last = packet.timestamp;
+
+			const auto i = packet.timestamp - 1;
+			ASSERT_EQ(packet.direction, i % 2);
+			const auto expected = make_payload(i % 200, static_cast<std::uint8_t>(seed + i));
+			ASSERT_EQ(packet.payload, expected);
+		}
+	}
+
+	std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gateway/PacketCrypto.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+using namespace ember;
+
+namespace {
+
+// the original byte-at-a-time implementation, used as the reference
+class ReferenceCrypto {
+	std::vector<std::uint8_t> key_;
+	std::uint8_t send_i_ = 0;
+	std::uint8_t send_j_ = 0;
+	std::uint8_t recv_i_ = 0;
+	std::uint8_t recv_j_ = 0;
+
+public:
+	explicit ReferenceCrypto(std::span<const std::uint8_t> key)
+		: key_(key.begin(), key.end()) {}
+
+	void encrypt(std::span<std::uint8_t> data) {
+		const auto key_size = static_cast<std::uint8_t>(key_.size());
+
+		for(auto& byte : data) {
+			send_i_ %= key_size;
+			std::uint8_t x = (byte ^ key_[send_i_]) + send_j_;
+			++send_i_;
+			byte = send_j_ = x;
+		}
+	}
+
+	void decrypt(std::span<std::uint8_t> data) {
+		const auto key_size = static_cast<std::uint8_t>(key_.size());
+
+		for(auto& byte : data) {
+			recv_i_ %= key_size;
+			std::uint8_t x = (byte - recv_j_) ^ key_[recv_i_];
+			++recv_i_;
+			recv_j_ = byte;
+			byte = x;
+		}
+	}
+};
+
+std::vector<std::uint8_t> make_key(const std::size_t size) {
+	std::vector<std::uint8_t> key(size);
+	std::mt19937 rng(size);
+	std::uniform_int_distribution<unsigned int> dist(0, 255);
+	std::generate(key.begin(), key.end(), [&] { return static_cast<std::uint8_t>(dist(rng)); });
+	return key;
+}
+
+using Header = std::array<std::uint8_t, 4>;
+
+} // unnamed
+
+TEST(PacketCrypto, MatchesReferenceHeaders) {
+	const auto key = make_key(40);
+	PacketCrypto crypto(key);
+	ReferenceCrypto reference(key);
+
+	for(std::uint16_t i = 0; i < 1000; ++i) {
+		Header header { std::uint8_t(i >> 8), std::uint8_t(i), 0xAB, std::uint8_t(i * 7) };
+		Header expected = header;
+		crypto.encrypt(header);
+		reference.encrypt(expected);
+		ASSERT_EQ(header, expected);
+	}
+}
+
+TEST(PacketCrypto, MatchesReferenceLongRuns) {
+	// odd key size and runs longer than the key to exercise wrapping
+	const auto key = make_key(37);
+	PacketCrypto crypto(key);
+	ReferenceCrypto reference(key);
+
+	for(std::size_t len : { 1u, 3u, 36u, 37u, 38u, 74u, 200u }) {
+		std::vector<std::uint8_t> data(len);
+		std::iota(data.begin(), data.end(), std::uint8_t(len));
+		auto expected = data;
+		crypto.encrypt(data);
+		reference.encrypt(expected);
+		ASSERT_EQ(data, expected) << "Encrypt mismatch, length " << len;
+		crypto.decrypt(data);
+		reference.decrypt(expected);
+		ASSERT_EQ(data, expected) << "Decrypt mismatch, length " << len;
+	}
+}
+
+TEST(PacketCrypto, ObjectEncrypt) {
+	const auto key = make_key(40);
+	PacketCrypto crypto(key);
+	ReferenceCrypto reference(key);
+
+	std::uint16_t size = 0x1234;
+	std::uint16_t opcode = 0x00EE;
+	crypto.encrypt(size);
+	crypto.encrypt(opcode);
+
+	std::array<std::uint8_t, 4> expected;
+	std::uint16_t plain_size = 0x1234, plain_opcode = 0x00EE;
+	std::memcpy(expected.data(), &plain_size, sizeof(plain_size));
+	std::memcpy(expected.data() + 2, &plain_opcode, sizeof(plain_opcode));
+	reference.encrypt(expected);
+
+	std::array<std::uint8_t, 4> actual;
+	std::memcpy(actual.data(), &size, sizeof(size));
+	std::memcpy(actual.data() + 2, &opcode, sizeof(opcode));
+	ASSERT_EQ(actual, expected);
+}
+
+TEST(PacketCrypto, BatchEqualsSequential) {
+	const auto key = make_key(40);
+	PacketCrypto batch(key);
+	PacketCrypto sequential(key);
+
+	std::vector<Header> headers(513);
+
+	for(std::size_t i = 0; i < headers.size(); ++i) {
+		headers[i] = { std::uint8_t(i), std::uint8_t(i >> 8), 0x01, 0xFF };
+	}
+
+	auto expected = headers;
+
+	for(auto& header : expected) {
+		sequential.encrypt(header);
+	}
+
+	batch.encrypt(std::span(headers));
+	ASSERT_EQ(headers, expected);
+
+	// decrypting the batch should give back the original plaintext
+	PacketCrypto decryptor(key);
+	decryptor.decrypt(std::span(headers));
+
+	for(std::size_t i = 0; i < headers.size(); ++i) {
+		const Header plain { std::uint8_t(i), std::uint8_t(i >> 8), 0x01, 0xFF };
+		ASSERT_EQ(headers[i], plain);
+	}
+}
@@ -9,9 +9,12 @@
 #include <login/Patcher.h>
 #include <shared/database/daos/shared_base/PatchBase.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
 #include <numeric>
 #include <span>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 
 using namespace ember;
@@ -173,4 +176,45 @@ TEST(PatcherTest, RollupPatch) {
 
 	ASSERT_TRUE(patch);
 	ASSERT_EQ(patch->file_meta.name, "1_to_4.patch");
-}
\ No newline at end of file
+}
+
+TEST(PatcherTest, MappedData) {
+	std::vector<GameVersion> supported {
+		{ 0, 0, 0, 4 }
+	};
+
+	MockPatchDAO dao(false);
+	const auto meta = Patcher::load_patches("test_data/patches/", dao, nullptr);
+	Patcher patcher(supported, meta);
+
+	const auto patch = patcher.find_patch(
+		GameVersion{ 0, 0, 0, 1 }, grunt::Locale::enGB,
+		grunt::Platform::x86, grunt::System::Win
+	);
+
+	ASSERT_TRUE(patch);
+	const auto data = patcher.patch_data(*patch);
+	ASSERT_TRUE(data);
+	ASSERT_EQ(data->size(), patch->file_meta.size);
+
+	std::ifstream file("test_data/patches/" + patch->file_meta.name, std::ios::binary);
+	std::vector<std::byte> expected(patch->file_meta.size);
+	file.read(reinterpret_cast<char*>(expected.data()), expected.size());
+	ASSERT_TRUE(std::ranges::equal(*data, expected));
+
+	// subsequent requests should share the same mapping
+	const auto again = patcher.patch_data(*patch);
+	ASSERT_TRUE(again);
+	ASSERT_EQ(again->data(), data->data());
+
+	// size no longer matches the file on disk
+	auto stale = *patch;
+	stale.id = 100;
+	stale.file_meta.size += 1;
+	ASSERT_FALSE(patcher.patch_data(stale));
+
+	auto missing = *patch;
+	missing.id = 101;
+	missing.file_meta.name = "missing.patch";
+	ASSERT_FALSE(patcher.patch_data(missing));
+}
@@ -6,9 +6,15 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
-#include <array>
 #include <login/RealmList.h>
+#include <login/grunt/server/RealmList.h>
+#include <spark/buffers/pmr/BinaryStream.h>
+#include <spark/buffers/pmr/BufferAdaptor.h>
 #include <gtest/gtest.h>
+#include <array>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
 
 using namespace ember;
 
@@ -88,4 +94,97 @@ TEST(RealmList, GetInvalidRealm) {
 	list.add_realm({ .id = 0, .name = "Test Realm #1" });
 	auto realm = list.get_realm(1);
 	ASSERT_EQ(realm.has_value(), false);
-}
\ No newline at end of file
+}
+
+namespace {
+
+std::vector<std::uint8_t> write(const grunt::Packet& packet) {
+	std::vector<std::uint8_t> buffer;
+	spark::io::pmr::BufferAdaptor adaptor(buffer);
+	spark::io::pmr::BinaryStream stream(adaptor);
+	packet.write_to_stream(stream);
+	return buffer;
+}
+
+std::vector<std::uint8_t> write_prepared(const EncodedRealmList& encoded,
+                                         const std::unordered_map<std::uint32_t, std::uint32_t>& counts) {
+	grunt::server::PreparedRealmList packet(encoded.packet);
+
+	for(const auto& [realm_id, offset] : encoded.slots) {
+		if(auto it = counts.find(realm_id); it != counts.end()) {
+			packet.characters.emplace_back(offset, static_cast<std::uint8_t>(it->second));
+		}
+	}
+
+	return write(packet);
+}
+
+const auto REGION_A = static_cast<dbc::Cfg_Categories::Region>(1);
+const auto REGION_B = static_cast<dbc::Cfg_Categories::Region>(2);
+
+const std::array<Realm, 3> test_realms {{
+	{ .id = 1, .name = "Zenedar", .address = "127.0.0.1:8085", .population = 1.0f,
+	  .type = Realm::Type::PvP, .flags = Realm::Flags::NONE, .region = REGION_A },
+	{ .id = 2, .name = "Tarren Mill", .address = "10.0.0.1:8085", .population = 0.5f,
+	  .type = Realm::Type::PvE, .flags = Realm::Flags::RECOMMENDED, .region = REGION_B },
+	{ .id = 3, .name = "Quel'Thalas", .address = "realm.example.com:8086", .population = 2.0f,
+	  .type = Realm::Type::RP, .flags = Realm::Flags::OFFLINE, .region = REGION_A },
+}};
+
+} // unnamed
+
+TEST(RealmList, EncodedMatchesPacket) {
+	RealmList list(test_realms);
+	const std::unordered_map<std::uint32_t, std::uint32_t> counts { { 1, 3 }, { 3, 10 } };
+
+	grunt::server::RealmList packet;
+
+	for(const auto& [id, realm] : *list.realms()) {
+		auto it = counts.find(id);
+		packet.realms.emplace_back(realm, it == counts.end()? 0 : it->second);
+	}
+
+	const auto encoded = list.encoded(std::nullopt);
+	ASSERT_EQ(encoded->slots.size(), test_realms.size());
+	ASSERT_EQ(write_prepared(*encoded, counts), write(packet));
+}
+
+TEST(RealmList, EncodedRegions) {
+	RealmList list(test_realms);
+
+	const auto region_a = list.encoded(REGION_A);
+	ASSERT_EQ(region_a->slots.size(), 2);
+
+	for(const auto& slot : region_a->slots) {
+		ASSERT_NE(slot.realm_id, 2);
+	}
+
+	const auto region_b = list.encoded(REGION_B);
+	ASSERT_EQ(region_b->slots.size(), 1);
+	ASSERT_EQ(region_b->slots[0].realm_id, 2);
+
+	// no realms in this region, should still be a valid (empty) list
+	const auto empty = list.encoded(static_cast<dbc::Cfg_Categories::Region>(3));
+	ASSERT_TRUE(empty->slots.empty());
+	ASSERT_EQ(write_prepared(*empty, {}), write(grunt::server::RealmList{}));
+}
+
+TEST(RealmList, EncodedUpdate) {
+	RealmList list(test_realms);
+	const auto version = list.version();
+	const auto before = list.encoded(REGION_B);
+
+	auto realm = test_realms[1];
+	realm.name = "Tarren Mill (Offline)";
+	realm.flags = Realm::Flags::OFFLINE;
+	list.add_realm(realm);
+
+	ASSERT_GT(list.version(), version);
+
+	const auto after = list.encoded(REGION_B);
+	ASSERT_NE(before->packet, after->packet);
+
+	grunt::server::RealmList packet;
+	packet.realms.emplace_back(realm, 0);
+	ASSERT_EQ(write_prepared(*after, {}), write(packet));
+}
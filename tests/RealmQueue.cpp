@@ -6,11 +6,206 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
-
 #include <gateway/RealmQueue.h>
+#include <shared/util/xoroshiro128plus.h>
 #include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
 
 using namespace ember;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<ClientUUID> make_clients(const std::size_t count) {
+	rng::xorshift::seed[0] = 0x9E3779B97F4A7C15;
+	rng::xorshift::seed[1] = 0xBF58476D1CE4E5B9;
+
+	std::vector<ClientUUID> clients;
+
+	for(std::size_t i = 0; i < count; ++i) {
+		clients.emplace_back(ClientUUID::generate(0));
+	}
+
+	return clients;
+}
+
+struct Recorder {
+	std::vector<RealmQueue::Positions> updates;
+	std::vector<ClientUUID> left;
+
+	RealmQueue::UpdateQueueCB update_cb() {
+		return [this](RealmQueue::Positions positions) {
+			updates.emplace_back(std::move(positions));
+		};
+	}
+
+	RealmQueue::LeaveQueueCB leave_cb() {
+		return [this](const ClientUUID& client) {
+			left.emplace_back(client);
+		};
+	}
+};
+
+// runs until the queue has had a chance to send out a round of updates
+void tick(boost::asio::io_context& service) {
+	service.restart();
+	service.run_one_for(1s);
+}
+
+} // unnamed
+
+TEST(RealmQueue, Empty) {
+	boost::asio::io_context service;
+	Recorder recorder;
+	RealmQueue queue(service, recorder.update_cb(), recorder.leave_cb(), 1ms);
+	queue.free_slot();
+	ASSERT_EQ(queue.size(), 0);
+	ASSERT_TRUE(recorder.left.empty());
+}
+
+TEST(RealmQueue, PriorityOrder) {
+	boost::asio::io_context service;
+	Recorder recorder;
+	RealmQueue queue(service, recorder.update_cb(), recorder.leave_cb(), 1ms);
+	const auto clients = make_clients(5);
+
+	queue.enqueue(clients[0]);
+	queue.enqueue(clients[1], 5);
+	queue.enqueue(clients[2]);
+	queue.enqueue(clients[3], 5);
+	queue.enqueue(clients[4], -1);
+	queue.enqueue(clients[0], 10); // duplicate, ignored
+	ASSERT_EQ(queue.size(), 5);
+
+	for(std::size_t i = 0; i < clients.size(); ++i) {
+		queue.free_slot();
+	}
+
+	const std::vector expected { clients[1], clients[3], clients[0], clients[2], clients[4] };
+	ASSERT_EQ(recorder.left, expected);
+	ASSERT_EQ(queue.size(), 0);
+}
+
+TEST(RealmQueue, Dequeue) {
+	boost::asio::io_context service;
+	Recorder recorder;
+	RealmQueue queue(service, recorder.update_cb(), recorder.leave_cb(), 1ms);
+	const auto clients = make_clients(3);
+
+	for(const auto& client : clients) {
+		queue.enqueue(client);
+	}
+
+	queue.dequeue(clients[1]);
+	queue.dequeue(clients[1]); // no longer queued, ignored
+	ASSERT_EQ(queue.size(), 2);
+
+	queue.free_slot();
+	queue.free_slot();
+	queue.free_slot();
+
+	const std::vector expected { clients[0], clients[2] };
+	ASSERT_EQ(recorder.left, expected);
+}
+
+TEST(RealmQueue, ChangedPositionsOnly) {
+	boost::asio::io_context service;
+	Recorder recorder;
+	RealmQueue queue(service, recorder.update_cb(), recorder.leave_cb(), 1ms);
+	const auto clients = make_clients(4);
+
+	for(const auto& client : clients) {
+		queue.enqueue(client);
+	}
+
+	tick(service);
+	ASSERT_EQ(recorder.updates.size(), 1);
+	ASSERT_EQ(recorder.updates[0].size(), 4);
+
+	for(std::size_t i = 0; i < clients.size(); ++i) {
+		ASSERT_EQ(recorder.updates[0][i].first, clients[i]);
+		ASSERT_EQ(recorder.updates[0][i].second, i + 1);
+	}
+
+	// nothing changed, no update
+	tick(service);
+	ASSERT_EQ(recorder.updates.size(), 1);
+
+	// removing the third client should only move the fourth
+	queue.dequeue(clients[2]);
+	tick(service);
+	ASSERT_EQ(recorder.updates.size(), 2);
+	ASSERT_EQ(recorder.updates[1].size(), 1);
+	ASSERT_EQ(recorder.updates[1][0].first, clients[3]);
+	ASSERT_EQ(recorder.updates[1][0].second, 3);
+}
+
+// every client should always end up knowing its true position, however the queue changes
+TEST(RealmQueue, PositionsStayCorrect) {
+	boost::asio::io_context service;
+	Recorder recorder;
+	RealmQueue queue(service, recorder.update_cb(), recorder.leave_cb(), 1ms);
+	const auto clients = make_clients(200);
+
+	std::map<int, std::vector<ClientUUID>, std::greater<int>> expected;
+	std::unordered_map<ClientUUID, std::size_t, boost::hash<ClientUUID>> known;
+	std::mt19937 rng(7);
+	std::size_t next_client = 0;
+
+	for(int round = 0; round < 200; ++round) {
+		for(int op = 0; op < 8; ++op) {
+			const auto action = rng() % 3;
+
+			if(action == 0 && next_client < clients.size()) {
+				const int priority = rng() % 3;
+				queue.enqueue(clients[next_client], priority);
+				expected[priority].emplace_back(clients[next_client]);
+				++next_client;
+			} else if(action == 1 && !expected.empty()) {
+				auto level = std::next(expected.begin(), rng() % expected.size());
+				auto entry = level->second.begin() + rng() % level->second.size();
+				queue.dequeue(*entry);
+				known.erase(*entry);
+				level->second.erase(entry);
+
+				if(level->second.empty()) {
+					expected.erase(level);
+				}
+			} else if(!expected.empty()) {
+				queue.free_slot();
+				auto& level = expected.begin()->second;
+				known.erase(level.front());
+				level.erase(level.begin());
+
+				if(level.empty()) {
+					expected.erase(expected.begin());
+				}
+			}
+		}
+
+		tick(service);
+
+		if(!recorder.updates.empty()) {
+			for(const auto& [client, position] : recorder.updates.back()) {
+				known[client] = position;
+			}
+
+			recorder.updates.clear();
+		}
+
+		std::size_t position = 1;
 
-TEST(RealmQueue, ZeroRealms) {
+		for(const auto& [_, level] : expected) {
+			for(const auto& client : level) {
+				ASSERT_EQ(known[client], position);
+				++position;
+			}
+		}
+	}
 }
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/threading/Placement.h>
+#include <shared/threading/ServicePool.h>
+#include <boost/asio/post.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+using namespace ember;
+
+TEST(ServicePlacement, RoundRobin) {
+	auto loads = std::make_unique<ServiceLoad[]>(3);
+	std::span<const ServiceLoad> view(loads.get(), 3);
+	RoundRobinPlacement policy;
+
+	// load is ignored entirely
+	loads[0].connections = 100;
+
+	for(std::size_t i = 0; i < 9; ++i) {
+		ASSERT_EQ(policy.select(view), i % 3);
+	}
+}
+
+TEST(ServicePlacement, LeastLoaded_Connections) {
+	auto loads = std::make_unique<ServiceLoad[]>(4);
+	std::span<const ServiceLoad> view(loads.get(), 4);
+	LeastLoadedPlacement policy;
+
+	loads[0].connections = 10;
+	loads[1].connections = 12;
+	loads[2].connections = 3;
+	loads[3].connections = 7;
+	ASSERT_EQ(policy.select(view), 2);
+
+	loads[2].connections = 20;
+	ASSERT_EQ(policy.select(view), 3);
+}
+
+TEST(ServicePlacement, LeastLoaded_TrafficAndLatency) {
+	auto loads = std::make_unique<ServiceLoad[]>(3);
+	std::span<const ServiceLoad> view(loads.get(), 3);
+	LeastLoadedPlacement policy;
+
+	for(std::size_t i = 0; i < 3; ++i) {
+		loads[i].connections = 10;
+	}
+
+	loads[0].recent_messages = 5000;
+	loads[1].queue_latency = 20'000; // 20ms
+	ASSERT_EQ(policy.select(view), 2);
+
+	loads[2].recent_bytes = 64 * 1024 * 1024;
+	ASSERT_EQ(policy.select(view), 1);
+}
+
+TEST(ServicePlacement, LeastLoaded_Weights) {
+	auto loads = std::make_unique<ServiceLoad[]>(2);
+	std::span<const ServiceLoad> view(loads.get(), 2);
+
+	// only connections count, so the busy but emptier context wins
+	LeastLoadedPlacement policy({ .connection = 1.0, .message = 0.0, .kilobyte = 0.0, .latency_ms = 0.0 });
+	loads[0].connections = 5;
+	loads[0].recent_messages = 1'000'000;
+	loads[1].connections = 6;
+	ASSERT_EQ(policy.select(view), 0);
+}
+
+TEST(ServicePlacement, LeastLoaded_TiesSpread) {
+	auto loads = std::make_unique<ServiceLoad[]>(4);
+	std::span<const ServiceLoad> view(loads.get(), 4);
+	LeastLoadedPlacement policy;
+	std::vector<std::size_t> selected;
+
+	for(std::size_t i = 0; i < 4; ++i) {
+		selected.emplace_back(policy.select(view));
+	}
+
+	std::ranges::sort(selected);
+	ASSERT_EQ(selected, std::vector<std::size_t>({ 0, 1, 2, 3 }));
+}
+
+TEST(ServicePlacement, Pool_DefaultRoundRobin) {
+	ServicePool pool(3);
+
+	for(std::size_t i = 0; i < 6; ++i) {
+		ASSERT_EQ(pool.next(), i % 3);
+	}
+
+	ASSERT_EQ(&pool.get(), &pool.get(0));
+	ASSERT_EQ(&pool.get(), &pool.get(1));
+}
+
+TEST(ServicePlacement, Pool_SetPolicy) {
+	ServicePool pool(3);
+	pool.placement(std::make_unique<LeastLoadedPlacement>());
+	pool.load(0).connections = 4;
+	pool.load(1).connections = 1;
+	pool.load(2).connections = 2;
+	ASSERT_EQ(pool.next(), 1);
+	ASSERT_EQ(&pool.get(), &pool.get(1));
+	ASSERT_THROW(pool.placement(nullptr), std::invalid_argument);
+	ASSERT_THROW(pool.load(3), std::out_of_range);
+}
+
+TEST(ServicePlacement, Pool_SamplesTraffic) {
+	ServicePool pool(1);
+	pool.run();
+
+	// traffic totals must be written from the context's own thread
+	boost::asio::post(pool.get(0), [&] {
+		pool.load(0).record_traffic(4096, 8);
+	});
+
+	const auto& load = pool.loads()[0];
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+	while(!load.recent_messages && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	ASSERT_EQ(load.recent_messages.load(), 8);
+	ASSERT_EQ(load.recent_bytes.load(), 4096);
+	pool.stop();
+}
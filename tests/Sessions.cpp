@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <account/Sessions.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+namespace {
+
+Sessions::Key make_key(std::uint32_t seed) {
+	Sessions::Key key {};
+
+	for(std::size_t i = 0; i < key.size(); ++i) {
+		key[i] = static_cast<std::uint8_t>(seed * 31 + i);
+	}
+
+	return key;
+}
+
+} // unnamed
+
+TEST(Sessions, RegisterLookup) {
+	Sessions sessions(true, 1h);
+	ASSERT_FALSE(sessions.lookup_session(1));
+
+	const auto key = make_key(1);
+	ASSERT_TRUE(sessions.register_session(1, key));
+
+	const auto session = sessions.lookup_session(1);
+	ASSERT_TRUE(session);
+	ASSERT_EQ(*session, key);
+	ASSERT_FALSE(sessions.lookup_session(2));
+
+	// account ID 0 is reserved
+	ASSERT_FALSE(sessions.register_session(0, key));
+}
+
+TEST(Sessions, ShortKeyIsPadded) {
+	Sessions sessions(true, 1h);
+	const std::array<std::uint8_t, 3> key { 0x01, 0x02, 0x03 };
+	ASSERT_TRUE(sessions.register_session(1, key));
+
+	Sessions::Key expected {};
+	expected[Sessions::KEY_SIZE - 3] = 0x01;
+	expected[Sessions::KEY_SIZE - 2] = 0x02;
+	expected[Sessions::KEY_SIZE - 1] = 0x03;
+	ASSERT_EQ(*sessions.lookup_session(1), expected);
+
+	const std::vector<std::uint8_t> oversized(Sessions::KEY_SIZE + 1, 0xff);
+	ASSERT_FALSE(sessions.register_session(2, oversized));
+}
+
+TEST(Sessions, Overwrite) {
+	Sessions overwrite(true, 1h);
+	ASSERT_TRUE(overwrite.register_session(1, make_key(1)));
+	ASSERT_TRUE(overwrite.register_session(1, make_key(2)));
+	ASSERT_EQ(*overwrite.lookup_session(1), make_key(2));
+	ASSERT_EQ(overwrite.size(), 1);
+
+	Sessions no_overwrite(false, 1h);
+	ASSERT_TRUE(no_overwrite.register_session(1, make_key(1)));
+	ASSERT_FALSE(no_overwrite.register_session(1, make_key(2)));
+	ASSERT_EQ(*no_overwrite.lookup_session(1), make_key(1));
+
+	// expired sessions can always be replaced
+	Sessions expired(false, 0s);
+	ASSERT_TRUE(expired.register_session(1, make_key(1)));
+	ASSERT_TRUE(expired.register_session(1, make_key(2)));
+}
+
+TEST(Sessions, ExpiryAndSweep) {
+	Sessions sessions(true, 0s);
+
+	for(std::uint32_t i = 1; i <= 1000; ++i) {
+		ASSERT_TRUE(sessions.register_session(i, make_key(i)));
+	}
+
+	ASSERT_FALSE(sessions.lookup_session(1));
+	ASSERT_EQ(sessions.size(), 1000);
+	ASSERT_EQ(sessions.sweep(), 1000);
+	ASSERT_EQ(sessions.size(), 0);
+}
+
+TEST(Sessions, ManyAccounts) {
+	Sessions sessions(true, 1h);
+
+	for(std::uint32_t i = 1; i <= 20000; ++i) {
+		ASSERT_TRUE(sessions.register_session(i * 7919, make_key(i)));
+	}
+
+	ASSERT_EQ(sessions.size(), 20000);
+	ASSERT_EQ(sessions.sweep(), 0);
+
+	for(std::uint32_t i = 1; i <= 20000; ++i) {
+		const auto session = sessions.lookup_session(i * 7919);
+		ASSERT_TRUE(session);
+		ASSERT_EQ(*session, make_key(i));
+	}
+
+	ASSERT_FALSE(sessions.lookup_session(7918));
+}
+
+// exercises backward shift deletion with a mix of live and expired sessions
+TEST(Sessions, PartialSweep) {
+	Sessions mixed(true, 1h);
+
+	for(std::uint32_t i = 1; i <= 5000; ++i) {
+		ASSERT_TRUE(mixed.register_session(i, make_key(i)));
+	}
+
+	const auto path = std::filesystem::temp_directory_path() / "ember_sessions_partial.snapshot";
+	mixed.save(path.string());
+
+	Sessions restored(true, 0s);
+	ASSERT_EQ(restored.load(path.string()), 5000);
+
+	for(std::uint32_t i = 1; i <= 5000; i += 3) {
+		ASSERT_TRUE(restored.register_session(i, make_key(i))); // expires immediately
+	}
+
+	ASSERT_EQ(restored.sweep(), 1667);
+
+	for(std::uint32_t i = 1; i <= 5000; ++i) {
+		const auto session = restored.lookup_session(i);
+
+		if(i % 3 == 1) {
+			ASSERT_FALSE(session);
+		} else {
+			ASSERT_TRUE(session);
+			ASSERT_EQ(*session, make_key(i));
+		}
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST(Sessions, Snapshot) {
+	const auto path = std::filesystem::temp_directory_path() / "ember_sessions.snapshot";
+
+	{
+		Sessions sessions(true, 1h);
+		ASSERT_TRUE(sessions.register_session(1, make_key(1)));
+		ASSERT_TRUE(sessions.register_session(2, make_key(2)));
+		sessions.save(path.string());
+	}
+
+	Sessions restored(true, 1h);
+	ASSERT_EQ(restored.load(path.string()), 2);
+	ASSERT_EQ(*restored.lookup_session(1), make_key(1));
+	ASSERT_EQ(*restored.lookup_session(2), make_key(2));
+
+	// expired sessions aren't written
+	{
+		Sessions sessions(true, 0s);
+		ASSERT_TRUE(sessions.register_session(1, make_key(1)));
+		sessions.save(path.string());
+	}
+
+	ASSERT_EQ(Sessions(true, 1h).load(path.string()), 0);
+
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) + 1);
+	ASSERT_THROW(Sessions(true, 1h).load(path.string()), std::runtime_error);
+
+	std::ofstream(path, std::ios::trunc) << "garbage data";
+	ASSERT_THROW(Sessions(true, 1h).load(path.string()), std::runtime_error);
+
+	std::filesystem::remove(path);
+	ASSERT_THROW(Sessions(true, 1h).load(path.string()), std::runtime_error);
+}
+
+TEST(Sessions, Concurrency) {
+	Sessions sessions(true, 1h);
+	std::vector<std::jthread> threads;
+
+	for(std::uint32_t t = 0; t < 4; ++t) {
+		threads.emplace_back([&, t] {
+			for(std::uint32_t i = 1; i <= 5000; ++i) {
+				const auto id = i * 4 + t;
+				sessions.register_session(id, make_key(id));
+				sessions.lookup_session(id);
+			}
+		});
+	}
+
+	threads.clear();
+	ASSERT_EQ(sessions.size(), 20000);
+	ASSERT_EQ(*sessions.lookup_session(4 * 2500 + 3), make_key(4 * 2500 + 3));
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <spark/v2/Tracking.h>
+#include <logger/Logger.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+class SparkTracking : public ::testing::Test {
+public:
+	virtual void SetUp() override {
+		logger = std::make_unique<log::Logger>();
+	}
+
+	std::unique_ptr<log::Logger> logger;
+	boost::asio::io_context ctx;
+	boost::uuids::random_generator uuid_gen;
+};
+
+TEST_F(SparkTracking, Complete) {
+	spark::v2::Tracking tracking(ctx, logger.get());
+	const auto token = uuid_gen();
+	int calls = 0;
+	bool success = false;
+
+	tracking.track(token, [&](const spark::v2::Link&, spark::v2::MessageResult result) {
+		++calls;
+		success = result.has_value();
+	}, 1s);
+
+	ASSERT_EQ(tracking.metrics().outstanding, 1);
+
+	const spark::v2::Link link;
+	tracking.on_message(link, {}, token);
+	tracking.on_message(link, {}, token); // already completed, ignored
+
+	const auto metrics = tracking.metrics();
+	ASSERT_EQ(calls, 1);
+	ASSERT_TRUE(success);
+	ASSERT_EQ(metrics.outstanding, 0);
+	ASSERT_EQ(metrics.completed, 1);
+	ASSERT_EQ(std::accumulate(metrics.latency.begin(), metrics.latency.end(), 0ull), 1);
+
+	// nothing left to time out
+	ctx.run_for(20ms);
+	ASSERT_EQ(calls, 1);
+	ASSERT_EQ(tracking.metrics().timed_out, 0);
+}
+
+TEST_F(SparkTracking, TimeoutOrder) {
+	spark::v2::Tracking tracking(ctx, logger.get());
+	std::vector<int> timed_out;
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<std::chrono::steady_clock::duration> elapsed;
+
+	auto record = [&](const int id) {
+		return [&, id](const spark::v2::Link&, spark::v2::MessageResult result) {
+			if(!result && result.error() == spark::v2::Result::TIMED_OUT) {
+				timed_out.emplace_back(id);
+				elapsed.emplace_back(std::chrono::steady_clock::now() - start);
+			}
+		};
+	};
+
+	// the sooner deadlines are added later, so the timer has to be re-armed
+	tracking.track(uuid_gen(), record(3), 30ms);
+	tracking.track(uuid_gen(), record(2), 20ms);
+	tracking.track(uuid_gen(), record(1), 10ms);
+
+	ctx.run_for(100ms);
+
+	const std::vector expected { 1, 2, 3 };
+	ASSERT_EQ(timed_out, expected);
+	ASSERT_GE(elapsed[0], 10ms);
+	ASSERT_GE(elapsed[1], 20ms);
+	ASSERT_GE(elapsed[2], 30ms);
+
+	const auto metrics = tracking.metrics();
+	ASSERT_EQ(metrics.outstanding, 0);
+	ASSERT_EQ(metrics.timed_out, 3);
+	ASSERT_EQ(metrics.completed, 0);
+}
+
+TEST_F(SparkTracking, CompleteBeforeDeadline) {
+	spark::v2::Tracking tracking(ctx, logger.get());
+	const auto first = uuid_gen();
+	const auto second = uuid_gen();
+	std::vector<spark::v2::Token> timed_out;
+
+	auto record = [&](const spark::v2::Token& token) {
+		return [&, token](const spark::v2::Link&, spark::v2::MessageResult result) {
+			if(!result) {
+				timed_out.emplace_back(token);
+			}
+		};
+	};
+
+	tracking.track(first, record(first), 10ms);
+	tracking.track(second, record(second), 20ms);
+
+	// the stale deadline for the first request must not affect the second
+	tracking.on_message({}, {}, first);
+	ctx.run_for(50ms);
+
+	ASSERT_EQ(timed_out.size(), 1);
+	ASSERT_EQ(timed_out[0], second);
+}
+
+TEST_F(SparkTracking, Shutdown) {
+	spark::v2::Tracking tracking(ctx, logger.get());
+	int cancelled = 0;
+
+	for(int i = 0; i < 3; ++i) {
+		tracking.track(uuid_gen(), [&](const spark::v2::Link&, spark::v2::MessageResult result) {
+			if(!result && result.error() == spark::v2::Result::CANCELLED) {
+				++cancelled;
+			}
+		}, 1h);
+	}
+
+	tracking.shutdown();
+	tracking.shutdown(); // requests should only be cancelled once
+
+	ASSERT_EQ(cancelled, 3);
+	ASSERT_EQ(tracking.metrics().cancelled, 3);
+	ASSERT_EQ(tracking.metrics().outstanding, 0);
+}
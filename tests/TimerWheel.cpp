@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/threading/TimerWheel.h>
+#include <boost/asio/io_context.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+TEST(TimerWheel, ExpiryOrder) {
+	boost::asio::io_context ctx;
+	TimerWheel wheel(ctx, 1ms);
+	std::vector<int> fired;
+
+	const auto start = TimerWheel::Clock::now();
+	std::vector<TimerWheel::Clock::duration> elapsed;
+
+	auto record = [&](const int id) {
+		return [&, id] {
+			fired.emplace_back(id);
+			elapsed.emplace_back(TimerWheel::Clock::now() - start);
+		};
+	};
+
+	wheel.schedule(30ms, record(3));
+	wheel.schedule(10ms, record(1));
+	wheel.schedule(20ms, record(2));
+	ASSERT_EQ(wheel.size(), 3);
+
+	ctx.run_for(100ms);
+
+	const std::vector expected { 1, 2, 3 };
+	ASSERT_EQ(fired, expected);
+	ASSERT_EQ(wheel.size(), 0);
+
+	// timers should never fire early
+	ASSERT_GE(elapsed[0], 10ms);
+	ASSERT_GE(elapsed[1], 20ms);
+	ASSERT_GE(elapsed[2], 30ms);
+}
+
+TEST(TimerWheel, Cancel) {
+	boost::asio::io_context ctx;
+	TimerWheel wheel(ctx, 1ms);
+	bool fired = false;
+
+	const auto id = wheel.schedule(10ms, [&] { fired = true; });
+	ASSERT_TRUE(wheel.cancel(id));
+	ASSERT_FALSE(wheel.cancel(id));
+	ASSERT_FALSE(wheel.cancel(TimerWheel::INVALID_TIMER));
+	ASSERT_EQ(wheel.size(), 0);
+
+	ctx.run_for(30ms);
+	ASSERT_FALSE(fired);
+}
+
+TEST(TimerWheel, CancelFromCallback) {
+	boost::asio::io_context ctx;
+	TimerWheel wheel(ctx, 5ms);
+	int fired = 0;
+
+	// both land in the same tick, whichever fires first cancels the other
+	TimerWheel::TimerID first = 0, second = 0;
+	first = wheel.schedule(10ms, [&] { ++fired; wheel.cancel(second); });
+	second = wheel.schedule(10ms, [&] { ++fired; wheel.cancel(first); });
+
+	ctx.run_for(50ms);
+	ASSERT_EQ(fired, 1);
+	ASSERT_EQ(wheel.size(), 0);
+}
+
+TEST(TimerWheel, StaleID) {
+	boost::asio::io_context ctx;
+	TimerWheel wheel(ctx, 1ms);
+
+	const auto id = wheel.schedule(1ms, [] {});
+	ctx.run_for(20ms);
+
+	// the node will be reused but the old ID must not cancel the new timer
+	bool fired = false;
+	wheel.schedule(5ms, [&] { fired = true; });
+	ASSERT_FALSE(wheel.cancel(id));
+
+	ctx.restart();
+	ctx.run_for(30ms);
+	ASSERT_TRUE(fired);
+}
+
+TEST(TimerWheel, Cascade) {
+	boost::asio::io_context ctx;
+	TimerWheel wheel(ctx, 1ms);
+	std::vector<int> fired;
+
+	// beyond the range of the first level, so these have to cascade down
+	wheel.schedule(150ms, [&] { fired.emplace_back(2); });
+	wheel.schedule(70ms, [&] { fired.emplace_back(1); });
+	wheel.schedule(5ms, [&] { fired.emplace_back(0); });
+
+	ctx.run_for(300ms);
+
+	const std::vector expected { 0, 1, 2 };
+	ASSERT_EQ(fired, expected);
+}
+
+TEST(TimerWheel, Randomised) {
+	constexpr std::size_t TIMERS = 2000;
+	boost::asio::io_context ctx;
+	TimerWheel wheel(ctx, 1ms);
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<int> dist(0, 250);
+	std::size_t fired = 0, early = 0;
+
+	const auto start = TimerWheel::Clock::now();
+
+	for(std::size_t i = 0; i < TIMERS; ++i) {
+		const auto delay = std::chrono::milliseconds(dist(rng));
+
+		wheel.schedule(delay, [&, delay] {
+			++fired;
+
+			if(TimerWheel::Clock::now() - start < delay) {
+				++early;
+			}
+		});
+	}
+
+	ctx.run_for(500ms);
+	ASSERT_EQ(fired, TIMERS);
+	ASSERT_EQ(early, 0);
+}
+
+TEST(TimerWheel, Shutdown) {
+	auto ctx = std::make_unique<boost::asio::io_context>();
+	auto& wheel = TimerWheel::get(*ctx);
+	ASSERT_EQ(&wheel, &TimerWheel::get(*ctx));
+
+	auto tracker = std::make_shared<int>();
+	wheel.schedule(1h, [tracker] {});
+	ASSERT_EQ(tracker.use_count(), 2);
+
+	// pending callbacks should be released without being invoked
+	ctx.reset();
+	ASSERT_EQ(tracker.use_count(), 1);
+}
@@ -50,7 +50,7 @@ TEST(TextUtilities, StringLength_UTF8) {
 	EXPECT_EQ(len, 0);
 }
 
-TEST(TextUtilities, DISABLED_NameFormat_ASCII) {
+TEST(TextUtilities, NameFormat_ASCII) {
 	// Lower
 	std::string str = "bankalt";
 	auto formatted = util::utf8::name_format(str, std::locale());
@@ -373,7 +373,7 @@ TEST(TextUtilities, ConsecutiveCheck_ASCII_CaseSensitive) {
 	EXPECT_EQ(res, 4);
 }
 
-TEST(TextUtilities, DISABLED_ConsecutiveCheck_UTF8_CaseInsensitive) {
+TEST(TextUtilities, ConsecutiveCheck_UTF8_CaseInsensitive) {
 	std::string text = "";
 	auto res = util::utf8::max_consecutive(text, true);
 	EXPECT_EQ(res, 0);
@@ -407,4 +407,36 @@ TEST(TextUtilities, ConsecutiveCheck_UTF8_CaseSensitive) {
 	text = "テテキスススト";
 	res = util::utf8::max_consecutive(text);
 	EXPECT_EQ(res, 3);
-}
\ No newline at end of file
+}
+
+TEST(TextUtilities, InspectName_MatchesIndividualChecks) {
+	const std::string names[] {
+		"", "bankalt", "CHAOSVEX", "cHaoSvEx", "Fffoo", "Abc1", "テテキスト", "ŏϭեۛåȆ", "a\xc3\x28", "\xed\xa0\x80"
+	};
+
+	for(const auto& name : names) {
+		const auto info = util::utf8::inspect_name(name, std::locale());
+		ASSERT_EQ(info.valid, util::utf8::is_valid(name));
+
+		if(!info.valid) {
+			continue;
+		}
+
+		EXPECT_EQ(info.length, util::utf8::length(name));
+		EXPECT_EQ(info.max_consecutive, util::utf8::max_consecutive(name, true));
+		EXPECT_EQ(info.alpha, util::utf8::is_alpha(name, std::locale()));
+		EXPECT_EQ(info.formatted, util::utf8::name_format(name, std::locale()));
+	}
+}
+
+TEST(TextUtilities, InspectName_ASCII) {
+	const auto info = util::utf8::inspect_name("cHaoSvEXX", std::locale());
+	EXPECT_TRUE(info.valid);
+	EXPECT_TRUE(info.alpha);
+	EXPECT_EQ(info.length, 9);
+	EXPECT_EQ(info.max_consecutive, 2);
+	EXPECT_EQ(info.formatted, "Chaosvexx");
+
+	EXPECT_FALSE(util::utf8::inspect_name("Chaos1", std::locale()).alpha);
+	EXPECT_FALSE(util::utf8::inspect_name("Cha\xff", std::locale()).valid);
+}